@@ -24,12 +24,30 @@
 #include <Bounce2.h>
 #include <Encoder.h>
 
+// #define LOG_MIN_SEVERITY INFO // removes the DEBUG messages of the sketch at compile time
 #include "Logger.h"
+#include "F3XLogFormats.h"
 #include "PinManager.h"
+#include "F3XEventRing.h"
+#include "LatencyHistogram.h"
+#include "F3XSequenceFilter.h"
+#include "F3XClockSync.h"
+#include "F3XChannelSurvey.h"
+#include "F3XEventSource.h"
+#include "F3XWebFileStreamer.h"
+#include "F3XWebAssetIndex.h"
+#include "F3XTaskStateTracker.h"
+#include "F3XPerfProbes.h"
+#include "F3XScheduler.h"
 #include "LittleFS.h"
 #include "Config.h"
 #include "F3XFixedDistanceTask.h"
 #include "F3XFixedDistanceTaskData.h"
+#include "F3XRunWriteQueue.h"
+#include "F3XRunStatistics.h"
+#include "F3XPilotRoster.h"
+#include "F3XRoundScores.h"
+#include "F3XCourse.h"
 #include "settings.h"
 
 #define USE_RXTX_AS_GPIO  // for usage of rotary encoder instead of Serial
@@ -100,8 +118,11 @@ D10/TX : KY-040 Encoder - CLK
 
 #define PIN_BATTERY_IN    A0  // connected wiht R=100kOhm to support V > 3.2V
 
+// the IRQ line of the nRF24L01 is not wired in the current hardware (no free GPIO),
+// if connected, received packets are time stamped by an ISR instead of in updateRadio()
+// #define PIN_RF24_IRQ      Dx
+
 #define USE_BATTERY_IN_VOLTAGE
-#define PERF_DEBUG
 
 // #define NOBUZZ
 #ifdef NOBUZZ
@@ -112,7 +133,20 @@ D10/TX : KY-040 Encoder - CLK
 #define BUZZ_TIME_SHORT    100 // user info
 
 #include <RFTransceiver.h>
+#include <RFTxQueue.h>
 RFTransceiver ourRadio(myName, PIN_RF24_CE, PIN_RF24_CNS); // (CE, CSN)
+RFTxQueue ourRadioTxQueue(&ourRadio); // all frames are transmitted asynchronously by this queue
+F3XChannelSurvey ourChannelSurvey(&ourRadio);
+boolean ourChannelSurveyRequested = false;
+#define CHANNEL_SURVEY_AUTO_QUALITY   50.0f   // radio quality below this triggers a survey ...
+#define CHANNEL_SURVEY_AUTO_MISSED       3    // ... after this number of missed state requests
+#define CHANNEL_SURVEY_AUTO_DELAY   600000    // min. time between two automatic surveys in ms
+// if the B-Line is not reachable after a channel switch, the previous channel is restored
+// (longer than the fallback delay of the remote devices)
+#define RADIO_FALLBACK_DELAY 15000
+#define RADIO_FLUSH_TIMEOUT   1000  // ms, max. time to send the queued frames before a restart
+int8_t ourRadioFallbackChannel = -1;
+unsigned long ourRadioFallbackTime = 0;
 
 
 
@@ -151,6 +185,7 @@ enum ToolContext {
   TC_F3XRadioPowerCfg,
   TC_F3XInfo,
   TC_F3XRadioInfo,
+  TC_F3XPerfInfo,
   TC_F3XMessage,
   TC_F3BSpeedMenu,
   TC_F3BSpeedTask,
@@ -228,7 +263,8 @@ const char* ourF3XBaseMenu1 = "1:F3F Task";
 const char* ourF3XBaseMenu2 = "2:Info";
 const char* ourF3XBaseMenu3 = "3:Radio-Info";
 const char* ourF3XBaseMenu4 = "4:Settings";
-const char* ourF3XBaseMenuItems[] = {ourF3XBaseMenu0, ourF3XBaseMenu1, ourF3XBaseMenu2, ourF3XBaseMenu3, ourF3XBaseMenu4};
+const char* ourF3XBaseMenu5 = "5:Perf-Info";
+const char* ourF3XBaseMenuItems[] = {ourF3XBaseMenu0, ourF3XBaseMenu1, ourF3XBaseMenu2, ourF3XBaseMenu3, ourF3XBaseMenu4, ourF3XBaseMenu5};
 const uint8_t ourF3XBaseMenuSize = sizeof(ourF3XBaseMenuItems) / sizeof(char*);;
 
 // TC_F3XSettingsMenu
@@ -290,6 +326,8 @@ U8G2_SSD1306_128X64_NONAME_F_HW_I2C(rotation, [reset [, clock, data]]) [full fra
 #define OLED_FULL_BUFFER
 #ifdef OLED_FULL_BUFFER
 U8G2_SSD1306_128X64_NONAME_F_HW_I2C ourOLED(U8G2_R0, U8X8_PIN_NONE, PIN_OLED_SCL /*SCL*/, PIN_OLED_SDA /*SDA*/);  
+#include "F3XDisplayDiff.h"
+F3XDisplayDiff ourDisplayDiff; // only the changed tiles are sent to the OLED
 #else
 U8G2_SSD1306_128X64_NONAME_1_HW_I2C ourOLED(U8G2_R0, U8X8_PIN_NONE, PIN_OLED_SCL /*SCL*/, PIN_OLED_SDA /*SDA*/);  
 #endif
@@ -307,14 +345,31 @@ U8G2_SSD1306_128X64_NONAME_1_HW_I2C ourOLED(U8G2_R0, U8X8_PIN_NONE, PIN_OLED_SCL
 IPAddress ourApIp(192,168,4,1);
 IPAddress ourNetmask(255,255,255,0);
 ESP8266WebServer ourWebServer(80);
+F3XEventSource ourWebEvents; // live task data pushed to the browsers
+F3XWebFileStreamer ourWebFiles; // file transfers written in chunks from the loop
+F3XWebAssetIndex ourWebAssets;  // ETags and cache settings of the web assets
+// time budget (us) of the web server per loop, the signal handling preempts the web server
+#define WEB_SLICE_BUDGET_US          4000
+#define WEB_SLICE_BUDGET_CRITICAL_US 1000
+#define WEB_CSV_PAGE_RUNS               4 // runs of the CSV protocol created at once, about one chunk
+LatencyHistogram ourWebSliceLat; // duration (us) of the web server handling per loop
+#define SCHED_LOOP_BUDGET_US        40000 // the tasks of lower priority yield, if a loop would take longer
+#define OLED_REFRESH_CYCLE            250 // ms
+#define OLED_I2C_CLOCK             400000 // Hz, one tile row (128 bytes) takes about 3ms
+#define BAT_IN_CYCLE                10000 // ms
+F3XPerfProbes ourPerfProbes; // run time of the hot paths, /api/perf and the OLED perf page
+F3XScheduler ourScheduler(&ourPerfProbes, SCHED_LOOP_BUDGET_US);
+uint8_t ourProbeHttpData = ourPerfProbes.add("http data"); // getDataReq without sending
+uint8_t ourProbeHttpSend = ourPerfProbes.add("http send");
+uint8_t ourProbeRadioRx = ourPerfProbes.add("radio rx");   // reading the received packets
+uint8_t ourProbeOledSend = ourPerfProbes.add("oled send"); // transfer of one tile row of the display buffer
 unsigned long ourSecond = 0;
 
 static configData_t ourConfig;
-F3XFixedDistanceTask ourF3BSpeedTask(F3XFixedDistanceTask::F3BSpeedType);
-F3XFixedDistanceTaskData ourF3BTaskData(&ourF3BSpeedTask);
-F3XFixedDistanceTask ourF3FTask(F3XFixedDistanceTask::F3FType);
-F3XFixedDistanceTaskData ourF3FTaskData(&ourF3FTask);
-F3XFixedDistanceTask* ourF3XGenericTask = nullptr;
+F3XCourse ourCourses[F3X_COURSES_MAX] = { F3XCourse(0), F3XCourse(1) };
+F3XRunWriteQueue ourRunWriteQueue;
+F3XPilotRoster ourPilotRoster; // schedule of course 0
+F3XFixedDistanceTask* ourF3XGenericTask = nullptr; // active task of course 0
 unsigned long ourWlanRoundTripTime=0;
 unsigned long ourRadioRequestTime=0;
 float ourRadioRoundTripTime=0;
@@ -329,11 +384,16 @@ int8_t ourRadioChannel=-1;
 int8_t ourRadioDatarate=-1;
 boolean ourRadioAck=true;
 boolean ourRadioSendSettings=false;
-float ourRadioQuality=0.0f;
 uint16_t ourRadioStatePacketsMissed=0;
 uint16_t ourRadioSignalRoundTrip=0;
 boolean ourStartupPhase=true;
-F3XRemoteCommand ourRemoteCmd;
+F3XRemoteCommand ourRemoteCmd;                   // encoder of the frames to be sent
+F3XRemoteCommand ourRxCmds[RF24_STATS_PIPES];    // received frames per reading pipe (A-Line, B-Line, RemoteBuzzer, B-Line 2)
+static const char* ourRxPipeNames[RF24_STATS_PIPES] = { "A-Line", "B-Line", "Buzzer", "B-Line 2" };
+static const uint8_t ourPipeCourse[RF24_STATS_PIPES] = { 0, 0, 0, 1 }; // course of the signals received on a pipe
+F3XSequenceFilter ourRxSeqFilter; // drops retransmitted duplicates of already handled frames
+F3XClockSync ourClockSyncB;       // clock offset of the B-line controller
+#define SIGNAL_B_MAX_SENDER_AGE 2000  // ms, max. plausible age of a B-line press time stamp
 uint16_t ourBatteryAVoltage;
 uint16_t ourBatteryBVoltage;
 uint16_t ourBatteryBVoltageRaw;
@@ -345,10 +405,28 @@ String ourDialogString="";
 Bounce2::Button ourPushButton = Bounce2::Button();
 PinManager ourBuzzer(PIN_BUZZER_OUT);
 
+// micros() time stamps of signal events, captured by ISRs and consumed in the main loop
+#define SIGNAL_RING_SIZE 8
+#define SIGNAL_A_ISR_DEBOUNCE_US 50000UL  // ignore bouncing edges after a captured A-Line edge
+#define SIGNAL_MAX_AGE_US 500000UL        // captured time stamps older than this are discarded
+F3XEventRing<SIGNAL_RING_SIZE> ourSignalARing;
+#ifdef PIN_RF24_IRQ
+F3XEventRing<SIGNAL_RING_SIZE> ourRadioIrqRing;
+#endif
+
+// latency statistics (in us) of the signal to buzzer path
+LatencyHistogram ourSigLatRx;          // signal captured -> dispatched to the task
+LatencyHistogram ourSigLatDispatch;    // dispatched to the task -> signalBuzzing()
+LatencyHistogram ourSigLatRadioBuzzer; // transmission of the RemoteSignalBuzz command
+LatencyHistogram ourSigLatTotal;       // signal captured -> all buzzers triggered
+uint32_t ourSigLatCaptureTime = 0;
+uint32_t ourSigLatDispatchTime = 0;
+boolean ourSigLatInFlight = false;
+
 // =========== some function forward declarations ================
 
-void updateOLED(unsigned long aNow, bool aForce);
 void updateOLED(unsigned long aNow);
+void updateOLEDTransfer(unsigned long aNow);
 #ifdef USE_RXTX_AS_GPIO
 void resetRotaryEncoder(long aPos=0);
 #endif
@@ -360,37 +438,120 @@ void saveConfig();
 void takeOLEDScreenshot();
 
 
+/**
+ * start the latency measurement of a signal captured at aCaptureTime (micros()),
+ * has to be called directly before the signal is dispatched to the task
+ */
+void signalLatencyStart(uint32_t aCaptureTime) {
+  ourSigLatDispatchTime = micros();
+  ourSigLatCaptureTime = aCaptureTime;
+  ourSigLatRx.record(ourSigLatDispatchTime - aCaptureTime);
+  ourSigLatInFlight = true;
+}
+
+/**
+ * end the latency measurement, has to be called directly after the signal is dispatched
+ */
+void signalLatencyEnd() {
+  ourSigLatInFlight = false;
+}
+
+String getLatencyStr(LatencyHistogram* aHist) {
+  return String(aHist->getPercentile(50)/1000.0f, 1) + F("/") 
+    + String(aHist->getPercentile(99)/1000.0f, 1) + F("/") 
+    + String(aHist->getMax()/1000.0f, 1);
+}
+
+/**
+ * return the signal path latencies as p50/p99/max in ms for the stages
+ */
+String getSignalLatencyInfo() {
+  return String(F("rx:")) + getLatencyStr(&ourSigLatRx)
+    + F(" task:") + getLatencyStr(&ourSigLatDispatch)
+    + F(" radio-buzz:") + getLatencyStr(&ourSigLatRadioBuzzer)
+    + F(" total:") + getLatencyStr(&ourSigLatTotal)
+    + F(" (#") + String(ourSigLatTotal.getCount()) + F(")");
+}
+
+void resetSignalLatency() {
+  ourSigLatRx.reset();
+  ourSigLatDispatch.reset();
+  ourSigLatRadioBuzzer.reset();
+  ourSigLatTotal.reset();
+}
+
+/**
+ * signal the task with the press time stamp of the B-line controller converted to the local clock,
+ * so RF retransmissions do not delay the signal time. Returns false, if the clock of the sender
+ * is not synchronized or the converted time is implausible.
+ */
+boolean signalAtSenderTime(F3XFixedDistanceTask::Signal aSignal, F3XRemoteCommand* aCmd) {
+  uint32_t aRxTimestamp = aCmd->getRxTimestamp();
+  if (aCmd->getSeq() == F3X_RC_SEQ_NONE 
+      || aCmd->getDevice() != RFTransceiver::F3XBLineController
+      || !ourClockSyncB.isValid()) {
+    return false;
+  }
+  unsigned long rxTime = millis() - (micros() - aRxTimestamp)/1000;
+  unsigned long pressTime = ourClockSyncB.toLocal(aCmd->getTimestamp());
+  long age = (long) (rxTime - pressTime);
+  if (age < -((long) ourClockSyncB.getRtt()) - 1 || age > SIGNAL_B_MAX_SENDER_AGE) {
+    logEvent(LOG_MOD_SIG, WARNING, LogFmtSenderAgeImplausible, age);
+    return false;
+  }
+  if (age < 0) {
+    // inaccuracy of the clock synchronization, the signal can not be pressed after it was received
+    pressTime = rxTime;
+  }
+  logEvent(LOG_MOD_SIG, DEBUG, LogFmtSenderAge, age);
+  ourF3XGenericTask->signalAt(aSignal, pressTime);
+  return true;
+}
+
+/**
+ * restart the line controllers of both courses and the remote buzzer and, after aDelay ms, ourself. Without
+ * aRestartOnlyBLine the frames are sent by the loop until the restart, with it they are sent
+ * synchronously, because the caller (e.g. the OTA update) does not return to the loop.
+ */
 void restartMCs(uint16_t aDelay, bool aRestartOnlyBLine=false) {
-  ourRadio.transmit(ourRemoteCmd.createCommand(F3XRemoteCommandType::CmdRestartMC)->c_str(), 20);
-  ourRadio.setWritingPipe(2);
-  ourRadio.transmit(ourRemoteCmd.createCommand(F3XRemoteCommandType::CmdRestartMC)->c_str(), 20);
-  ourRadio.setWritingPipe(0);
-  if (!aRestartOnlyBLine) {
+  ourRadioTxQueue.send(ourRemoteCmd.createFrame(F3XRemoteCommandType::CmdRestartMC), 0, RFTxQueue::PrioCommand, 20);
+  ourRadioTxQueue.send(ourRemoteCmd.createFrame(F3XRemoteCommandType::CmdRestartMC), 3, RFTxQueue::PrioCommand, 20);
+  ourRadioTxQueue.send(ourRemoteCmd.createFrame(F3XRemoteCommandType::CmdRestartMC), 2, RFTxQueue::PrioCommand, 20);
+  if (aRestartOnlyBLine) {
+    if (!ourRadioTxQueue.flush(RADIO_FLUSH_TIMEOUT)) {
+      logMsg(LOG_MOD_RADIO, ERROR, F("restart of the MCs not sent"));
+    }
+  } else {
     // force a restart of ourself
     ourTimedReset = millis() + aDelay;
   }
 }
 
 
+void radioBuzzerDone(const RFTxQueue::Result* aResult) {
+  ourSigLatRadioBuzzer.record(aResult->latencyUs);
+  if (!aResult->success) {
+    logEvent(LOG_MOD_RADIO, ERROR, LogFmtRadioBuzzerFailed, aResult->retransCnt);
+  }
+  logEvent(LOG_MOD_RADIO, INFO, LogFmtRadioBuzzerDone, aResult->latencyUs/1000);
+}
+
 /*
 * send a RF24 command to the 2. pipe (radioBuzzer) 
 */
 void radioBuzzer(uint16_t aDura) {
   // logMsg(INFO, String(F("=====> radioBuzzer on:")) + String(aDura)); 
-  ourRadio.setWritingPipe(2);
-  unsigned long a = millis();
-  boolean sendSuccess = ourRadio.transmit(ourRemoteCmd.createCommand(F3XRemoteCommandType::RemoteSignalBuzz, String(aDura))->c_str(), 4);
-
-  if (!sendSuccess) {
-    logMsg(LOG_MOD_RADIO, ERROR, String(F("sending RemoteSignalBuzz NOT successsfull. Retransmissions: ")) 
-      + String(ourRadio.getRetransmissionCount()));
-  }
-  logMsg(LOG_MOD_RADIO, INFO, String(F("sending RemoteSignalBuzz in: ") + String((millis() - a)))); 
-  ourRadio.setWritingPipe(0);
+  ourRadioTxQueue.send(ourRemoteCmd.createFrame(F3XRemoteCommandType::RemoteSignalBuzz, aDura), 
+    2, RFTxQueue::PrioSignal, 4, radioBuzzerDone);
+  // start the transmission immediately, if the radio is idle
+  ourRadioTxQueue.update();
 }
 
 void signalBuzzing(uint16_t aDuration) {
-  logMsg(LOG_MOD_SIG, INFO, "ABM: signalBuzzing: " + String(aDuration));
+  if (ourSigLatInFlight) {
+    ourSigLatDispatch.record(micros() - ourSigLatDispatchTime);
+  }
+  logEvent(LOG_MOD_SIG, INFO, LogFmtSignalBuzzing, aDuration);
   switch (ourConfig.buzzerSetting) {
     case BS_ALL: // both buzzers are active 
       radioBuzzer(aDuration);
@@ -405,40 +566,66 @@ void signalBuzzing(uint16_t aDuration) {
     case BS_NONE: // no buzzers are active 
       break;
   }
+  if (ourSigLatInFlight) {
+    ourSigLatTotal.record(micros() - ourSigLatCaptureTime);
+    ourSigLatInFlight = false;
+    logMsg(LOG_MOD_PERF, DEBUG, String(F("signal latency p50/p99/max ms: ")) + getSignalLatencyInfo());
+  }
 }
 
-void signalAListener() {
-  logMsg(LOG_MOD_SIG, INFO, "ABM: signalAListener");
-  if (ourF3XGenericTask->getTaskState() == F3XFixedDistanceTask::TaskFinished) {
-    // looong signal at final A-Line overfly signalling 1500ms
-    signalBuzzing(BUZZ_TIME_LONG);
-    if (ourF3XGenericTask->getLoopTasksEnabled()) {
-      ourF3XGenericTask->stop();
-      ourF3XGenericTask->start();
+/**
+ * finished run of aCourse: snapshot it before a loop task resets it, it is written to flash from the loop
+ */
+void handleSignalA(uint8_t aCourse) {
+  F3XCourse* course = &ourCourses[aCourse];
+  F3XFixedDistanceTask* task = course->getActiveTask();
+  if (task->getTaskState() == F3XFixedDistanceTask::TaskFinished) {
+    if (aCourse == 0) {
+      // looong signal at final A-Line overfly signalling 1500ms
+      signalBuzzing(BUZZ_TIME_LONG);
     }
-  } else {
+    F3XFixedDistanceTask::F3XType type = task->getType();
+    // only the runs of course 0 are scheduled
+    uint8_t pilot = aCourse == 0 ? ourPilotRoster.getCurrentPilot() : F3X_PILOT_NONE;
+    const F3XRunRecord* record = ourRunWriteQueue.push(course->getData(type), pilot,
+      pilot == F3X_PILOT_NONE ? 0 : ourPilotRoster.getRound(), ourPilotRoster.getGroup(pilot), ourPilotRoster.getGeneration());
+    course->getStats(type)->add(record);
+    course->getStats(type, true)->add(record);
+    course->getScores(type)->add(record);
+    if (aCourse == 0) {
+      // next pilot of the schedule
+      ourPilotRoster.next();
+    }
+    if (task->getLoopTasksEnabled()) {
+      task->stop();
+      task->start();
+    }
+  } else if (aCourse == 0) {
     // default signalling 500ms
     signalBuzzing(BUZZ_TIME_NORMAL);
   }
-  switch(ourF3XGenericTask->getType()) {
-    case F3XFixedDistanceTask::F3BSpeedType:
-      if (ourF3XGenericTask->getTaskState() == F3XFixedDistanceTask::TaskFinished) {
-        ourF3BTaskData.writeData();
-      }
-      break;
-    case F3XFixedDistanceTask::F3FType:
-      if (ourF3XGenericTask->getTaskState() == F3XFixedDistanceTask::TaskFinished) {
-        ourF3FTaskData.writeData();
-      }
-      break;
-  }
+}
+
+void signalAListener() {
+  logEvent(LOG_MOD_SIG, INFO, LogFmtSignalA, 1);
+  handleSignalA(0);
 }
 
 void signalBListener() {
-  logMsg(LOG_MOD_SIG, INFO, "signalBListener");
+  logEvent(LOG_MOD_SIG, INFO, LogFmtSignalB, 1);
   signalBuzzing(BUZZ_TIME_NORMAL);
 }
 
+// the listeners are plain functions, the signals of course 1 have their own, without buzzer
+void signalAListener2() {
+  logEvent(LOG_MOD_SIG, INFO, LogFmtSignalA, 2);
+  handleSignalA(1);
+}
+
+void signalBListener2() {
+  logEvent(LOG_MOD_SIG, INFO, LogFmtSignalB, 2);
+}
+
 /**
   return a leg time literal with the format 12.23s/43m  
 */
@@ -481,6 +668,7 @@ const uint8_t *oledFontTiny;
 
 
 void setupOLED() {
+  ourOLED.setBusClock(OLED_I2C_CLOCK);
   ourOLED.begin();
   int oledDisplayHeight = ourOLED.getDisplayHeight(); 
   int oledDisplayWidth = ourOLED.getDisplayWidth(); 
@@ -498,6 +686,11 @@ void setupRadio() {
   logMsg(INFO, F("setup RCTTransceiver/nRF24L01")); 
   ourRadio.begin(RFTransceiver::F3XBaseManager);  // set 0 for BaseManager
   logMsg(INFO, F("setup for RCTTransceiver/nRF24L01 successful")); 
+  #ifdef PIN_RF24_IRQ
+  ourRadio.setRxIrqOnly();
+  pinMode(PIN_RF24_IRQ, INPUT);
+  attachInterrupt(digitalPinToInterrupt(PIN_RF24_IRQ), isrRadioIrq, FALLING);
+  #endif
 
   // in the RFTransceiver implementation the default values for the radio settings are defined 
   // for A- and B-Line Manager (Channel:110/Power:HIGH/Datarate:RF24_250KBPS/Ack:true)
@@ -532,6 +725,7 @@ void setupLittleFS() {
     return;
   }
   forceOLED(0, ("FS ok"));
+  logMsg(INFO, String(F("web assets in index: ")) + String(ourWebAssets.load()));
 }
 
 
@@ -629,6 +823,70 @@ String getWebContentType(String filename) {
   return F("text/plain");
 }
 
+/**
+ * parse a single byte range "bytes=<start>-<end>", "bytes=<start>-" or "bytes=-<suffix length>"
+ * of a file with aSize bytes, returns false if it is not satisfiable
+ */
+bool parseHttpRange(const String& aRange, uint32_t aSize, uint32_t* aStart, uint32_t* aEnd) {
+  if (!aRange.startsWith(F("bytes=")) || aSize == 0) {
+    return false;
+  }
+  int sep = aRange.indexOf('-');
+  String first = aRange.substring(6, sep);
+  String last = aRange.substring(sep+1);
+  if (sep < 0 || (first.length() == 0 && last.length() == 0)) {
+    return false;
+  }
+  if (first.length() == 0) {
+    uint32_t suffix = last.toInt();
+    if (suffix == 0) {
+      return false;
+    }
+    *aStart = suffix >= aSize ? 0 : aSize - suffix;
+    *aEnd = aSize - 1;
+  } else {
+    *aStart = first.toInt();
+    *aEnd = last.length() == 0 ? aSize - 1 : (uint32_t) last.toInt();
+    if (*aEnd >= aSize) {
+      *aEnd = aSize - 1;
+    }
+  }
+  return *aStart <= *aEnd;
+}
+
+/**
+ * answer a range request of a (not compressed) file with 206 and the requested part
+ */
+bool handleWebRangeRead(File& aFile, const String& aContentType, const String& aRange) {
+  uint32_t size = aFile.size();
+  uint32_t start, end;
+  if (!parseHttpRange(aRange, size, &start, &end)) {
+    ourWebServer.sendHeader(F("Content-Range"), String(F("bytes */")) + String(size));
+    ourWebServer.send(416, F("text/plain"), String());
+    aFile.close();
+    return true;
+  }
+  uint32_t len = end - start + 1;
+  ourWebServer.sendHeader(F("Content-Range"), String(F("bytes ")) + String(start) + F("-") + String(end) + F("/") + String(size));
+  ourWebServer.setContentLength(len);
+  ourWebServer.send(206, aContentType, String());
+  aFile.seek(start);
+  if (!ourWebFiles.add(aFile, ourWebServer.client(), len)) {
+    logMsg(LOG_MOD_HTTP, WARNING, F("no free file transfer slot for range request"));
+    uint8_t buffer[F3X_WEB_CHUNK_SIZE];
+    while (len > 0) {
+      size_t n = aFile.read(buffer, len < sizeof(buffer) ? len : sizeof(buffer));
+      if (n == 0) {
+        break;
+      }
+      ourWebServer.client().write(buffer, n);
+      len -= n;
+    }
+    aFile.close();
+  }
+  return true;
+}
+
 // send file to the client (if it exists)
 bool handleWebFileRead(String path) {
   if (ourConfig.competitionSetting == true && ourIsTimeCriticalOperationRunning == true) {
@@ -640,6 +898,18 @@ bool handleWebFileRead(String path) {
   if (path.endsWith(F("/"))) path += F("index.html");
   String contentType = getWebContentType(path);
   String pathWithGz = path + F(".gz");
+
+  // assets built by tools/build_web_assets.py are validated by their ETag
+  boolean immutable = false;
+  const String* etag = ourWebAssets.getETag(path, &immutable);
+  if (etag != nullptr) {
+    ourWebServer.sendHeader(F("ETag"), *etag);
+    ourWebServer.sendHeader(F("Cache-Control"), immutable ? F("public, max-age=31536000, immutable") : F("no-cache"));
+    if (ourWebServer.header(F("If-None-Match")) == *etag) {
+      ourWebServer.send(304, F("text/plain"), String());
+      return true;
+    }
+  }
       
   // If the file exists, either as a compressed archive, or normal
   if (LittleFS.exists(pathWithGz) || LittleFS.exists(path)) {
@@ -647,7 +917,29 @@ bool handleWebFileRead(String path) {
       path += F(".gz");
     logMsg(DEBUG, F("WebServer: open file ") + path);
     File file = LittleFS.open(path, "r");
-    size_t sent = ourWebServer.streamFile(file, contentType);
+    if (!path.endsWith(F(".gz"))) {
+      // parts of the (growing) data files can be requested
+      ourWebServer.sendHeader(F("Accept-Ranges"), F("bytes"));
+      String range = ourWebServer.header(F("Range"));
+      if (range.length() > 0 && range.indexOf(',') < 0) {
+        return handleWebRangeRead(file, contentType, range);
+      }
+    }
+    if (file.size() > F3X_WEB_CHUNK_SIZE) {
+      // send the header only, the content is written in chunks from the loop
+      if (path.endsWith(F(".gz")) && contentType != F("application/x-gzip")) {
+        ourWebServer.sendHeader(F("Content-Encoding"), F("gzip"));
+      }
+      ourWebServer.setContentLength(file.size());
+      ourWebServer.send(200, contentType, String());
+      if (ourWebFiles.add(file, ourWebServer.client())) {
+        return true;
+      }
+      logMsg(LOG_MOD_HTTP, WARNING, F("no free file transfer slot: ") + path);
+      ourWebServer.client().write(file);
+    } else {
+      ourWebServer.streamFile(file, contentType);
+    }
     file.close();
     return true;
   }     
@@ -655,9 +947,26 @@ bool handleWebFileRead(String path) {
   return false;
 }   
 
+/**
+ * course of a web request by the argument "course", 0 if missing or invalid
+ */
+uint8_t getWebCourse() {
+  int course = ourWebServer.arg(F("course")).toInt();
+  return (course > 0 && course < F3X_COURSES_MAX) ? course : 0;
+}
+
+/**
+ * task type of a web request by the argument "task": "f3f" or F3BSpeed
+ */
+F3XFixedDistanceTask::F3XType getWebTaskType() {
+  return ourWebServer.arg(F("task")) == F("f3f") ? F3XFixedDistanceTask::F3FType : F3XFixedDistanceTask::F3BSpeedType;
+}
+
 void setWebDataReq() {
   String name = ourWebServer.arg(F("name"));
   String value = ourWebServer.arg(F("value"));
+  F3XCourse* course = &ourCourses[getWebCourse()];
+  F3XFixedDistanceTask* task = course->getActiveTask();
   #ifdef DO_LOG
   logMsg(DEBUG, ourWebServer.client().remoteIP().toString() + F(" : setWebDataReq()"));
   logMsg(DEBUG, String(F("  ")) + name + F("=") + value);
@@ -670,27 +979,31 @@ void setWebDataReq() {
   // general settings stuff
   if (name == F("signal_a")) {
     logMsg(INFO, F("signal A event from web client"));
-    ourF3XGenericTask->signal(F3XFixedDistanceTask::SignalA);
+    task->signal(F3XFixedDistanceTask::SignalA);
   } else
   if (name == F("signal_b")) {
     logMsg(INFO, F("signal B event from web client"));
-    ourF3XGenericTask->signal(F3XFixedDistanceTask::SignalB);
+    task->signal(F3XFixedDistanceTask::SignalB);
   } else 
   if (name == F("stop_task")) {
     logMsg(INFO, F("stop task event from web client"));
-    ourF3XGenericTask->stop();
+    task->stop();
   } else 
   if (name == F("start_task")) {
     logMsg(INFO, F("start task event from web client"));
-    ourLoopF3XTask = false;
-    ourF3XGenericTask->setLoopTasksEnabled(ourLoopF3XTask);
-    ourF3XGenericTask->start();
+    if (course->getIndex() == 0) {
+      ourLoopF3XTask = false;
+    }
+    task->setLoopTasksEnabled(false);
+    task->start();
   } else 
   if (name == F("loop_task")) {
     logMsg(INFO, F("loop task event from web client"));
-    ourLoopF3XTask = true;
-    ourF3XGenericTask->setLoopTasksEnabled(ourLoopF3XTask);
-    ourF3XGenericTask->start();
+    if (course->getIndex() == 0) {
+      ourLoopF3XTask = true;
+    }
+    task->setLoopTasksEnabled(true);
+    task->start();
   } else 
   if (name == F("start_rt_measurement")) {
     logMsg(DEBUG, F("start_rt_measurement"));
@@ -702,17 +1015,17 @@ void setWebDataReq() {
   } else 
   if (name == F("f3f_tasktime")) {
     ourConfig.f3fTasktime=value.toInt();
-    ourF3FTask.setTasktime(ourConfig.f3fTasktime);
+    applyTaskSettings();
     logMsg(LOG_MOD_TASK, INFO, F("set f3f_tasktime :") + String(ourConfig.f3fTasktime));
   } else 
   if (name == F("f3f_leg_length")) {
     ourConfig.f3fLegLength=value.toInt();
-    ourF3FTask.setLegLength(ourConfig.f3fLegLength);
+    applyTaskSettings();
     logMsg(LOG_MOD_TASK, INFO, F("set f3f_leg_length :") + String(ourConfig.f3fLegLength));
   } else 
   if (name == F("f3b_speed_tasktime")) {
     ourConfig.f3bSpeedTasktime=value.toInt();
-    ourF3BSpeedTask.setTasktime(ourConfig.f3bSpeedTasktime);
+    applyTaskSettings();
     logMsg(LOG_MOD_TASK, INFO, F("set f3b_speed_tasktime :") + String(ourConfig.f3bSpeedTasktime));
   } else 
   if (name == F("buzzer_setting")) {
@@ -785,11 +1098,33 @@ void setWebDataReq() {
   } else 
   if (name == F("delete_f3f_data")) {
     logMsg(LOG_MOD_HTTP, INFO, "remove F3FTaskData"); 
-    ourF3FTaskData.remove();
+    ourRunWriteQueue.discard(course->getData(F3XFixedDistanceTask::F3FType));
+    course->getData(F3XFixedDistanceTask::F3FType)->remove();
+    course->getStats(F3XFixedDistanceTask::F3FType)->reset();
+    course->getStats(F3XFixedDistanceTask::F3FType, true)->reset();
+    course->getScores(F3XFixedDistanceTask::F3FType)->reset();
   } else 
   if (name == F("delete_f3b_data")) {
     logMsg(LOG_MOD_HTTP, INFO, "remove F3BTaskData"); 
-    ourF3BTaskData.remove();
+    ourRunWriteQueue.discard(course->getData(F3XFixedDistanceTask::F3BSpeedType));
+    course->getData(F3XFixedDistanceTask::F3BSpeedType)->remove();
+    course->getStats(F3XFixedDistanceTask::F3BSpeedType)->reset();
+    course->getStats(F3XFixedDistanceTask::F3BSpeedType, true)->reset();
+    course->getScores(F3XFixedDistanceTask::F3BSpeedType)->reset();
+  } else 
+  if (name == F("schedule_next")) {
+    ourPilotRoster.next();
+  } else 
+  if (name == F("schedule_previous")) {
+    ourPilotRoster.previous();
+  } else 
+  if (name == F("schedule_reset")) {
+    logMsg(LOG_MOD_HTTP, INFO, "reset schedule"); 
+    ourPilotRoster.reset();
+  } else 
+  if (name == F("reset_session_stats")) {
+    logMsg(LOG_MOD_HTTP, INFO, "reset session statistics"); 
+    course->getStats(value == F("f3f") ? F3XFixedDistanceTask::F3FType : F3XFixedDistanceTask::F3BSpeedType, true)->reset();
   } else 
   if (name == F("cmd_fwupdate")) {
     logMsg(LOG_MOD_HTTP, INFO, "fw update"); 
@@ -838,6 +1173,17 @@ void setWebDataReq() {
   if (name == F("take_screenshot")) {
     logMsg(LOG_MOD_HTTP, INFO, "take OLED screenshot"); 
     takeOLEDScreenshot();
+  } else 
+  if (name == F("start_channel_survey")) {
+    logMsg(LOG_MOD_HTTP, INFO, "channel survey requested"); 
+    ourChannelSurveyRequested = true;
+  } else 
+  if (name == F("reset_signal_latency")) {
+    logMsg(LOG_MOD_HTTP, INFO, "reset signal latency statistics"); 
+    resetSignalLatency();
+    ourWebSliceLat.reset();
+    ourScheduler.resetStatistics();
+    ourPerfProbes.reset();
   } else {
     logMsg(LOG_MOD_HTTP, ERROR, F("ERROR: unknown name : ") + name  + F(" in set request, value ") + value);
   }
@@ -874,7 +1220,8 @@ void getWebHeaderData(String* aReturnString, boolean aForce=false) {
     String(ourRadio.getChannel()) + F("/") + 
     String(ourRadio.getDataRate()) + F("/") + 
     String(ourRadio.getAck()) + F(":") +
-    String(ourRadioQuality, 0) + F("/") + String(ourRadioStatePacketsMissed) + F("/") + String(ourRadioSignalRoundTrip)+String(F("ms"));  
+    String(getRadioQuality(), 0) + String(ourRadioTxQueue.getLinkQuality(0)->getTrendChar()) + F("/") 
+    + String(ourRadioTxQueue.getLinkQuality(0)->getPacketErrorRate(), 0) + F("%/") + String(ourRadioStatePacketsMissed) + F("/") + String(ourRadioSignalRoundTrip)+String(F("ms"));  
 
   if (webRadio != currRadio || aForce) {
     webRadio = currRadio;
@@ -1063,6 +1410,393 @@ void getF3BSpeedWebData(String* aReturnString, boolean aForce=false) {
   }
 }
 
+/**
+ * data of the web page of the current task context, aForce: complete data, otherwise only the changes
+ */
+void getTaskWebData(String* aReturnString, boolean aForce) {
+  if (ourConfig.competitionSetting == true && ourIsTimeCriticalOperationRunning == true) {
+    // restricted web mode while time critical operation
+    *aReturnString += String(F("id_time=")) + F3XFixedDistanceTask::getHMSTimeStr(millis()) + MYSEP_STR;
+    return;
+  }
+  switch (ourContext.get()) {
+    case TC_F3BSpeedTask:
+      getWebHeaderData(aReturnString, aForce);
+      getF3BSpeedWebData(aReturnString, aForce);
+      if (ourF3XGenericTask->getTaskState() == F3XFixedDistanceTask::TaskRunning) {
+        *aReturnString += String(F("id_running_speed_time="))
+                  + ourF3XGenericTask->getLegTimeString(ourF3XGenericTask->getCourseTime(F3X_GFT_RUNNING_TIME), F3X_TIME_NOT_SET, 0, 0, 0)
+                  + MYSEP_STR;
+      }
+      break;
+    case TC_F3FTask:
+      getWebHeaderData(aReturnString, aForce);
+      getF3FWebData(aReturnString, aForce);
+      break;
+    default:
+      getWebHeaderData(aReturnString, aForce);
+      break;
+  }
+}
+
+/**
+ * subscription of a browser to the server sent events of the task pages
+ */
+void getWebEventsReq() {
+  // bring the connected browsers up to date, before the forced data of the new one resets the change detection
+  String data;
+  getTaskWebData(&data, false);
+  ourWebEvents.send(data);
+
+  int8_t slot = ourWebEvents.addClient(ourWebServer.client());
+  if (slot < 0) {
+    logMsg(LOG_MOD_HTTP, WARNING, F("no more web event clients possible"));
+    ourWebServer.send(503, F("text/plain"), F("too many event clients"));
+    return;
+  }
+  logMsg(LOG_MOD_HTTP, INFO, ourWebServer.client().remoteIP().toString() + F(" : web events subscribed, clients: ") 
+    + String(ourWebEvents.getClientCount()));
+  data = String(F("id_version=")) + APP_VERSION + MYSEP_STR;
+  getTaskWebData(&data, true);
+  ourWebEvents.sendTo(slot, data);
+}
+
+/**
+ * push the task data to the subscribed browsers: immediately on a state change or a signalled leg,
+ * otherwise as time tick
+ */
+void updateWebEvents(unsigned long aNow) {
+  #define WEB_EVENT_TICK          1000
+  #define WEB_EVENT_TICK_RUNNING   250
+  static unsigned long nextTick = 0;
+  static int lastState = -1;
+
+  ourWebEvents.update();
+  if (ourWebEvents.getClientCount() == 0 || ourF3XGenericTask == nullptr) {
+    return;
+  }
+  boolean isRunning = ourF3XGenericTask->getTaskState() == F3XFixedDistanceTask::TaskRunning;
+  int state = ourF3XGenericTask->getTaskState()*100 + ourF3XGenericTask->getSignalledLegCount();
+  if (state == lastState && aNow < nextTick) {
+    return;
+  }
+  lastState = state;
+  nextTick = aNow + (isRunning ? WEB_EVENT_TICK_RUNNING : WEB_EVENT_TICK);
+  String data;
+  getTaskWebData(&data, false);
+  ourWebEvents.send(data);
+}
+
+/**
+ * task state as JSON with raw times in ms, formatted by the browser: /api/task?v=<version>[&course=<course>]
+ * Only the legs changed after the version of the client are sent, with "full":1 all legs.
+ * Each leg is [index, leg time, dead time, dead distance].
+ */
+void getApiTaskReq() {
+  F3XCourse* course = &ourCourses[getWebCourse()];
+  F3XFixedDistanceTask* task = course->getActiveTask();
+  if ((ourConfig.competitionSetting == true && ourIsTimeCriticalOperationRunning == true) || task == nullptr) {
+    ourWebServer.send(503, F("text/plain"), F("F3XCompetition in restricted web mode while time critical operation !"));
+    return;
+  }
+  F3XTaskStateTracker* tracker = course->getStateTracker();
+  tracker->update(task);
+  uint32_t clientVersion = ourWebServer.arg(F("v")).toInt();
+  boolean full = tracker->isFullUpdate(clientVersion);
+
+  String json;
+  json.reserve(160);
+  json += F("{\"v\":");
+  json += String(tracker->getVersion());
+  json += F(",\"full\":");
+  json += full ? F("1") : F("0");
+  json += F(",\"type\":");
+  json += String(task->getType());
+  json += F(",\"state\":");
+  json += String(task->getTaskState());
+  json += F(",\"signalled\":");
+  json += String(task->getSignalledLegCount());
+  json += F(",\"legMax\":");
+  json += String(task->getLegNumberMax());
+  json += F(",\"legLength\":");
+  json += String(task->getLegLength());
+  json += F(",\"taskTime\":");
+  json += String(task->getRemainingTasktime());
+  json += F(",\"inAir\":");
+  json += String(task->getInAirTime());
+  json += F(",\"course\":");
+  json += String((long) task->getCourseTime(F3X_GFT_RUNNING_TIME));
+  json += F(",\"legs\":[");
+  boolean first = true;
+  for (uint8_t i=0; i<tracker->getLegCount(); i++) {
+    if (!full && !tracker->isLegChanged(i, clientVersion)) {
+      continue;
+    }
+    F3XLeg leg = task->getLeg(i);
+    if (!first) {
+      json += F(",");
+    }
+    first = false;
+    json += F("[");
+    json += String(i) + F(",") + String(leg.time) + F(",") + String(leg.deadTime) + F(",") + String(leg.deadDistance);
+    json += F("]");
+  }
+  json += F("]}");
+  ourWebServer.sendHeader(F("Cache-Control"), F("no-cache"));
+  ourWebServer.send(200, F("application/json"), json);
+}
+
+/**
+ * append a CSV line of a run as JSON string to the String given as aContext
+ */
+void appendRunJson(const String& aLine, void* aContext) {
+  String* json = (String*) aContext;
+  if (!json->endsWith(F("["))) {
+    *json += F(",");
+  }
+  *json += F("\"");
+  for (uint16_t i=0; i<aLine.length(); i++) {
+    char c = aLine.charAt(i);
+    if (c == '"' || c == '\\') {
+      *json += '\\';
+    }
+    if (c >= ' ') {
+      *json += c;
+    }
+  }
+  *json += F("\"");
+}
+
+/**
+ * a page of the stored runs: /api/runs?task=f3b|f3f&from=<first run, 0 is the oldest>&count=<runs>[&course=<course>]
+ * without "from" the most recent runs are returned. The runs are the CSV lines of the protocol.
+ */
+void getApiRunsReq() {
+  #define API_RUNS_MAX_COUNT 20
+  if (ourConfig.competitionSetting == true && ourIsTimeCriticalOperationRunning == true) {
+    ourWebServer.send(503, F("text/plain"), F("F3XCompetition in restricted web mode while time critical operation !"));
+    return;
+  }
+  F3XFixedDistanceTaskData* data = ourCourses[getWebCourse()].getData(getWebTaskType());
+  uint16_t total = data->getRunCount();
+  uint16_t count = ourWebServer.hasArg(F("count")) ? ourWebServer.arg(F("count")).toInt() : 10;
+  if (count > API_RUNS_MAX_COUNT) {
+    count = API_RUNS_MAX_COUNT;
+  }
+  uint16_t from = total > count ? total - count : 0;
+  if (ourWebServer.hasArg(F("from"))) {
+    from = ourWebServer.arg(F("from")).toInt();
+  }
+
+  String json;
+  json.reserve(256 + count * 200);
+  json += F("{\"total\":");
+  json += String(total);
+  json += F(",\"from\":");
+  json += String(from);
+  json += F(",\"header\":[");
+  appendRunJson(data->getHeaderLine(), &json);
+  json += F("],\"runs\":[");
+  if (from < total) {
+    data->readRuns(from, count, appendRunJson, &json);
+  }
+  json += F("]}");
+  ourWebServer.sendHeader(F("Cache-Control"), F("no-cache"));
+  ourWebServer.send(200, F("application/json"), json);
+}
+
+/**
+ * append the statistics aStats as JSON object to aJson, times in ms, distances in m
+ */
+void appendStatisticsJson(String* aJson, F3XRunStatistics* aStats, uint8_t aLegNumber) {
+  *aJson += F("{\"count\":");
+  *aJson += String(aStats->getCount());
+  *aJson += F(",\"best\":");
+  *aJson += String(aStats->getBestCourseTime());
+  *aJson += F(",\"bestRun\":");
+  *aJson += String(aStats->getBestRunNo());
+  *aJson += F(",\"avg\":");
+  *aJson += String(aStats->getAvgCourseTime());
+  *aJson += F(",\"p50\":");
+  *aJson += String(aStats->getPercentile(50));
+  *aJson += F(",\"p90\":");
+  *aJson += String(aStats->getPercentile(90));
+  *aJson += F(",\"recent\":");
+  *aJson += String(aStats->getRecentCourseTime());
+  *aJson += F(",\"trend\":\"");
+  *aJson += aStats->getTrendChar();
+  *aJson += F("\",\"legs\":[");
+  for (uint8_t i=0; i<aLegNumber; i++) {
+    if (i > 0) {
+      *aJson += F(",");
+    }
+    *aJson += F("[");
+    *aJson += String(aStats->getBestLegTime(i)) + F(",") + String(aStats->getAvgDeadTime(i)) + F(",") + String(aStats->getAvgDeadDistance(i), 1);
+    *aJson += F("]");
+  }
+  *aJson += F("]}");
+}
+
+/**
+ * run time of the probes: /api/perf, times in us, not restricted while time critical operation,
+ * to see the latencies under load
+ */
+void getApiPerfReq() {
+  String json;
+  json.reserve(256 + ourPerfProbes.getCount() * 160);
+  json += F("{\"uptime\":");
+  json += String(millis());
+  json += F(",\"heap\":");
+  json += String(ESP.getFreeHeap());
+  json += F(",\"probes\":");
+  ourPerfProbes.appendJson(&json);
+  json += F("}");
+  ourWebServer.sendHeader(F("Cache-Control"), F("no-cache"));
+  ourWebServer.send(200, F("application/json"), json);
+}
+
+/**
+ * statistics of the runs: /api/stats?task=f3b|f3f[&course=<course>], of all stored runs and of the current session
+ */
+void getApiStatsReq() {
+  F3XCourse* course = &ourCourses[getWebCourse()];
+  F3XFixedDistanceTask::F3XType type = getWebTaskType();
+  F3XRunStatistics* stats = course->getStats(type);
+  F3XRunStatistics* sessionStats = course->getStats(type, true);
+  uint8_t legNumber = course->getTask(type)->getLegNumberMax();
+  String json;
+  json.reserve(512);
+  json += F("{\"all\":");
+  appendStatisticsJson(&json, stats, legNumber);
+  json += F(",\"session\":");
+  appendStatisticsJson(&json, sessionStats, legNumber);
+  json += F("}");
+  ourWebServer.sendHeader(F("Cache-Control"), F("no-cache"));
+  ourWebServer.send(200, F("application/json"), json);
+}
+
+/**
+ * the pilot roster and the schedule: GET /api/pilots returns them as JSON, POST /api/pilots
+ * replaces the roster by the body (one pilot per line: <name>;<group>)
+ */
+void getApiPilotsReq() {
+  if (ourWebServer.method() == HTTP_POST) {
+    if (ourConfig.competitionSetting == true && ourIsTimeCriticalOperationRunning == true) {
+      ourWebServer.send(503, F("text/plain"), F("F3XCompetition in restricted web mode while time critical operation !"));
+      return;
+    }
+    ourPilotRoster.setPilots(ourWebServer.arg(F("plain")));
+    // no logged run belongs to the new roster generation, the scores start empty
+    resetRoundScores();
+  }
+  String json;
+  json.reserve(128 + ourPilotRoster.getCount() * 32);
+  json += F("{\"round\":");
+  json += String(ourPilotRoster.getRound());
+  json += F(",\"position\":");
+  json += String(ourPilotRoster.getPosition());
+  json += F(",\"current\":");
+  json += String(ourPilotRoster.getCurrentPilot() == F3X_PILOT_NONE ? -1 : ourPilotRoster.getCurrentPilot());
+  json += F(",\"order\":[");
+  for (uint8_t i=0; i<ourPilotRoster.getCount(); i++) {
+    json += (i > 0 ? F(",") : F(""));
+    json += String(ourPilotRoster.getPilotAt(i));
+  }
+  json += F("],\"pilots\":[");
+  for (uint8_t i=0; i<ourPilotRoster.getCount(); i++) {
+    json += (i > 0 ? F(",[\"") : F("[\""));
+    json += ourPilotRoster.getName(i) + F("\",") + String(ourPilotRoster.getGroup(i)) + F("]");
+  }
+  json += F("]}");
+  ourWebServer.sendHeader(F("Cache-Control"), F("no-cache"));
+  ourWebServer.send(200, F("application/json"), json);
+}
+
+/**
+ * the normalised scores of the pilots: /api/results?task=f3b|f3f[&course=<course>]
+ * pilots: [name, group, course time of the current round in ms, round score, total score, best course time in ms]
+ */
+void getApiResultsReq() {
+  F3XRoundScores* scores = ourCourses[getWebCourse()].getScores(getWebTaskType());
+  String json;
+  json.reserve(128 + ourPilotRoster.getCount() * 64);
+  json += F("{\"round\":");
+  json += String(scores->getRound());
+  json += F(",\"rounds\":");
+  json += String(scores->getRoundCount());
+  json += F(",\"pilots\":[");
+  for (uint8_t i=0; i<ourPilotRoster.getCount(); i++) {
+    json += (i > 0 ? F(",[\"") : F("[\""));
+    json += ourPilotRoster.getName(i) + F("\",") + String(ourPilotRoster.getGroup(i));
+    json += F(",") + String(scores->getRoundTime(i));
+    json += F(",") + String(scores->getRoundScore(i), 2);
+    json += F(",") + String(scores->getTotalScore(i), 2);
+    json += F(",") + String(scores->getBestTime(i)) + F("]");
+  }
+  json += F("]}");
+  ourWebServer.sendHeader(F("Cache-Control"), F("no-cache"));
+  ourWebServer.send(200, F("application/json"), json);
+}
+
+/**
+ * append a CSV line of the protocol to the chunk given as aContext, a full chunk is sent
+ */
+void sendCsvLine(const String& aLine, void* aContext) {
+  String* chunk = (String*) aContext;
+  *chunk += aLine;
+  *chunk += '\n';
+  if (chunk->length() >= F3X_WEB_CHUNK_SIZE) {
+    ourWebServer.sendContent(*chunk);
+    *chunk = String();
+  }
+}
+
+/**
+ * page aPage of the CSV protocol of the task data aContext: the column names and units, then
+ * WEB_CSV_PAGE_RUNS runs per page
+ */
+boolean getCsvPage(uint16_t aPage, String* aBuffer, void* aContext) {
+  F3XFixedDistanceTaskData* data = (F3XFixedDistanceTaskData*) aContext;
+  if (aPage == 0) {
+    *aBuffer += data->getHeaderLine() + F("\n") + data->getUnitsLine() + F("\n");
+    return true;
+  }
+  return data->appendRunLines((aPage-1) * WEB_CSV_PAGE_RUNS, WEB_CSV_PAGE_RUNS, aBuffer) > 0;
+}
+
+/**
+ * the CSV protocol of a task (/F3BSpeedData.csv, /F3FTaskData.csv[?course=<course>]), created from
+ * the run log page by page by the file streamer
+ */
+void getWebCsvReq() {
+  if (ourConfig.competitionSetting == true && ourIsTimeCriticalOperationRunning == true) {
+    ourWebServer.send(503, F("text/plain"), F("F3XCompetition in restricted web mode while time critical operation !"));
+    return;
+  }
+  F3XCourse* course = &ourCourses[getWebCourse()];
+  F3XFixedDistanceTaskData* data = ourWebServer.uri() == course->getData(F3XFixedDistanceTask::F3FType)->getProtocolFilePath()
+    ? course->getData(F3XFixedDistanceTask::F3FType) : course->getData(F3XFixedDistanceTask::F3BSpeedType);
+  if (ourWebFiles.getActiveCount() < F3X_WEB_STREAMS) {
+    // the header is written here, the web server would terminate a chunked body after the handler
+    WiFiClient client = ourWebServer.client();
+    client.print(String(F("HTTP/1.1 200 OK\r\nContent-Type: ")) + getWebContentType(ourWebServer.uri()) 
+      + F("\r\nTransfer-Encoding: chunked\r\nCache-Control: no-cache\r\nConnection: close\r\n\r\n"));
+    ourWebFiles.add(getCsvPage, data, client);
+    return;
+  }
+  logMsg(LOG_MOD_HTTP, WARNING, F("no free file transfer slot: ") + ourWebServer.uri());
+  ourWebServer.sendHeader(F("Cache-Control"), F("no-cache"));
+  ourWebServer.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  ourWebServer.send(200, getWebContentType(ourWebServer.uri()), String());
+  String chunk;
+  chunk.reserve(F3X_WEB_CHUNK_SIZE + 256);
+  data->exportCsv(sendCsvLine, &chunk);
+  if (chunk.length() > 0) {
+    ourWebServer.sendContent(chunk);
+  }
+  ourWebServer.sendContent(String()); // last chunk
+}
+
 void getWebLogReq() {
   String response;
 
@@ -1096,9 +1830,7 @@ void getWebDataReq() {
     ourWebServer.send(200, F("text/plane"), response.c_str()); //Send the response value only to client ajax request
     return;
   }
-  #ifdef PERF_DEBUG
-  unsigned long start = millis();
-  #endif
+  ourPerfProbes.start(ourProbeHttpData);
   // logMsg(DEBUG, ourWebServer.client().remoteIP().toString());
 
   if (ourStartupPhase) {
@@ -1200,10 +1932,44 @@ void getWebDataReq() {
     if (argName.equals(F("id_radio_power"))) {
         response += argName + "=" + ourRadio.getPowerStr() + MYSEP_STR;
     } else
+    if (argName.equals(F("id_oled"))) {
+        #if defined(OLED) && defined(OLED_FULL_BUFFER)
+        response += argName + "=" + String(ourDisplayDiff.getFrameCount()) + F("/") + String(ourDisplayDiff.getAvgBytes())
+          + F("/") + String(ourDisplayDiff.getLastBytes()) + MYSEP_STR;
+        #endif
+    } else
+    if (argName.equals(F("id_scheduler"))) {
+        response += argName + "=" + ourScheduler.getInfo() + MYSEP_STR;
+    } else
+    if (argName.equals(F("id_web_slice"))) {
+        response += argName + "=" + getWebSliceInfo() + MYSEP_STR;
+    } else
+    if (argName.equals(F("id_signal_latency"))) {
+        response += argName + "=" + getSignalLatencyInfo() + MYSEP_STR;
+    } else
+    if (argName.equals(F("id_radio_txqueue"))) {
+        response += argName + "=" + getRadioTxQueueInfo() + MYSEP_STR;
+    } else
+    if (argName.equals(F("id_channel_survey"))) {
+        response += argName + "=" + getChannelSurveyInfo() + MYSEP_STR;
+    } else
+    if (argName.equals(F("id_radio_link"))) {
+        response += argName + "=" + getRadioLinkInfo() + MYSEP_STR;
+    } else
+    if (argName.equals(F("id_radio_pipes"))) {
+        response += argName + "=" + getRadioPipeInfo() + MYSEP_STR;
+    } else
     if (argName.equals(F("initMainMenu"))) {
       ourContext.set(TC_F3XBaseMenu);
       response += String(F("id_version=")) + APP_VERSION + MYSEP_STR;
     } else
+    if ((argName.equals(F("initF3BSpeedTask")) || argName.equals(F("initF3FTask"))) && getWebCourse() != 0) {
+      // the pages of the other courses show the state of api/task, the OLED context stays at course 0
+      ourCourses[getWebCourse()].setActiveTask(argName.equals(F("initF3FTask")) ? F3XFixedDistanceTask::F3FType : F3XFixedDistanceTask::F3BSpeedType);
+      response += String(F("id_version=")) + APP_VERSION + MYSEP_STR;
+      getWebHeaderData(&pushData, true);
+      response += pushData;
+    } else
     if (argName.equals(F("initF3BSpeedTask"))) {
       ourContext.set(TC_F3BSpeedTask);
       setActiveTask(F3XFixedDistanceTask::F3BSpeedType);
@@ -1258,37 +2024,10 @@ void getWebDataReq() {
       logMsg(ERROR, String(F("ERROR: unknown name of get request: ") + argName));
     }
   }
-  #ifdef PERF_DEBUG
-  unsigned long wstart = millis();
-  #endif
+  ourPerfProbes.stop(ourProbeHttpData);
+  ourPerfProbes.start(ourProbeHttpSend);
   ourWebServer.send(200, F("text/plane"), response.c_str()); //Send the response value only to client ajax request
-  #ifdef PERF_DEBUG
-  if ((millis() - wstart) > 20) {
-    logMsg(LOG_MOD_PERF, DEBUG, String(F("performance info for ourWebServer.send():")) + String(millis()-wstart));
-  }
-  #endif
-  
-  #ifdef PERF_DEBUG
-  if ((millis() - start) > 20) {
-    logMsg(LOG_MOD_PERF, DEBUG, String(F("performance info for getWebDataReq:")) + String(millis()-start));
-    String message = F("getWebDataReq");
-
-    message += F("client : ");
-    message += ourWebServer.client().remoteIP().toString();
-    message += F("URI: ");
-    message += ourWebServer.uri();
-    message += F("\nMethod: ");
-    message += (ourWebServer.method() == HTTP_GET)?F("GET"):F("POST");
-    message += F("\nArguments: ");
-    message += ourWebServer.args();
-    message += F("\n");
-    for (uint8_t i=0; i<ourWebServer.args(); i++){
-      message += F(" NAME:")+ourWebServer.argName(i) + F("\n VALUE:") + ourWebServer.arg(i) + F(")\n");
-    }
-
-    logMsg(DEBUG, message);
-  }
-  #endif
+  ourPerfProbes.stop(ourProbeHttpSend);
 }
 
 
@@ -1296,6 +2035,17 @@ void setupWebServer() {
   // react on these "pages"
   ourWebServer.on(F("/getDataReq"),getWebDataReq);
   ourWebServer.on(F("/setDataReq"),setWebDataReq);
+  ourWebServer.on(F("/events"),getWebEventsReq);
+  ourWebServer.on(F("/api/task"),getApiTaskReq);
+  ourWebServer.on(F("/api/runs"),getApiRunsReq);
+  ourWebServer.on(F("/api/stats"),getApiStatsReq);
+  ourWebServer.on(F("/api/perf"),getApiPerfReq);
+  ourWebServer.on(F("/api/pilots"),getApiPilotsReq);
+  ourWebServer.on(F("/api/results"),getApiResultsReq);
+  ourWebServer.on(ourCourses[0].getData(F3XFixedDistanceTask::F3BSpeedType)->getProtocolFilePath(),getWebCsvReq);
+  ourWebServer.on(ourCourses[0].getData(F3XFixedDistanceTask::F3FType)->getProtocolFilePath(),getWebCsvReq);
+  const char* headerKeys[] = { "If-None-Match", "Range" };
+  ourWebServer.collectHeaders(headerKeys, 2);
   ourWebServer.on(F("/internalLog.html"),getWebLogReq);
 
   // If the client requests any URI
@@ -1410,7 +2160,7 @@ void otaUpdate(bool aFileSystemUpdate) {
     return;
   }
   WiFiClient client;
-  updateOLED(millis(), true);
+  updateOLED(millis());
   t_httpUpdate_return ret;
   if (aFileSystemUpdate) {
     ret = ESPhttpUpdate.updateFS(client, url, "");
@@ -1443,7 +2193,10 @@ void otaUpdate(bool aFileSystemUpdate) {
 // End: OVER THE AIR
 
 void setupRemoteCmd() {
-  ourRemoteCmd.begin();
+  ourRemoteCmd.begin(RFTransceiver::F3XBaseManager);
+  for (uint8_t i=0; i<RF24_STATS_PIPES; i++) {
+    ourRxCmds[i].begin(RFTransceiver::F3XBaseManager);
+  }
 }
 
 /**
@@ -1455,48 +2208,164 @@ void f3fTimeProceedingListener() {
   signalBuzzing(BUZZ_TIME_SHORT);
 }
 
+/**
+ * true, if a task of any course is running, the state is set before the listeners are called
+ */
+boolean isAnyCourseRunning() {
+  for (uint8_t i=0; i<F3X_COURSES_MAX; i++) {
+    if (ourCourses[i].isRunning()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void taskStateListener(F3XFixedDistanceTask::State aState) {
+  ourIsTimeCriticalOperationRunning = isAnyCourseRunning();
   switch(aState) {
     case F3XFixedDistanceTask::TaskRunning:
-      ourIsTimeCriticalOperationRunning = true;
       signalBuzzing(BUZZ_TIME_NORMAL);
       break;
-    case F3XFixedDistanceTask::TaskWaiting:
-      ourIsTimeCriticalOperationRunning = false;
-      break;
     case F3XFixedDistanceTask::TaskError:
     case F3XFixedDistanceTask::TaskTimeOverflow:
-      ourIsTimeCriticalOperationRunning = false;
       signalBuzzing(BUZZ_TIME_LONG);
       break;
-    case F3XFixedDistanceTask::TaskFinished:
-      ourIsTimeCriticalOperationRunning = false;
-      break;
-    case F3XFixedDistanceTask::TaskNotSet:
-      ourIsTimeCriticalOperationRunning = false;
+    default:
       break;
   }
 }
 
+void taskStateListener2(F3XFixedDistanceTask::State aState) {
+  ourIsTimeCriticalOperationRunning = isAnyCourseRunning();
+}
+
+typedef struct {
+  F3XRunStatistics* stats;
+  F3XRoundScores* scores;
+} RunAggregates;
+
+void addRunAggregates(const F3XRunRecord* aRecord, void* aContext) {
+  RunAggregates* aggregates = (RunAggregates*) aContext;
+  aggregates->stats->add(aRecord);
+  aggregates->scores->add(aRecord);
+}
+
+/**
+ * statistics and scores of all stored runs, read once from the run logs, afterwards each
+ * finished run is added
+ */
+void readRunAggregates() {
+  static const F3XFixedDistanceTask::F3XType types[] = { F3XFixedDistanceTask::F3BSpeedType, F3XFixedDistanceTask::F3FType };
+  for (uint8_t c=0; c<F3X_COURSES_MAX; c++) {
+    for (uint8_t t=0; t<2; t++) {
+      RunAggregates aggregates = { ourCourses[c].getStats(types[t]), ourCourses[c].getScores(types[t]) };
+      aggregates.stats->reset();
+      aggregates.scores->setRoster(ourPilotRoster.getGeneration());
+      ourCourses[c].getData(types[t])->readRecords(0, UINT16_MAX, addRunAggregates, &aggregates);
+    }
+  }
+}
+
+/**
+ * empty scores of all courses for the current roster generation, the run logs are not read
+ */
+void resetRoundScores() {
+  for (uint8_t c=0; c<F3X_COURSES_MAX; c++) {
+    ourCourses[c].getScores(F3XFixedDistanceTask::F3BSpeedType)->setRoster(ourPilotRoster.getGeneration());
+    ourCourses[c].getScores(F3XFixedDistanceTask::F3FType)->setRoster(ourPilotRoster.getGeneration());
+  }
+}
+
+/**
+ * task time and leg length of the configuration for the tasks of all courses
+ */
+void applyTaskSettings() {
+  for (uint8_t c=0; c<F3X_COURSES_MAX; c++) {
+    ourCourses[c].getTask(F3XFixedDistanceTask::F3BSpeedType)->setTasktime(ourConfig.f3bSpeedTasktime);
+    ourCourses[c].getTask(F3XFixedDistanceTask::F3FType)->setTasktime(ourConfig.f3fTasktime);
+    ourCourses[c].getTask(F3XFixedDistanceTask::F3FType)->setLegLength(ourConfig.f3fLegLength);
+  }
+}
+
 void setupF3XTasks() {
-  // F3BSpeedTask
-  ourF3BSpeedTask.addSignalAListener(signalAListener);
-  ourF3BSpeedTask.addSignalBListener(signalBListener);
-  ourF3BSpeedTask.addStateChangeListener(taskStateListener);
-  ourF3BSpeedTask.setTasktime(ourConfig.f3bSpeedTasktime);
-  ourF3BTaskData.init();
-
-  // F3FTask
-  ourF3FTask.addSignalAListener(signalAListener);
-  ourF3FTask.addSignalBListener(signalBListener);
-  ourF3FTask.addStateChangeListener(taskStateListener);
-  ourF3FTask.addTimeProceedingListener(f3fTimeProceedingListener);
-  ourF3FTask.setTasktime(ourConfig.f3fTasktime);
-  ourF3FTask.setLegLength(ourConfig.f3fLegLength);
-  ourF3FTaskData.init();
+  for (uint8_t c=0; c<F3X_COURSES_MAX; c++) {
+    F3XFixedDistanceTask* f3bTask = ourCourses[c].getTask(F3XFixedDistanceTask::F3BSpeedType);
+    F3XFixedDistanceTask* f3fTask = ourCourses[c].getTask(F3XFixedDistanceTask::F3FType);
+    if (c == 0) {
+      f3bTask->addSignalAListener(signalAListener);
+      f3bTask->addSignalBListener(signalBListener);
+      f3bTask->addStateChangeListener(taskStateListener);
+      f3fTask->addSignalAListener(signalAListener);
+      f3fTask->addSignalBListener(signalBListener);
+      f3fTask->addStateChangeListener(taskStateListener);
+      f3fTask->addTimeProceedingListener(f3fTimeProceedingListener);
+    } else {
+      f3bTask->addSignalAListener(signalAListener2);
+      f3bTask->addSignalBListener(signalBListener2);
+      f3bTask->addStateChangeListener(taskStateListener2);
+      f3fTask->addSignalAListener(signalAListener2);
+      f3fTask->addSignalBListener(signalBListener2);
+      f3fTask->addStateChangeListener(taskStateListener2);
+    }
+    ourCourses[c].getData(F3XFixedDistanceTask::F3BSpeedType)->init();
+    ourCourses[c].getData(F3XFixedDistanceTask::F3FType)->init();
+    ourRunWriteQueue.addTaskData(ourCourses[c].getData(F3XFixedDistanceTask::F3BSpeedType));
+    ourRunWriteQueue.addTaskData(ourCourses[c].getData(F3XFixedDistanceTask::F3FType));
+  }
+  applyTaskSettings();
+
+  // runs snapshotted but not written before the last reset
+  ourRunWriteQueue.replay();
+
+  ourPilotRoster.load();
+  readRunAggregates();
   
   // set a default task to avoid not initialized task settings
   setActiveTask(F3XFixedDistanceTask::F3BSpeedType);
+  for (uint8_t c=1; c<F3X_COURSES_MAX; c++) {
+    ourCourses[c].setActiveTask(F3XFixedDistanceTask::F3BSpeedType);
+  }
+}
+
+/**
+ * ISR of the A-Line signalling button, captures the time of the first falling edge,
+ * the debounced button handling itself is still done by Bounce2 in updatePushButton()
+ */
+IRAM_ATTR void isrSignalALine() {
+  static uint32_t lastEdge = 0;
+  uint32_t now = micros();
+  if ((now - lastEdge) > SIGNAL_A_ISR_DEBOUNCE_US) {
+    ourSignalARing.push(now);
+    lastEdge = now;
+  }
+}
+
+#ifdef PIN_RF24_IRQ
+/**
+ * ISR of the nRF24L01 IRQ line (active low), only the RX_DR interrupt is enabled
+ */
+IRAM_ATTR void isrRadioIrq() {
+  ourRadioIrqRing.push(micros());
+}
+#endif
+
+/**
+ * return the newest captured time stamp of the given ring, which is not older than
+ * SIGNAL_MAX_AGE_US, older entries are dropped. If no time stamp is available, 
+ * the current time is returned.
+ */
+uint32_t getCapturedTimestamp(F3XEventRing<SIGNAL_RING_SIZE>* aRing, boolean aOldest=false) {
+  uint32_t now = micros();
+  uint32_t retVal = now;
+  uint32_t stamp;
+  boolean found = false;
+  while (aRing->pop(&stamp)) {
+    if ((now - stamp) < SIGNAL_MAX_AGE_US && !(aOldest && found)) {
+      retVal = stamp;
+      found = true;
+    }
+  }
+  return retVal;
 }
 
 void setupSignallingButton() {
@@ -1509,6 +2378,9 @@ void setupSignallingButton() {
 
   // INDICATE THAT THE LOW STATE CORRESPONDS TO PHYSICALLY PRESSING THE BUTTON
   ourPushButton.setPressedState(LOW); 
+
+  // capture the exact time of the button press independent of the loop latency
+  attachInterrupt(digitalPinToInterrupt(PIN_SIGNAL_A_LINE), isrSignalALine, FALLING);
 }
   
 
@@ -1543,8 +2415,39 @@ void setupSerial() {
   #define SERIAL_LOG true
 #endif
 
+const char ourLogFmtSignalA[] PROGMEM = "signal A, course %d";
+const char ourLogFmtSignalB[] PROGMEM = "signal B, course %d";
+const char ourLogFmtSignalBuzzing[] PROGMEM = "signal buzzing: %dms";
+const char ourLogFmtSenderAge[] PROGMEM = "sender time stamp age: %dms";
+const char ourLogFmtSenderAgeImplausible[] PROGMEM = "implausible sender time stamp, age: %dms";
+const char ourLogFmtRadioBuzzerFailed[] PROGMEM = "sending RemoteSignalBuzz NOT successsfull. Retransmissions: %d";
+const char ourLogFmtRadioBuzzerDone[] PROGMEM = "sending RemoteSignalBuzz in: %dms";
+const char ourLogFmtDuplicateFrame[] PROGMEM = "duplicate frame dropped, device/seq/type: %d/%d/%d";
+const char ourLogFmtTaskSignal[] PROGMEM = "FDT::signal(%s)";
+const char ourLogFmtTaskSignalNotAllowed[] PROGMEM = " not allowed in state %d";
+const char ourLogFmtTaskTimeOverflow[] PROGMEM = "FDT::timeOverflow";
+const char ourLogFmtSchedOverrun[] PROGMEM = "performance info for %s: %dus, budget: %dus";
+const char ourLogFmtSchedSlowLoop[] PROGMEM = "slow last loop: %dms";
+// same order as F3XLogFormat
+const char* const ourLogFormats[LogFmtCount] = {
+  ourLogFmtSignalA,
+  ourLogFmtSignalB,
+  ourLogFmtSignalBuzzing,
+  ourLogFmtSenderAge,
+  ourLogFmtSenderAgeImplausible,
+  ourLogFmtRadioBuzzerFailed,
+  ourLogFmtRadioBuzzerDone,
+  ourLogFmtDuplicateFrame,
+  ourLogFmtTaskSignal,
+  ourLogFmtTaskSignalNotAllowed,
+  ourLogFmtTaskTimeOverflow,
+  ourLogFmtSchedOverrun,
+  ourLogFmtSchedSlowLoop,
+};
+
 void setupLog(const char* aName) {
   Logger::getInstance().setup(aName);
+  Logger::getInstance().setFormats(ourLogFormats, LogFmtCount);
   Logger::getInstance().doSerialLogging(SERIAL_LOG);
   Logger::getInstance().setLogLevel(LOG_MOD_ALL, INFO);
   Logger::getInstance().setLogLevel(LOG_MOD_RADIO, DEBUG);
@@ -1698,12 +2601,251 @@ void setup() {
   #ifdef USE_RXTX_AS_GPIO
   resetRotaryEncoder(TC_F3XBaseMenu);
   #endif
+  setupScheduler();
+}
+
+/**
+ * callback of the CmdCycleTestRequest transmission, the start of the last attempt is
+ * the send time of the clock synchronization round trip
+ */
+void cycleTestRequestDone(const RFTxQueue::Result* aResult) {
+  if (aResult->dropped) {
+    return;
+  }
+  if (aResult->success) {
+    ourRadioRequestTime = aResult->txStartMs;
+  } else {
+    logMsg(LOG_MOD_RTEST, DEBUG, F("sending CmdCycleTestRequest NOT successfull"));
+  }
+}
+
+void bLineStateReqDone(const RFTxQueue::Result* aResult) {
+  if (aResult->dropped) {
+    // not sent, no sample of the link
+    return;
+  }
+  uint16_t signalRoundTrip = aResult->latencyUs/1000;
+  if (aResult->success && ourRadioFallbackTime != 0) {
+    ourRadioFallbackTime = 0;
+    logMsg(LOG_MOD_RADIO, INFO, String(F("channel switch confirmed by B-Line: ")) + String(ourRadio.getChannel()));
+  }
+
+  uint8_t lost=0;
+  if (!aResult->success) {
+    logMsg(LOG_MOD_RADIO, INFO, String(F("sending TestRequest NOT successsfull. Retransmissions: ")) 
+      + String(aResult->retransCnt) + String(F("/")) + String(signalRoundTrip) + String(F("ms")));
+    ourBuzzer.on(PinManager::SHORT);
+    lost=100;
+    signalRoundTrip = UINT16_MAX;
+    ourBatteryBVoltage = 0;
+  } else {
+    logMsg(LOG_MOD_RADIO, DEBUG, String(F("sending TestRequest successsfull. Retransmissions: ")) 
+      + String(aResult->retransCnt) + String(F("/")) + String(signalRoundTrip) + String(F("ms")));
+  }
+
+  if (lost) {
+    ourRadioStatePacketsMissed++;
+  }
+  ourRadioSignalRoundTrip = irr_low_pass_filter(ourRadioSignalRoundTrip, signalRoundTrip, 0.4f);
+  logMsg(LOG_MOD_RADIO, INFO, F("radio quality: ") + getLinkQualityStr(0));
+}
+
+/**
+ * changed radio settings are transmitted to the B-Line, now the B-Line of the second course gets them
+ */
+void setRadioBLineDone(const RFTxQueue::Result* aResult) {
+  if (aResult->dropped) {
+    // not sent, nothing is switched yet, sent again from the loop
+    ourRadioSendSettings = true;
+    return;
+  }
+  if (!aResult->success) {
+    logMsg(LOG_MOD_RADIO, ERROR, F("sending radio settings to B-Line not possible"));
+    ourRadioChannel = ourRadio.getChannel();
+    return;
+  }
+  ourRadioTxQueue.send(ourRemoteCmd.createFrame(F3XRemoteCommandType::CmdSetRadio, 
+    ourRadioPower, ourRadioChannel, ourRadioDatarate, ourRadioAck), 3, RFTxQueue::PrioCommand, 20, setRadioBLine2Done);
+}
+
+/**
+ * radio settings are transmitted to the B-Line of the second course, if there is one, now the
+ * remote buzzer gets them
+ */
+void setRadioBLine2Done(const RFTxQueue::Result* aResult) {
+  if (!aResult->success) {
+    logMsg(LOG_MOD_RADIO, WARNING, F("radio settings not received by the B-Line of course 2"));
+  }
+  ourRadioTxQueue.send(ourRemoteCmd.createFrame(F3XRemoteCommandType::CmdSetRadio, 
+    ourRadioPower, ourRadioChannel, ourRadioDatarate, ourRadioAck), 2, RFTxQueue::PrioCommand, 20, setRadioBuzzerDone);
+}
+
+/**
+ * radio settings are transmitted to all remote devices, now the BaseManager can also be switched
+ */
+void setRadioBuzzerDone(const RFTxQueue::Result* aResult) {
+  if (ourRadioChannel != ourRadio.getChannel()) {
+    // the new channel has to be confirmed by a successful BLineStateReq, see bLineStateReqDone()
+    ourRadioFallbackChannel = ourRadio.getChannel();
+    ourRadioFallbackTime = millis() + RADIO_FALLBACK_DELAY;
+  }
+  ourRadio.setPower(ourRadioPower);
+  ourRadio.setChannel(ourRadioChannel);
+  ourRadio.setDataRate(ourRadioDatarate);
+  ourRadio.setAck(ourRadioAck);
+
+  // set the new radio settings to the configuration data, which can be stored in the EEPROM later on
+  ourConfig.radioChannel = ourRadioChannel;
+  ourConfig.radioPower = ourRadioPower;
+  logMsg(LOG_MOD_RADIO, INFO, String(F("radio settings set local, remote buzzer: ")) + String(aResult->success));
+
+  // confirm the new settings to the remote devices immediately
+  ourRadioTxQueue.send(ourRemoteCmd.createFrame(F3XRemoteCommandType::BLineStateReq, ourRadioRequestArg), 
+    0, RFTxQueue::PrioHousekeeping, 20, bLineStateReqDone);
+  ourRadioTxQueue.send(ourRemoteCmd.createFrame(F3XRemoteCommandType::BLineStateReq, ourRadioRequestArg), 
+    3, RFTxQueue::PrioHousekeeping, 20);
+  ourRadioTxQueue.send(ourRemoteCmd.createFrame(F3XRemoteCommandType::RemoteSignalStateReq, ourRadioRequestArg), 
+    2, RFTxQueue::PrioHousekeeping, 20);
+}
+
+/**
+ * restore the previous channel, if the B-Line did not confirm a channel switch in time
+ */
+void updateRadioFallback(unsigned long aNow) {
+  if (ourRadioFallbackTime != 0 && aNow > ourRadioFallbackTime) {
+    ourRadioFallbackTime = 0;
+    logMsg(LOG_MOD_RADIO, ERROR, String(F("B-Line not reachable on channel ")) + String(ourRadio.getChannel()) 
+      + F(", back to channel ") + String(ourRadioFallbackChannel));
+    ourRadioChannel = ourRadioFallbackChannel;
+    ourRadio.setChannel(ourRadioChannel);
+    ourConfig.radioChannel = ourRadioChannel;
+  }
+}
+
+/**
+ * run the channel survey (manually requested or triggered by a bad radio quality) while the
+ * task is waiting and the TX queue is idle, the best channel is set on all devices afterwards.
+ * Returns true, while the survey is running and the radio can not be used.
+ */
+boolean updateChannelSurvey(unsigned long aNow) {
+  static unsigned long nextAutoSurvey = CHANNEL_SURVEY_AUTO_DELAY;
+  static uint16_t missedAtLastSurvey = 0;
+  boolean waiting = ourF3XGenericTask->getTaskState() == F3XFixedDistanceTask::TaskWaiting;
+
+  if (ourChannelSurvey.getState() == F3XChannelSurvey::SurveyRunning) {
+    if (!waiting) {
+      logMsg(LOG_MOD_RADIO, WARNING, F("channel survey aborted, task started"));
+      ourChannelSurvey.abort();
+      return false;
+    }
+    if (ourChannelSurvey.update()) {
+      uint8_t channel = ourChannelSurvey.getRecommendedChannel();
+      logMsg(LOG_MOD_RADIO, INFO, String(F("channel survey done, best/current channel (score): ")) 
+        + String(ourChannelSurvey.getBestChannel()) + F("(") + String(ourChannelSurvey.getScore(ourChannelSurvey.getBestChannel())) 
+        + F(")/") + String(ourChannelSurvey.getWorkingChannel()) + F("(") 
+        + String(ourChannelSurvey.getScore(ourChannelSurvey.getWorkingChannel())) + F(")"));
+      if (channel != ourChannelSurvey.getWorkingChannel()) {
+        // coordinated switch: B-Line -> B-Line of course 2 -> remote buzzer -> local, independent of the radio quality
+        ourRadioChannel = channel;
+        ourRadioTxQueue.send(ourRemoteCmd.createFrame(F3XRemoteCommandType::CmdSetRadio, 
+          ourRadioPower, ourRadioChannel, ourRadioDatarate, ourRadioAck), 0, RFTxQueue::PrioCommand, 20, setRadioBLineDone);
+      }
+      return false;
+    }
+    return true;
+  }
+
+  if (getRadioQuality() < CHANNEL_SURVEY_AUTO_QUALITY 
+      && ourRadioStatePacketsMissed - missedAtLastSurvey >= CHANNEL_SURVEY_AUTO_MISSED
+      && aNow > nextAutoSurvey) {
+    logMsg(LOG_MOD_RADIO, INFO, String(F("bad radio quality, channel survey requested: ")) + String(getRadioQuality(), 0) + F("%"));
+    ourChannelSurveyRequested = true;
+  }
+  if (ourChannelSurveyRequested && waiting && ourRadioTxQueue.isIdle() && ourRadioFallbackTime == 0) {
+    ourChannelSurveyRequested = false;
+    nextAutoSurvey = aNow + CHANNEL_SURVEY_AUTO_DELAY;
+    missedAtLastSurvey = ourRadioStatePacketsMissed;
+    logMsg(LOG_MOD_RADIO, INFO, F("channel survey started"));
+    ourChannelSurvey.start();
+    return true;
+  }
+  return false;
+}
+
+/**
+ * return the state of the channel survey and the recommended channel
+ */
+String getChannelSurveyInfo() {
+  switch (ourChannelSurvey.getState()) {
+    case F3XChannelSurvey::SurveyRunning:
+      return String(F("running ")) + String(ourChannelSurvey.getProgress()) + F("%");
+    case F3XChannelSurvey::SurveyDone: {
+        uint8_t best = ourChannelSurvey.getBestChannel();
+        uint8_t working = ourChannelSurvey.getWorkingChannel();
+        return String(F("best: ")) + String(best) + F(" (") + String(ourChannelSurvey.getScore(best)) 
+          + F("), previous: ") + String(working) + F(" (") + String(ourChannelSurvey.getScore(working)) + F(")");
+      }
+    default:
+      return ourChannelSurveyRequested ? String(F("requested")) : String(F("-"));
+  }
+}
+
+/**
+ * return the TX queue latencies as p50/p99/max in ms and sent/failed counts per priority
+ */
+String getRadioTxQueueInfo() {
+  String info;
+  const char* names[] = { "signal", "cmd", "house" };
+  for (uint8_t i=0; i<RFTxQueue::PrioNum; i++) {
+    RFTxQueue::Stats* stats = ourRadioTxQueue.getStats((RFTxQueue::Priority) i);
+    info += String(names[i]) + F(":") + getLatencyStr(&stats->latency) 
+      + F(" (") + String(stats->sent) + F("/") + String(stats->failed) + F("/") + String(stats->dropped) + F(") ");
+  }
+  return info;
+}
+
+/**
+ * quality (0-100%) of the link to the B-Line, estimated from all transmissions to it
+ */
+float getRadioQuality() {
+  return ourRadioTxQueue.getLinkQuality(0)->getQuality();
+}
+
+/**
+ * return the link quality of the writing pipe aPipe: quality% trend/packet error rate%/mean ARC/p50 latency
+ */
+String getLinkQualityStr(uint8_t aPipe) {
+  F3XLinkQuality* link = ourRadioTxQueue.getLinkQuality(aPipe);
+  return String(link->getQuality(), 0) + F("%") + String(link->getTrendChar()) + F("/") 
+    + String(link->getPacketErrorRate(), 0) + F("%/") + String(link->getMeanArc(), 1) + F("/")
+    + String(link->getLatency()->getPercentile(50)/1000.0f, 1) + F("ms");
+}
+
+/**
+ * return the link quality to the B-Line and the remote buzzer
+ */
+String getRadioLinkInfo() {
+  return String(F("B-Line:")) + getLinkQualityStr(0) + F(" Buzzer:") + getLinkQualityStr(2);
+}
+
+/**
+ * return the receive statistics per reading pipe: packets/bytes/CRC drops/jitter in ms
+ */
+String getRadioPipeInfo() {
+  String info;
+  for (uint8_t i=0; i<RF24_STATS_PIPES; i++) {
+    RFTransceiver::PipeStats* stats = ourRadio.getPipeStats(i);
+    info += String(ourRxPipeNames[i]) + F(":") + String(stats->packets) + F("/") + String(stats->bytes) 
+      + F("/") + String(ourRxCmds[i].getCrcErrorCount()) + F("/") + String(stats->jitter/1000.0f, 1) + F(" ");
+  }
+  return info;
 }
 
 void updateRadio(unsigned long aNow) {
   
   static unsigned long lastCmdCycleTestRequest = 0;
   #define CMD_CYCLE_REQUEST_DELAY 500
+  #define CMD_CYCLE_REQUEST_DELAY_SYNCED 2000
 
   static unsigned long lastBLineRequest = 0;
   #define B_LINE_REQUEST_DELAY 3000
@@ -1711,24 +2853,78 @@ void updateRadio(unsigned long aNow) {
   static boolean isCmdCycleAnswerReceived = true;
   uint8_t id=0;
 
-  // first try to read all data comming from radio peer
-  while (ourRadio.available()) {          
-    ourRemoteCmd.write(ourRadio.read());
+  // while the channel survey is running, the radio is not listening on the working channel
+  if (updateChannelSurvey(aNow)) {
+    return;
+  }
+  updateRadioFallback(aNow);
+
+  ourRadioTxQueue.update();
+
+  // first try to read all data comming from radio peers, each pipe has its own frame buffer
+  RFTransceiver::RxPacket packet;
+  ourPerfProbes.start(ourProbeRadioRx);
+  while (ourRadio.receive(&packet)) {
+    #ifdef PIN_RF24_IRQ
+    if (ourRadioIrqRing.available()) {
+      packet.timestampUs = getCapturedTimestamp(&ourRadioIrqRing, true);
+    }
+    #endif
+    if (packet.pipe < RF24_STATS_PIPES) {
+      ourRxCmds[packet.pipe].write(packet.data, packet.len, packet.timestampUs);
+    } else {
+      logMsg(LOG_MOD_RADIO, ERROR, String(F("data from unexpected pipe: ")) + String(packet.pipe));
+    }
+  }
+  ourPerfProbes.stop(ourProbeRadioRx);
+
+  // handle one frame per loop, the pipes of the A-/B-Line first
+  F3XRemoteCommand* rxCmd = nullptr;
+  uint8_t rxCourse = 0;
+  for (uint8_t i=0; i<RF24_STATS_PIPES && rxCmd == nullptr; i++) {
+    if (ourRxCmds[i].available()) {
+      rxCmd = &ourRxCmds[i];
+      rxCourse = ourPipeCourse[i];
+    }
   }
+  // time stamp of the received data, used for time critical signals
+  uint32_t rxTimestamp = rxCmd != nullptr ? rxCmd->getRxTimestamp() : 0;
   
-  // if data from remote side builds a complete command handle it
-  if (ourRemoteCmd.available()) {
-    String* arg = NULL;
+  // drop retransmitted frames, which are already handled
+  if (rxCmd != nullptr && 
+      !ourRxSeqFilter.accept(rxCmd->getDevice(), rxCmd->getSeq(), rxCmd->getTimestamp())) {
+    logEvent(LOG_MOD_RADIO, WARNING, LogFmtDuplicateFrame,
+      rxCmd->getDevice(), rxCmd->getSeq(), (uint8_t) rxCmd->getType());
+    rxCmd->consume();
+    rxCmd = nullptr;
+  }
 
+  // if data from remote side builds a complete command handle it
+  if (rxCmd != nullptr) {
     // here the received F3XRemoteCommand (from A-/B-Line) are dispatched and handled 
-    switch (ourRemoteCmd.getType()) {
+    switch (rxCmd->getType()) {
       case F3XRemoteCommandType::SignalA: 
         logMsg(LOG_MOD_WEB, INFO, F("Signal-A received"));
-        ourF3XGenericTask->signal(F3XFixedDistanceTask::SignalA);
+        if (rxCourse != 0) {
+          ourCourses[rxCourse].getActiveTask()->signal(F3XFixedDistanceTask::SignalA, rxTimestamp);
+          break;
+        }
+        signalLatencyStart(rxTimestamp);
+        ourF3XGenericTask->signal(F3XFixedDistanceTask::SignalA, rxTimestamp);
+        signalLatencyEnd();
         break;
       case F3XRemoteCommandType::SignalB:
-        logMsg(LOG_MOD_WEB, INFO, F("Signal-B received"));
-        ourF3XGenericTask->signal(F3XFixedDistanceTask::SignalB);
+        logMsg(LOG_MOD_WEB, INFO, String(F("Signal-B received #")) + String(rxCmd->getArg(0)));
+        if (rxCourse != 0) {
+          // the clock synchronization and the latency statistics are only done for the B-Line of course 0
+          ourCourses[rxCourse].getActiveTask()->signal(F3XFixedDistanceTask::SignalB, rxTimestamp);
+          break;
+        }
+        signalLatencyStart(rxTimestamp);
+        if (!signalAtSenderTime(F3XFixedDistanceTask::SignalB, rxCmd)) {
+          ourF3XGenericTask->signal(F3XFixedDistanceTask::SignalB, rxTimestamp);
+        }
+        signalLatencyEnd();
         switch(ourContext.get()) {
           case TC_F3FTaskMenu:
           case TC_F3BSpeedMenu:
@@ -1739,28 +2935,42 @@ void updateRadio(unsigned long aNow) {
         break;
       case F3XRemoteCommandType::CmdCycleTestAnswer:
         ourRadioCycleRecvCnt++;
-        arg = ourRemoteCmd.getArg();
-        ourRadioRoundtripIdx = arg->toInt();
+        ourRadioRoundtripIdx = rxCmd->getArg(0);
         if (ourRadioRoundtripIdx == ourRadioRequestArg) {
-          float rtt = millis() - ourRadioRequestTime;
+          unsigned long rxTime = millis() - (micros() - rxTimestamp)/1000;
+          float rtt = rxTime - ourRadioRequestTime;
           ourRadioRoundTripTime = rtt + 0.75f * (ourRadioRoundTripTime - rtt);
           isCmdCycleAnswerReceived = true;
+          if (rxCmd->getSeq() != F3X_RC_SEQ_NONE 
+              && rxCmd->getDevice() == RFTransceiver::F3XBLineController) {
+            // answer time stamp is the send time, arg 1 the processing time of the B-line controller
+            uint32_t answerTime = rxCmd->getTimestamp();
+            ourClockSyncB.addSample(ourRadioRequestTime, answerTime - rxCmd->getArg(1), answerTime, rxTime);
+            logMsg(LOG_MOD_RTEST, DEBUG, String(F("clock sync B offset/drift/rtt: ")) 
+              + String(ourClockSyncB.getOffset(rxTime), 1) + F("ms/") 
+              + String(ourClockSyncB.getDriftPpm(), 1) + F("ppm/") 
+              + String(ourClockSyncB.getRtt()) + F("ms"));
+          }
           logMsg(LOG_MOD_RTEST, INFO, String(F("CmdCycleTestAnswer received: ")) 
             + String(ourRadioRoundTripTime, 1) + "/" + String(rtt,1)
             + String(F(" #[")) + String(ourRadioRoundtripIdx)+ String(F("]")));
         } else {
-           logMsg(LOG_MOD_RTEST, WARNING, String(F("!!!! wrong CycleTest answer: ")) + *arg); 
+           logMsg(LOG_MOD_RTEST, WARNING, String(F("!!!! wrong CycleTest answer: ")) + String(ourRadioRoundtripIdx)); 
         }
         break;
       case F3XRemoteCommandType::BLineStateResp: {
-          ourBatteryBVoltageRaw = ourRemoteCmd.getArg()->toInt();;
+          if (rxCourse != 0) {
+            // only the answer to the confirmation of a radio switch, the battery is the one of course 0
+            break;
+          }
+          ourBatteryBVoltageRaw = rxCmd->getArg(0);
           float volt=(((float) ourBatteryBVoltageRaw)/1023.0)*5.0f*1000*1.012f;
           ourBatteryBVoltage = volt;
           logMsg(LOG_MOD_SIG, INFO, String(F("Battery B voltage: ")) + String(ourBatteryBVoltage) + F("mV"));
         }
         break;
       case F3XRemoteCommandType::RemoteSignalStateResp: {
-          ourBatteryRemoteSignalRaw = ourRemoteCmd.getArg()->toInt();;
+          ourBatteryRemoteSignalRaw = rxCmd->getArg(0);
           float volt=(((float) ourBatteryRemoteSignalRaw)/1023.0)*10.0f*1000*1.0f;
           logMsg(LOG_MOD_SIG, INFO, String(F("RemoteSignalBattery  voltage: ")) + String(ourBatteryRemoteSignalRaw) + String("/") + String(volt) + F("mV"));
         }
@@ -1769,50 +2979,34 @@ void updateRadio(unsigned long aNow) {
         logMsg(ERROR, F("unknow RTC data"));
         break;
     }
-    ourRemoteCmd.consume();
+    rxCmd->consume();
+  }
+
+  // round trip to synchronize the clock of the B-line controller, but only if task is not running
+  if (aNow > lastCmdCycleTestRequest && ourF3XGenericTask->getTaskState() == F3XFixedDistanceTask::TaskWaiting) {
+    lastCmdCycleTestRequest = aNow + (ourClockSyncB.isValid() ? CMD_CYCLE_REQUEST_DELAY_SYNCED : CMD_CYCLE_REQUEST_DELAY);
+    ourRadioRequestArg++;
+    ourRadioCycleSendCnt++;
+    isCmdCycleAnswerReceived = false;
+    ourRadioRequestTime = millis();
+    ourRadioTxQueue.send(ourRemoteCmd.createFrame(F3XRemoteCommandType::CmdCycleTestRequest, ourRadioRequestArg), 
+      0, RFTxQueue::PrioHousekeeping, 1, cycleTestRequestDone);
   }
 
   // sending a state request to remote controller, but only if task is not running
   if (aNow > lastBLineRequest && ourF3XGenericTask->getTaskState() == F3XFixedDistanceTask::TaskWaiting) {
     lastBLineRequest = aNow + B_LINE_REQUEST_DELAY;
-    unsigned long a = millis();
-    boolean sendSuccess = ourRadio.transmit(
-      ourRemoteCmd.createCommand(F3XRemoteCommandType::BLineStateReq, String(ourRadioRequestArg))->c_str(), 20);
-
-    uint16_t signalRoundTrip = millis() - a;
-
-    uint8_t lost=0;
-    if (!sendSuccess) {
-      logMsg(LOG_MOD_RADIO, INFO, String(F("sending TestRequest NOT successsfull. Retransmissions: ")) 
-        + String(ourRadio.getRetransmissionCount()) + String(F("/")) + String(signalRoundTrip) + String(F("ms")));
-      ourBuzzer.on(PinManager::SHORT);
-      lost=100;
-      signalRoundTrip = UINT16_MAX;
-      ourBatteryBVoltage = 0;
-    } else {
-      logMsg(LOG_MOD_RADIO, DEBUG, String(F("sending TestRequest successsfull. Retransmissions: ")) 
-        + String(ourRadio.getRetransmissionCount()) + String(F("/")) + String(signalRoundTrip) + String(F("ms")));
-    }
-
-    float quality = 100.0f - 100.0f * ourRadio.getRetransmissionCount()/20;
-    if (lost) {
-      quality=0.0f;
-      ourRadioStatePacketsMissed++;
-    }
-    ourRadioQuality = irr_low_pass_filter(ourRadioQuality, quality, 0.4f);
-    ourRadioSignalRoundTrip = irr_low_pass_filter(ourRadioSignalRoundTrip, signalRoundTrip, 0.4f);
-    logMsg(LOG_MOD_RADIO, INFO, F("radio quality: ") + String(quality, 0) + F("%/") + String(ourRadioQuality,0) + F("%"));
-
+    ourRadioTxQueue.send(ourRemoteCmd.createFrame(F3XRemoteCommandType::BLineStateReq, ourRadioRequestArg), 
+      0, RFTxQueue::PrioHousekeeping, 20, bLineStateReqDone);
 
     // request state infos from the remote radio signal device, but only while task is not running
     if (true) {
-      ourRadio.setWritingPipe(2);
-      ourRadio.transmit(ourRemoteCmd.createCommand(F3XRemoteCommandType::RemoteSignalStateReq, String(ourRadioRequestArg))->c_str(), 20);
-      ourRadio.setWritingPipe(0);
+      ourRadioTxQueue.send(ourRemoteCmd.createFrame(F3XRemoteCommandType::RemoteSignalStateReq, ourRadioRequestArg), 
+        2, RFTxQueue::PrioHousekeeping, 20);
     }
   }
 
-  if (ourRadioSendSettings && ourRadioQuality > 99.0f) {
+  if (ourRadioSendSettings && getRadioQuality() > 99.0f) {
     static uint8_t power = -1;
     String settings;
     // power / channel / rate / ack
@@ -1823,23 +3017,9 @@ void updateRadio(unsigned long aNow) {
        + String(ourRadioAck);
     // 1,83,0,1;
     
-    if (ourRadio.transmit(ourRemoteCmd.createCommand(F3XRemoteCommandType::CmdSetRadio, settings)->c_str(), 20) ) {
-      // changed radio settings are successfully transmitted to B-Line, now the BaseManager can also be switched
-      ourRadio.setWritingPipe(2);
-      ourRadio.transmit(ourRemoteCmd.createCommand(F3XRemoteCommandType::CmdSetRadio, settings)->c_str(), 20);
-      ourRadio.setWritingPipe(0);
-      ourRadio.setPower(ourRadioPower);
-      ourRadio.setChannel(ourRadioChannel);
-      ourRadio.setDataRate(ourRadioDatarate);
-      ourRadio.setAck(ourRadioAck);
-
-      // set the new radio settings to the configuration data, which can be stored in the EEPROM later on
-      ourConfig.radioChannel = ourRadioChannel;
-      ourConfig.radioPower = ourRadioPower;
-      LOGGY3(LOG_MOD_RADIO, INFO, F("send radio setting to remote and set local") + settings);
-    } else {
-      logMsg(LOG_MOD_RADIO, ERROR, String(F("sending settings not possible: ") + settings));
-    }
+    ourRadioTxQueue.send(ourRemoteCmd.createFrame(F3XRemoteCommandType::CmdSetRadio, 
+      ourRadioPower, ourRadioChannel, ourRadioDatarate, ourRadioAck), 0, RFTxQueue::PrioCommand, 20, setRadioBLineDone);
+    LOGGY3(LOG_MOD_RADIO, INFO, F("send radio setting to remote: ") + settings);
     ourRadioSendSettings=false;
   }
 }
@@ -1967,6 +3147,37 @@ void showRadioPowerPage() {
   ourOLED.setDrawColor(1);
 }
 
+/**
+ * best and average course time and the trend of the session in one line
+ */
+void showSessionStatistics(F3XRunStatistics* aStats, uint8_t aY) {
+  if (aStats->getCount() == 0) {
+    return;
+  }
+  ourOLED.setFont(oledFontNormal);
+  ourOLED.setCursor(0, aY);
+  ourOLED.print(F("Best "));
+  ourOLED.print(getSCTimeStr(aStats->getBestCourseTime()));
+  ourOLED.print(F(" Avg "));
+  ourOLED.print(getSCTimeStr(aStats->getAvgCourseTime()));
+  ourOLED.print(aStats->getTrendChar());
+}
+
+/**
+ * the round and the pilot of the next run, if a roster is used
+ */
+void showCurrentPilot(uint8_t aY) {
+  if (!ourPilotRoster.isActive()) {
+    return;
+  }
+  ourOLED.setFont(oledFontNormal);
+  ourOLED.setCursor(0, aY);
+  ourOLED.print(F("R"));
+  ourOLED.print(ourPilotRoster.getRound());
+  ourOLED.print(F(" "));
+  ourOLED.print(ourPilotRoster.getName(ourPilotRoster.getCurrentPilot()));
+}
+
 void showInfoPage() {
   ourOLED.setFont(oledFontLarge);
 
@@ -1998,6 +3209,31 @@ void showInfoPage() {
   ourOLED.print(F(" (c)'23 R.Stransky"));
 }
 
+/**
+ * the probes as p99/max in ms, a page of probes after the other
+ */
+void showPerfInfoPage(unsigned long aNow) {
+  #define PERF_PAGE_LINES      5
+  #define PERF_PAGE_DURATION 3000
+  ourOLED.setFont(oledFontNormal);
+  uint8_t pages = (ourPerfProbes.getCount() + PERF_PAGE_LINES - 1) / PERF_PAGE_LINES;
+  uint8_t page = pages == 0 ? 0 : (aNow / PERF_PAGE_DURATION) % pages;
+  ourOLED.setCursor(0, 10);
+  ourOLED.print((String(F("Perf p99/max ms ")) + String(page+1) + F("/") + String(pages)).c_str());
+  ourOLED.setFont(oledFontSmall);
+  for (uint8_t i=0; i<PERF_PAGE_LINES; i++) {
+    uint8_t id = page * PERF_PAGE_LINES + i;
+    if (id >= ourPerfProbes.getCount()) {
+      break;
+    }
+    LatencyHistogram* hist = ourPerfProbes.getHistogram(id);
+    ourOLED.setCursor(0, 22 + i*10);
+    ourOLED.print(ourPerfProbes.getName(id));
+    ourOLED.setCursor(64, 22 + i*10);
+    ourOLED.print((String(hist->getPercentile(99)/1000.0f, 1) + F("/") + String(hist->getMax()/1000.0f, 1)).c_str());
+  }
+}
+
 void showRadioInfoPage() {
   ourOLED.setFont(oledFontLarge);
 
@@ -2006,13 +3242,17 @@ void showRadioInfoPage() {
 
   ourOLED.setCursor(5, 28);
   ourOLED.setFont(oledFontNormal);
+  F3XLinkQuality* link = ourRadioTxQueue.getLinkQuality(0);
   ourOLED.print(F("Quality:"));
-  ourOLED.print(String(ourRadioQuality, 0).c_str());
-  ourOLED.print(F(", mpkts:"));
-  ourOLED.print(String(ourRadioStatePacketsMissed).c_str());
+  ourOLED.print(String(link->getQuality(), 0).c_str());
+  ourOLED.print(link->getTrendChar());
+  ourOLED.print(F(" PER:"));
+  ourOLED.print((String(link->getPacketErrorRate(), 0) + F("%")).c_str());
   ourOLED.setCursor(5, 40);
-  ourOLED.print(F("RoundTrip: "));
+  ourOLED.print(F("RT: "));
   ourOLED.print((String(ourRadioSignalRoundTrip)+String(F("ms"))).c_str());
+  ourOLED.print(F(" ARC:"));
+  ourOLED.print(String(link->getMeanArc(), 1).c_str());
   ourOLED.setCursor(5, 52);
   ourOLED.print(F("Radio (p/c):"));
   ourOLED.setCursor(5, 64);
@@ -2191,7 +3431,7 @@ void showF3FTask() {
     ourOLED.print(stateInfo);
     ourOLED.print(F("]"));
     
-    switch (ourF3FTask.getTaskState()) {
+    switch (ourCourses[0].getTask(F3XFixedDistanceTask::F3FType)->getTaskState()) {
       // case F3XFixedDistanceTask::TaskWaiting:
       case F3XFixedDistanceTask::TaskRunning:
         ourOLED.setFont(oledFontNormal);
@@ -2203,7 +3443,9 @@ void showF3FTask() {
         ourOLED.print(F3XFixedDistanceTask::getHMSTimeStr(ourF3XGenericTask->getInAirTime(), true));
         {
           int8_t numLegs = ourF3XGenericTask->getSignalledLegCount();
-          if (numLegs > 0 ) {
+          if (numLegs <= 0) {
+            showCurrentPilot(47);
+          } else {
             ourOLED.setCursor(20, 47);
             F3XLeg leg = ourF3XGenericTask->getLeg(numLegs-1);
             ourOLED.print(String(numLegs).c_str());
@@ -2256,6 +3498,10 @@ void showF3FTask() {
         ourOLED.setFont(oledFontBig);
         ourOLED.setCursor(0, 27);
         ourOLED.print(msgStr);
+        if (ourCourses[0].getTask(F3XFixedDistanceTask::F3FType)->getTaskState() == F3XFixedDistanceTask::TaskWaiting) {
+          showCurrentPilot(42);
+          showSessionStatistics(ourCourses[0].getStats(F3XFixedDistanceTask::F3FType, true), 54);
+        }
         break;
     }
   // }
@@ -2354,12 +3600,19 @@ void showF3BSpeedTask() {
         ourOLED.setFont(oledFontBig);
         ourOLED.setCursor(0, 27);
         ourOLED.print(msgStr);
+        if (ourF3XGenericTask->getTaskState() == F3XFixedDistanceTask::TaskWaiting) {
+          showCurrentPilot(42);
+          showSessionStatistics(ourCourses[0].getStats(F3XFixedDistanceTask::F3BSpeedType, true), 54);
+        }
         break;
       case F3XFixedDistanceTask::TaskRunning:
         ourOLED.setFont(oledFontNormal);
         ourOLED.setCursor(10, 27);
         ourOLED.print(F("Task Time: "));
         ourOLED.print(F3XFixedDistanceTask::getHMSTimeStr(ourF3XGenericTask->getRemainingTasktime(), true));
+        if (ourF3XGenericTask->getSignalledLegCount() < F3X_COURSE_STARTED) {
+          showCurrentPilot(40);
+        }
 
         {
           unsigned long lastcourseTime = ourF3XGenericTask->getLastLoopTaskCourseTime();
@@ -2397,20 +3650,6 @@ void showF3BSpeedTask() {
 }
 
 void updateOLED(unsigned long aNow) {
-  updateOLED(aNow, false);
-}
-
-void updateOLED(unsigned long aNow, bool aForce) {
-  static unsigned long last=0;
-  #define OLED_REFRESH_CYCLE 250
-
-
-  if (aNow < last && !aForce) {
-    return;
-  }
-
-  last = aNow + OLED_REFRESH_CYCLE;
-  
 #ifdef OLED_FULL_BUFFER
   ourOLED.clearBuffer();
 #else
@@ -2449,6 +3688,9 @@ void updateOLED(unsigned long aNow, bool aForce) {
         case TC_F3XRadioInfo:
           showRadioInfoPage();
           break;
+        case TC_F3XPerfInfo:
+          showPerfInfoPage(aNow);
+          break;
         case TC_F3XBaseMenu:
           showOLEDMenu(ourF3XBaseMenuItems, ourF3XBaseMenuSize, ourF3XBaseMenuName);
           break;
@@ -2470,12 +3712,26 @@ void updateOLED(unsigned long aNow, bool aForce) {
       }
     }
 #ifdef OLED_FULL_BUFFER
-  ourOLED.sendBuffer();
+  // sent row by row by updateOLEDTransfer()
+  ourDisplayDiff.requestFrame(&ourOLED);
 #else
   } while ( ourOLED.nextPage() );
 #endif
 }
 
+#ifdef OLED_FULL_BUFFER
+/**
+ * send one tile row of the last drawn frame per loop, the signals are handled between two rows
+ */
+void updateOLEDTransfer(unsigned long aNow) {
+  if (!ourDisplayDiff.isPending()) {
+    return;
+  }
+  ourPerfProbes.start(ourProbeOledSend);
+  ourDisplayDiff.sendRow(&ourOLED);
+  ourPerfProbes.stop(ourProbeOledSend);
+}
+#endif
 
 void forceOLED(uint8_t aLevel, String aMessage) {
   String head;
@@ -2501,6 +3757,7 @@ void forceOLED(String aHead, String aMessage) {
     showMessage(aHead, aMessage);
 #ifdef OLED_FULL_BUFFER
   ourOLED.sendBuffer();
+  ourDisplayDiff.invalidate();
 #else
   } while ( ourOLED.nextPage() );
 #endif
@@ -2515,9 +3772,6 @@ void  setupBatteryIn() {
 }     
 
 void updateBatterySupervision(unsigned long aNow) {
-  static unsigned long next = 0;
-  #define BAT_IN_CYCLE 10000
-  #
   // 1024÷1024×3290×47÷(100+47) = 10519
   // 3.9 gemessen / 3.8 angezeigt = 1.026 
   // 10519 * 1.026 = 10796
@@ -2525,55 +3779,88 @@ void updateBatterySupervision(unsigned long aNow) {
   #define V_REF 10796
   
   // 3920mV 
-  if (aNow > next) {
-    next = aNow + BAT_IN_CYCLE;
-    uint16_t raw = analogRead(PIN_BATTERY_IN);
-    // Wemos D1  can read 3.2V on analog in
-    // 3V3 = 3290mV
-    float volt=(((float) raw)/1023.0)*4.12f;
-    ourBatteryAVoltage = volt*1000;  // convert to milli volt
-    logMsg(LOG_MOD_BAT, INFO, String(F("battery A voltage: ")) + String(volt, 2) + F("V | sensor-value: ") + String(raw));
-
-
-    bool battWarn = false;
-    // check battery level and warn if low
-    #define BAT_WARN_LEVEL 3200 // mV
-    if(ourBatteryBVoltage > 500 && ourBatteryBVoltage < BAT_WARN_LEVEL) {
-      logMsg(LOG_MOD_BAT, WARNING, F("Battery B: ") + String(ourBatteryBVoltage) + String(F("mV")));
-      battWarn = true;
-    }
-    if(ourBatteryAVoltage > 500 && ourBatteryAVoltage < BAT_WARN_LEVEL) {
-      logMsg(LOG_MOD_BAT, WARNING, F("Battery A: ") + String(ourBatteryAVoltage) + String(F("mV")));
-      battWarn = true;
-    }
-    if (battWarn && ourF3XGenericTask->getTaskState() == F3XFixedDistanceTask::TaskWaiting) {
-      ourBuzzer.pattern(5,50,100,50,100,50);
-    }
+  uint16_t raw = analogRead(PIN_BATTERY_IN);
+  // Wemos D1  can read 3.2V on analog in
+  // 3V3 = 3290mV
+  float volt=(((float) raw)/1023.0)*4.12f;
+  ourBatteryAVoltage = volt*1000;  // convert to milli volt
+  logMsg(LOG_MOD_BAT, INFO, String(F("battery A voltage: ")) + String(volt, 2) + F("V | sensor-value: ") + String(raw));
+
+
+  bool battWarn = false;
+  // check battery level and warn if low
+  #define BAT_WARN_LEVEL 3200 // mV
+  if(ourBatteryBVoltage > 500 && ourBatteryBVoltage < BAT_WARN_LEVEL) {
+    logMsg(LOG_MOD_BAT, WARNING, F("Battery B: ") + String(ourBatteryBVoltage) + String(F("mV")));
+    battWarn = true;
+  }
+  if(ourBatteryAVoltage > 500 && ourBatteryAVoltage < BAT_WARN_LEVEL) {
+    logMsg(LOG_MOD_BAT, WARNING, F("Battery A: ") + String(ourBatteryAVoltage) + String(F("mV")));
+    battWarn = true;
+  }
+  if (battWarn && ourF3XGenericTask->getTaskState() == F3XFixedDistanceTask::TaskWaiting) {
+    ourBuzzer.pattern(5,50,100,50,100,50);
   }
 }
 #endif
 
-void perfCheck(void (*aExecute)(unsigned long), const char* aDescription, unsigned long aNow) {
-  #ifdef PERF_DEBUG
-  unsigned long start = millis();
-  #endif
-  // logMsg(LOG_MOD_PERF, DEBUG, String(F("execute ")) + aDescription);
-  aExecute(aNow);
-  #ifdef PERF_DEBUG
-  if ((millis() - start) > 100) {
-    logMsg(LOG_MOD_PERF, DEBUG, String(F("performance info for ")) + aDescription + F(":") + String(millis()-start));
+/**
+ * write the snapshotted runs to flash, while no course is flown and no signal is pending
+ */
+void updateRunWriteQueue(unsigned long aNow) {
+  boolean idle = !isSignalPending();
+  for (uint8_t i=0; i<F3X_COURSES_MAX && idle; i++) {
+    idle = !ourCourses[i].isCourseFlown();
+  }
+  if (ourRunWriteQueue.update(idle) == false && idle) {
+    ourPilotRoster.save();
   }
-  #endif
 }
 
 void updateF3XTask(unsigned long aNow) {
-  if (ourF3XGenericTask != nullptr) {
-    ourF3XGenericTask->update();
+  for (uint8_t i=0; i<F3X_COURSES_MAX; i++) {
+    ourCourses[i].update();
+  }
+}
+
+/**
+ * returns true, if a signal (A-Line button or radio frame) is waiting to be handled,
+ * the web server yields to it. Captured A-Line edges older than SIGNAL_MAX_AGE_US are no
+ * longer pending, no press takes them (e.g. a glitch shorter than the debounce interval).
+ */
+boolean isSignalPending() {
+  #ifdef PIN_RF24_IRQ
+  if (ourRadioIrqRing.available()) {
+    return true;
+  }
+  #endif
+  uint32_t stamp;
+  while (ourSignalARing.peek(&stamp) && (micros() - stamp) >= SIGNAL_MAX_AGE_US) {
+    ourSignalARing.pop(&stamp);
   }
+  return ourSignalARing.available();
 }
 
+/**
+ * the web server gets a time slice per loop: pending file transfers are continued within the
+ * budget and a new request is only accepted, if no signal is pending
+ */
 void updateWebServer(unsigned long aNow) {
-  ourWebServer.handleClient();
+  uint32_t start = micros();
+  uint32_t budget = ourIsTimeCriticalOperationRunning ? WEB_SLICE_BUDGET_CRITICAL_US : WEB_SLICE_BUDGET_US;
+  ourWebFiles.update(budget, isSignalPending);
+  if (!isSignalPending() && (micros() - start) < budget) {
+    ourWebServer.handleClient();
+  }
+  ourWebSliceLat.record(micros() - start);
+}
+
+/**
+ * return the web server time slice as p50/p99/max in ms and the active/aborted file transfers
+ */
+String getWebSliceInfo() {
+  return getLatencyStr(&ourWebSliceLat) + F(" (") + String(ourWebFiles.getActiveCount()) 
+    + F("/") + String(ourWebFiles.getAbortCount()) + F(")");
 }
 
 void updatePushButton(unsigned long aNow) {
@@ -2590,8 +3877,16 @@ void updatePushButton(unsigned long aNow) {
 
 
   boolean wasPressed=ourPushButton.pressed();
+  uint32_t pressedTimestamp = 0;
+  if (ourPushButton.released()) {
+    // the falling edges of the release bounce are captured by the ISR too, they are no press
+    uint32_t stamp;
+    while (ourSignalARing.pop(&stamp)) {
+    }
+  }
   // save the push button history
   if (wasPressed) {
+    pressedTimestamp = getCapturedTimestamp(&ourSignalARing);
     for (int i=4; i>0; i--) {
       history[i] = history[i-1];
     }
@@ -2639,7 +3934,9 @@ void updatePushButton(unsigned long aNow) {
             MULTI_PRESSED_FINISHED;
             break;
           case F3XFixedDistanceTask::TaskRunning:
-            ourF3XGenericTask->signal(F3XFixedDistanceTask::SignalA);
+            signalLatencyStart(pressedTimestamp);
+            ourF3XGenericTask->signal(F3XFixedDistanceTask::SignalA, pressedTimestamp);
+            signalLatencyEnd();
             break;
           default:
             break;
@@ -2648,6 +3945,7 @@ void updatePushButton(unsigned long aNow) {
       case TC_F3XMessage: // button press
       case TC_F3XInfo: // button press
       case TC_F3XRadioInfo: // button press
+      case TC_F3XPerfInfo: // button press
         logMsg(DEBUG, F("HW button in: ") + String(ourContext.get()));
         ourBuzzer.on(PinManager::SHORT); 
         ourContext.back();
@@ -2663,7 +3961,7 @@ void updatePushButton(unsigned long aNow) {
         CLEAR_HISTORY;
       case TC_F3BSpeedTasktimeCfg: // button press in F3B speed task time context
         logMsg(LOG_MOD_RADIO, INFO, F("set F3B speed tasktime :") + String(ourConfig.f3bSpeedTasktime));
-        ourF3BSpeedTask.setTasktime(ourConfig.f3bSpeedTasktime);
+        applyTaskSettings();
         ourContext.set(TC_F3XSettingsMenu);
         #ifdef USE_RXTX_AS_GPIO
         resetRotaryEncoder(0);
@@ -2672,7 +3970,7 @@ void updatePushButton(unsigned long aNow) {
         break;
       case TC_F3FLegLengthCfg: // button press in F3B speed task time context
         logMsg(LOG_MOD_TASK, INFO, F("set F3F leg length :") + String(ourConfig.f3fLegLength));
-        ourF3FTask.setLegLength(ourConfig.f3fLegLength);
+        applyTaskSettings();
         ourContext.set(TC_F3XSettingsMenu);
         #ifdef USE_RXTX_AS_GPIO
         resetRotaryEncoder(0);
@@ -2681,7 +3979,7 @@ void updatePushButton(unsigned long aNow) {
         break;
       case TC_F3FTasktimeCfg: // button press in F3B speed task time context
         logMsg(LOG_MOD_TASK, INFO, F("set F3F tasktime :") + String(ourConfig.f3fTasktime));
-        ourF3FTask.setTasktime(ourConfig.f3fTasktime);
+        applyTaskSettings();
         ourContext.set(TC_F3XSettingsMenu);
         #ifdef USE_RXTX_AS_GPIO
         resetRotaryEncoder(0);
@@ -2742,6 +4040,12 @@ void updatePushButton(unsigned long aNow) {
               #endif
               CLEAR_HISTORY;
               break;
+            case 5: // "5:Perf-Info";
+              ourBuzzer.on(PinManager::SHORT); 
+              logMsg(INFO, F("setting task: F3XPerfInfo"));
+              ourContext.set(TC_F3XPerfInfo);
+              CLEAR_HISTORY;
+              break;
           }
         }
         break;
@@ -2799,7 +4103,7 @@ void updatePushButton(unsigned long aNow) {
             CLEAR_HISTORY;
             break;
           case 2: // "2:Back"
-            ourF3FTask.stop();
+            ourCourses[0].getTask(F3XFixedDistanceTask::F3FType)->stop();
             #ifdef USE_RXTX_AS_GPIO
             resetRotaryEncoder(0);
             #endif
@@ -2870,7 +4174,7 @@ void updatePushButton(unsigned long aNow) {
             break;
           case 5: // "5:Radio channel";
             ourBuzzer.on(PinManager::SHORT);
-            if (!ourRadioSendSettings || ourRadioQuality > 99.0f) {
+            if (!ourRadioSendSettings || getRadioQuality() > 99.0f) {
               ourContext.set(TC_F3XRadioChannelCfg);
               ourRadioChannel = ourRadio.getChannel();
               #ifdef USE_RXTX_AS_GPIO
@@ -2883,7 +4187,7 @@ void updatePushButton(unsigned long aNow) {
             break;
           case 6: // "6:Radio power";
             ourBuzzer.on(PinManager::SHORT);
-            if (!ourRadioSendSettings || ourRadioQuality > 99.0f) {
+            if (!ourRadioSendSettings || getRadioQuality() > 99.0f) {
               ourContext.set(TC_F3XRadioPowerCfg);
               ourRadioPower=ourRadio.getPower();
               #ifdef USE_RXTX_AS_GPIO
@@ -2898,6 +4202,9 @@ void updatePushButton(unsigned long aNow) {
             ourBuzzer.on(PinManager::SHORT);
             ourConfig.oledFlipped = ourConfig.oledFlipped == true? false: true;
             ourOLED.setFlipMode(ourConfig.oledFlipped);
+            #ifdef OLED_FULL_BUFFER
+            ourDisplayDiff.invalidate();
+            #endif
             break;
           case 8: // "8:Rotary button inv.";
             ourBuzzer.on(PinManager::SHORT);
@@ -2987,6 +4294,7 @@ void updatePushButton(unsigned long aNow) {
 void updateTimedEvents(unsigned long aNow) {
   if (ourTimedReset != 0 && aNow > ourTimedReset) {
     ourTimedReset = 0;
+    ourRadioTxQueue.flush(RADIO_FLUSH_TIMEOUT);
     ESP.restart();
   } 
 }
@@ -3115,69 +4423,54 @@ void updateRotaryEncoder(unsigned long aNow) {
 #endif
 
 void setActiveTask(F3XFixedDistanceTask::F3XType aType) {
-  if (aType == F3XFixedDistanceTask::F3BSpeedType) {
-    if (ourF3XGenericTask == nullptr) {
-      ourF3XGenericTask = &ourF3BSpeedTask;
-    } else {
-      if (ourF3XGenericTask->getType() != F3XFixedDistanceTask::F3BSpeedType) {
-        ourF3XGenericTask->stop();
-        ourF3XGenericTask = &ourF3BSpeedTask;
-      }
-    }
-  } else 
-  if (aType == F3XFixedDistanceTask::F3FType) {
-    if (ourF3XGenericTask == nullptr) {
-      ourF3XGenericTask = &ourF3FTask;
-    } else {
-      if (ourF3XGenericTask->getType() != F3XFixedDistanceTask::F3FType) {
-        ourF3XGenericTask->stop();
-        ourF3XGenericTask = &ourF3FTask;
-      }
-    }
+  if (aType == F3XFixedDistanceTask::F3BSpeedType || aType == F3XFixedDistanceTask::F3FType) {
+    ourCourses[0].setActiveTask(aType);
+    ourF3XGenericTask = ourCourses[0].getActiveTask();
   } else {
     logMsg(LOG_MOD_TASK, ERROR, String("illegeal F3XType:") + String(aType));
   }
 }
 
-void loop()
-{
-  static unsigned long next = 0;
-  static unsigned long lastslow = 0;
-  unsigned long now = millis();
-
-  #ifdef PERF_DEBUG
-  unsigned long lnow;
-  boolean isSlow = false;
-  if ((now - lastslow) > 200) {
-    logMsg(LOG_MOD_PERF, WARNING, String(F("slow last loop:")) + String(now-lastslow));
-    isSlow = true;
-  }
-  lastslow = now;
+/**
+ * the tasks of the loop, the signal handling first, see F3XScheduler
+ */
+void setupScheduler() {
+  ourScheduler.setPreemptCheck(isSignalPending);
+  ourScheduler.add("button", updatePushButton, F3XScheduler::PrioCritical, 0, 500);
+  ourScheduler.add("radio", updateRadio, F3XScheduler::PrioCritical, 0, 3000);
+  ourScheduler.add("task", updateF3XTask, F3XScheduler::PrioCritical, 0, 500);
+  ourScheduler.add("buzzer", updateBuzzer, F3XScheduler::PrioHigh, 0, 200);
+  #ifdef USE_RXTX_AS_GPIO
+  ourScheduler.add("encoder", updateRotaryEncoder, F3XScheduler::PrioHigh, 0, 500);
   #endif
-
-  perfCheck(&updatePushButton, "time push button", now);
-
-  perfCheck(&updateBuzzer, "time buzzer", now);
-
-  perfCheck(&updateF3XTask, "time speedtask", now);
-
-  perfCheck(&updateRadio, "time radio", now);
-
-  perfCheck(&updateWebServer, "time webserver", now);
-
-  perfCheck(&updateBatterySupervision, "time battery supervision", now);
-
-  perfCheck(&updateTimedEvents, "time timedEvents", now);
-  
-  #ifdef OLED 
-  perfCheck(&updateOLED, "time oled display", now);
+  ourScheduler.add("web", updateWebServer, F3XScheduler::PrioNormal, 0, WEB_SLICE_BUDGET_US);
+  ourScheduler.add("events", updateWebEvents, F3XScheduler::PrioNormal, 0, 2000);
+  ourScheduler.add("runs", updateRunWriteQueue, F3XScheduler::PrioNormal, 0, 10000);
+  ourScheduler.add("network", updateNetwork, F3XScheduler::PrioNormal, 0, 2000);
+  #ifdef OLED
+  #ifdef OLED_FULL_BUFFER
+  ourScheduler.add("oled", updateOLED, F3XScheduler::PrioLow, OLED_REFRESH_CYCLE, 10000);
+  ourScheduler.add("oled tx", updateOLEDTransfer, F3XScheduler::PrioLow, 0, 4000);
+  #else
+  ourScheduler.add("oled", updateOLED, F3XScheduler::PrioLow, OLED_REFRESH_CYCLE, 30000);
   #endif
-
-  #ifdef USE_RXTX_AS_GPIO
-  perfCheck(&updateRotaryEncoder, "time rotary encoder", now);
   #endif
+  #ifdef USE_BATTERY_IN_VOLTAGE
+  ourScheduler.add("battery", updateBatterySupervision, F3XScheduler::PrioLow, BAT_IN_CYCLE, 1000);
+  #endif
+  ourScheduler.add("timed", updateTimedEvents, F3XScheduler::PrioLow, 100, 100);
+  ourScheduler.add("second", updateSecond, F3XScheduler::PrioLow, 1000, 100);
+  ourScheduler.add("log", updateLog, F3XScheduler::PrioLow, 0, 5000);
+}
 
+/**
+ * print the recorded log messages in the idle time of the loop
+ */
+void updateLog(unsigned long aNow) {
+  Logger::getInstance().flush();
+}
 
+void updateNetwork(unsigned long aNow) {
   if (WiFi.status() == WL_CONNECTED) {
     #ifdef OTA
     ArduinoOTA.handle();
@@ -3186,15 +4479,16 @@ void loop()
     MDNS.update();
     #endif
   }
+}
 
-  if (now >= next) {
-    ourSecond++;
-    next = now + 1000;
-  } else {
-    return;
-  }
-
+void updateSecond(unsigned long aNow) {
+  ourSecond++;
   if (ourSecond > 5) {
     ourStartupPhase = false;
   }
 }
+
+void loop()
+{
+  ourScheduler.run(millis());
+}
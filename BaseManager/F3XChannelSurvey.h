@@ -0,0 +1,141 @@
+#ifndef F3XChannelSurvey_h
+#define F3XChannelSurvey_h
+
+#include <Arduino.h>
+#include <RFTransceiver.h>
+
+#define F3X_SURVEY_SWEEPS      20  // measurements per channel
+#define F3X_SURVEY_MIN_GAIN     8  // score difference needed to leave the current channel
+
+/**
+ * survey of the 2.4GHz band by the received power detector (RPD, > -64dBm) of the nRF24L01.
+ * One channel is measured per update() (< 1ms), so the loop is not blocked. While the survey is
+ * running the radio can not receive on the working channel, the channel is restored when done.
+ * Channels are ranked by a score of the own and the neighbour channels hits.
+ */
+class F3XChannelSurvey {
+  public:
+    typedef enum State {
+      SurveyIdle = 0,
+      SurveyRunning,
+      SurveyDone,
+    } State;
+
+    F3XChannelSurvey(RFTransceiver* aRadio) {
+      myRadio = aRadio;
+      myState = SurveyIdle;
+      myWorkingChannel = 0;
+      myChannel = 0;
+      mySweep = 0;
+      memset(myHits, 0, sizeof(myHits));
+    }
+
+    void start() {
+      memset(myHits, 0, sizeof(myHits));
+      myWorkingChannel = myRadio->getChannel();
+      myChannel = 0;
+      mySweep = 0;
+      myState = SurveyRunning;
+    }
+
+    /**
+     * abort a running survey and restore the working channel
+     */
+    void abort() {
+      if (myState == SurveyRunning) {
+        myRadio->restoreChannel(myWorkingChannel);
+        myState = SurveyIdle;
+      }
+    }
+
+    /**
+     * measure the next channel, returns true, if the survey is finished with this call
+     */
+    boolean update() {
+      if (myState != SurveyRunning) {
+        return false;
+      }
+      if (myRadio->testChannel(myChannel) && myHits[myChannel] < UINT8_MAX) {
+        myHits[myChannel]++;
+      }
+      if (++myChannel >= RF24_1MHZ_CHANNEL_NUM) {
+        myChannel = 0;
+        if (++mySweep >= F3X_SURVEY_SWEEPS) {
+          myRadio->restoreChannel(myWorkingChannel);
+          myState = SurveyDone;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    State getState() {
+      return myState;
+    }
+
+    /**
+     * score of a channel, the lower the better
+     */
+    uint16_t getScore(uint8_t aChannel) {
+      uint16_t score = 4 * myHits[aChannel];
+      for (int8_t d=1; d<=2; d++) {
+        uint8_t weight = 3 - d;
+        if (aChannel >= d) {
+          score += weight * myHits[aChannel-d];
+        }
+        if (aChannel + d < RF24_1MHZ_CHANNEL_NUM) {
+          score += weight * myHits[aChannel+d];
+        }
+      }
+      return score;
+    }
+
+    /**
+     * channel with the lowest score, the working channel is preferred on equal scores
+     */
+    uint8_t getBestChannel() {
+      uint8_t best = myWorkingChannel;
+      uint16_t bestScore = getScore(best);
+      for (uint8_t c=0; c<RF24_1MHZ_CHANNEL_NUM; c++) {
+        uint16_t score = getScore(c);
+        if (score < bestScore) {
+          best = c;
+          bestScore = score;
+        }
+      }
+      return best;
+    }
+
+    /**
+     * returns the best channel, if it is significantly better than the working channel,
+     * otherwise the working channel
+     */
+    uint8_t getRecommendedChannel() {
+      uint8_t best = getBestChannel();
+      if (getScore(best) + F3X_SURVEY_MIN_GAIN <= getScore(myWorkingChannel)) {
+        return best;
+      }
+      return myWorkingChannel;
+    }
+
+    uint8_t getWorkingChannel() {
+      return myWorkingChannel;
+    }
+
+    /**
+     * progress of the survey in percent
+     */
+    uint8_t getProgress() {
+      return ((uint16_t) mySweep * 100) / F3X_SURVEY_SWEEPS;
+    }
+
+  private:
+    RFTransceiver* myRadio;
+    State myState;
+    uint8_t myHits[RF24_1MHZ_CHANNEL_NUM];
+    uint8_t myWorkingChannel;
+    uint8_t myChannel;
+    uint8_t mySweep;
+};
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef F3XClockSync_h
+#define F3XClockSync_h
+
+#include <Arduino.h>
+
+#define F3X_CLOCK_SYNC_SAMPLES        8   // round trips, of which the one with minimal RTT is used
+#define F3X_CLOCK_SYNC_MAX_RTT       40   // ms, samples with a larger RTT (many RF retries) are ignored
+#define F3X_CLOCK_SYNC_DRIFT_MIN_MS 10000 // min. distance of two reference samples for the drift estimation
+#define F3X_CLOCK_SYNC_DRIFT_MAX   0.001f // 1000ppm, larger drift estimations are implausible
+
+/**
+ * NTP like estimation of the clock offset (and drift) of a remote device (millis() of a line
+ * controller) to the local millis() clock.
+ * Each round trip delivers the 4 time stamps:
+ *   aT0: local time, request sent      aT1: remote time, request received
+ *   aT2: remote time, answer sent      aT3: local time, answer received
+ * offset = ((aT1-aT0) + (aT2-aT3)) / 2, error <= RTT/2 with RTT = (aT3-aT0) - (aT2-aT1)
+ * RF retransmissions only increase the RTT of a sample, so of the last samples only
+ * the one with the smallest RTT is used and the accuracy does not degrade under RF retries.
+ */
+class F3XClockSync {
+  public:
+    F3XClockSync() {
+      reset();
+    }
+
+    void reset() {
+      mySampleCnt = 0;
+      mySampleIdx = 0;
+      myValid = false;
+      myDrift = 0.0f;
+      myRefOffset = 0.0f;
+      myRefTime = 0;
+      myRefRtt = UINT16_MAX;
+      myDriftRefOffset = 0.0f;
+      myDriftRefTime = 0;
+    }
+
+    void addSample(uint32_t aT0, uint32_t aT1, uint32_t aT2, uint32_t aT3) {
+      int32_t rtt = (int32_t) (aT3 - aT0) - (int32_t) (aT2 - aT1);
+      if (rtt < 0 || rtt > F3X_CLOCK_SYNC_MAX_RTT) {
+        return;
+      }
+      Sample* s = &mySamples[mySampleIdx];
+      s->offset = ((float) (int32_t) (aT1 - aT0) + (float) (int32_t) (aT2 - aT3)) / 2.0f;
+      s->rtt = rtt;
+      s->time = aT3;
+      mySampleIdx = (mySampleIdx + 1) % F3X_CLOCK_SYNC_SAMPLES;
+      if (mySampleCnt < F3X_CLOCK_SYNC_SAMPLES) {
+        mySampleCnt++;
+      }
+
+      // best sample (min. RTT) of the stored samples
+      Sample* best = &mySamples[0];
+      for (uint8_t i=1; i<mySampleCnt; i++) {
+        if (mySamples[i].rtt < best->rtt) {
+          best = &mySamples[i];
+        }
+      }
+
+      if (!myValid) {
+        myDriftRefOffset = best->offset;
+        myDriftRefTime = best->time;
+      } else if ((best->time - myDriftRefTime) >= F3X_CLOCK_SYNC_DRIFT_MIN_MS) {
+        float drift = (best->offset - myDriftRefOffset) / (float) (best->time - myDriftRefTime);
+        if (drift > -F3X_CLOCK_SYNC_DRIFT_MAX && drift < F3X_CLOCK_SYNC_DRIFT_MAX) {
+          myDrift = myDrift + 0.5f * (drift - myDrift);
+        }
+        myDriftRefOffset = best->offset;
+        myDriftRefTime = best->time;
+      }
+      myRefOffset = best->offset;
+      myRefTime = best->time;
+      myRefRtt = best->rtt;
+      myValid = true;
+    }
+
+    boolean isValid() {
+      return myValid;
+    }
+
+    /**
+     * offset (remote - local) in ms at the local time aLocalTime
+     */
+    float getOffset(uint32_t aLocalTime) {
+      return myRefOffset + myDrift * (float) (int32_t) (aLocalTime - myRefTime);
+    }
+
+    /**
+     * convert a remote time stamp to the local millis() clock
+     */
+    uint32_t toLocal(uint32_t aRemoteTime) {
+      uint32_t local = aRemoteTime - (int32_t) myRefOffset;
+      float offset = getOffset(local);
+      return aRemoteTime - (int32_t) (offset >= 0.0f ? offset + 0.5f : offset - 0.5f);
+    }
+
+    /**
+     * drift of the remote clock in ppm
+     */
+    float getDriftPpm() {
+      return myDrift * 1000000.0f;
+    }
+
+    uint16_t getRtt() {
+      return myRefRtt;
+    }
+
+  private:
+    typedef struct {
+      float offset;
+      uint16_t rtt;
+      uint32_t time;
+    } Sample;
+
+    Sample mySamples[F3X_CLOCK_SYNC_SAMPLES];
+    uint8_t mySampleCnt;
+    uint8_t mySampleIdx;
+    boolean myValid;
+    float myDrift;
+    float myRefOffset;
+    uint32_t myRefTime;
+    uint16_t myRefRtt;
+    float myDriftRefOffset;
+    uint32_t myDriftRefTime;
+};
+
+#endif
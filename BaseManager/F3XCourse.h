@@ -0,0 +1,118 @@
+#ifndef F3XCourse_h
+#define F3XCourse_h
+
+#include <Arduino.h>
+#include "F3XFixedDistanceTask.h"
+#include "F3XFixedDistanceTaskData.h"
+#include "F3XRunStatistics.h"
+#include "F3XRoundScores.h"
+#include "F3XTaskStateTracker.h"
+
+#define F3X_COURSES_MAX          2     // courses flown at the same time
+#define F3B_STATS_BIN_WIDTH    250     // ms, resolution of the course time percentiles
+#define F3F_STATS_BIN_WIDTH   1000
+
+/**
+ * everything belonging to one course: the tasks (one of them is active), their run logs,
+ * statistics and scores and the state versions of /api/task. The courses are independent,
+ * a task is only stopped, if another task of the same course is activated.
+ * Course 0 is the course of the A-line button, the buzzer, the OLED and the pilot roster, the
+ * signals of the other courses are received by radio from their own line controllers.
+ */
+class F3XCourse {
+  public:
+    F3XCourse(uint8_t aIdx) :
+      myF3BSpeedTask(F3XFixedDistanceTask::F3BSpeedType),
+      myF3FTask(F3XFixedDistanceTask::F3FType),
+      myF3BData(&myF3BSpeedTask, aIdx),
+      myF3FData(&myF3FTask, aIdx),
+      myF3BStats(F3B_STATS_BIN_WIDTH),
+      myF3BSessionStats(F3B_STATS_BIN_WIDTH),
+      myF3FStats(F3F_STATS_BIN_WIDTH),
+      myF3FSessionStats(F3F_STATS_BIN_WIDTH) {
+      myIdx = aIdx;
+      myActiveTask = nullptr;
+    }
+
+    uint8_t getIndex() {
+      return myIdx;
+    }
+
+    F3XFixedDistanceTask* getTask(F3XFixedDistanceTask::F3XType aType) {
+      return aType == F3XFixedDistanceTask::F3FType ? &myF3FTask : &myF3BSpeedTask;
+    }
+
+    /**
+     * the task of the course, which gets the signals, nullptr if none is activated yet
+     */
+    F3XFixedDistanceTask* getActiveTask() {
+      return myActiveTask;
+    }
+
+    /**
+     * activate the task of type aType, the active task of another type is stopped
+     */
+    void setActiveTask(F3XFixedDistanceTask::F3XType aType) {
+      F3XFixedDistanceTask* task = getTask(aType);
+      if (myActiveTask != nullptr && myActiveTask != task) {
+        myActiveTask->stop();
+      }
+      myActiveTask = task;
+    }
+
+    boolean isRunning() {
+      return myActiveTask != nullptr && myActiveTask->getTaskState() == F3XFixedDistanceTask::TaskRunning;
+    }
+
+    /**
+     * true, if the task is running and the course was entered (time critical signals expected)
+     */
+    boolean isCourseFlown() {
+      return isRunning() && myActiveTask->getSignalledLegCount() >= F3X_COURSE_STARTED;
+    }
+
+    void update() {
+      if (myActiveTask != nullptr) {
+        myActiveTask->update();
+      }
+    }
+
+    F3XFixedDistanceTaskData* getData(F3XFixedDistanceTask::F3XType aType) {
+      return aType == F3XFixedDistanceTask::F3FType ? &myF3FData : &myF3BData;
+    }
+
+    /**
+     * statistics of all stored runs or, if aSession is set, of the runs of the session
+     */
+    F3XRunStatistics* getStats(F3XFixedDistanceTask::F3XType aType, boolean aSession=false) {
+      if (aType == F3XFixedDistanceTask::F3FType) {
+        return aSession ? &myF3FSessionStats : &myF3FStats;
+      }
+      return aSession ? &myF3BSessionStats : &myF3BStats;
+    }
+
+    F3XRoundScores* getScores(F3XFixedDistanceTask::F3XType aType) {
+      return aType == F3XFixedDistanceTask::F3FType ? &myF3FScores : &myF3BScores;
+    }
+
+    F3XTaskStateTracker* getStateTracker() {
+      return &myStateTracker;
+    }
+
+  private:
+    uint8_t myIdx;
+    F3XFixedDistanceTask myF3BSpeedTask;
+    F3XFixedDistanceTask myF3FTask;
+    F3XFixedDistanceTask* myActiveTask;
+    F3XFixedDistanceTaskData myF3BData;
+    F3XFixedDistanceTaskData myF3FData;
+    F3XRunStatistics myF3BStats;
+    F3XRunStatistics myF3BSessionStats;
+    F3XRunStatistics myF3FStats;
+    F3XRunStatistics myF3FSessionStats;
+    F3XRoundScores myF3BScores;
+    F3XRoundScores myF3FScores;
+    F3XTaskStateTracker myStateTracker;
+};
+
+#endif
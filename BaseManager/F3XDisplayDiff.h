@@ -0,0 +1,147 @@
+#ifndef F3XDisplayDiff_h
+#define F3XDisplayDiff_h
+
+#include <Arduino.h>
+#include <U8g2lib.h>
+
+#define F3X_DISPLAY_BUFFER_MAX  1024  // bytes of the full frame buffer of a 128x64 display
+#define F3X_DISPLAY_ROWS_MAX      16  // tile rows (8 pixel pages), bits of the row masks
+#define F3X_DISPLAY_MERGE_GAP      1  // unchanged tiles between two changed ones sent with them, cheaper than a new transfer
+
+/**
+ * sends only the changed tiles (8x8 pixel) of a full frame buffer display, one tile row per call
+ * of sendRow(). The I2C transfer blocks the loop, so the longest uninterruptible section is the
+ * transfer of one tile row (128 bytes of a 128x64 display), the signals are handled between
+ * two rows.
+ * The pages are still drawn completely into the frame buffer, which is compared tile by tile with
+ * a copy of the content of the display. The changed tiles of a row are sent as runs by
+ * updateDisplayArea(), e.g. only the digits of the running time. A row is compared when it is
+ * sent, so a frame drawn while the last one is sent is not torn within a row.
+ */
+class F3XDisplayDiff {
+  public:
+    F3XDisplayDiff() {
+      myValidRows = 0;
+      myPendingRows = 0;
+      myNextRow = 0;
+      myFrames = 0;
+      myBytes = 0;
+      myFrameBytes = 0;
+      myLastBytes = 0;
+    }
+
+    /**
+     * the display content is unknown (e.g. after sendBuffer() or setFlipMode()), the rows are
+     * sent completely by the next frame
+     */
+    void invalidate() {
+      myValidRows = 0;
+    }
+
+    /**
+     * a new frame is drawn into the frame buffer, its rows are sent by the next calls of sendRow()
+     */
+    void requestFrame(U8G2* aDisplay) {
+      uint8_t rows = aDisplay->getBufferTileHeight();
+      rows = rows < F3X_DISPLAY_ROWS_MAX ? rows : F3X_DISPLAY_ROWS_MAX;
+      myPendingRows = (1UL << rows) - 1;
+    }
+
+    /**
+     * true, if rows of a frame are waiting to be sent
+     */
+    boolean isPending() {
+      return myPendingRows != 0;
+    }
+
+    /**
+     * send the changed tiles of the next pending row, returns the number of sent bytes
+     */
+    uint16_t sendRow(U8G2* aDisplay) {
+      if (myPendingRows == 0) {
+        return 0;
+      }
+      while ((myPendingRows & (1UL << myNextRow)) == 0) {
+        myNextRow = (myNextRow + 1) % F3X_DISPLAY_ROWS_MAX;
+      }
+      uint8_t ty = myNextRow;
+      myPendingRows &= ~(1UL << ty);
+      myNextRow = (myNextRow + 1) % F3X_DISPLAY_ROWS_MAX;
+
+      uint8_t* buffer = aDisplay->getBufferPtr();
+      uint8_t tileWidth = aDisplay->getBufferTileWidth();
+      uint16_t bytes = 0;
+      if ((uint16_t) (ty+1) * tileWidth * 8 > F3X_DISPLAY_BUFFER_MAX) {
+        // no copy possible, the row is always sent
+        aDisplay->updateDisplayArea(0, ty, tileWidth, 1);
+        bytes = tileWidth * 8;
+      } else if ((myValidRows & (1UL << ty)) == 0) {
+        bytes = sendTiles(aDisplay, buffer, tileWidth, 0, ty, tileWidth);
+        myValidRows |= (1UL << ty);
+      } else {
+        uint8_t tx = 0;
+        while (tx < tileWidth) {
+          if (!isTileChanged(buffer, tileWidth, tx, ty)) {
+            tx++;
+            continue;
+          }
+          // a run of changed tiles, including short gaps
+          uint8_t last = tx;
+          for (uint8_t end = tx + 1; end < tileWidth && end <= last + 1 + F3X_DISPLAY_MERGE_GAP; end++) {
+            if (isTileChanged(buffer, tileWidth, end, ty)) {
+              last = end;
+            }
+          }
+          bytes += sendTiles(aDisplay, buffer, tileWidth, tx, ty, last - tx + 1);
+          tx = last + 1;
+        }
+      }
+      myFrameBytes += bytes;
+      if (myPendingRows == 0) {
+        myFrames++;
+        myBytes += myFrameBytes;
+        myLastBytes = myFrameBytes;
+        myFrameBytes = 0;
+      }
+      return bytes;
+    }
+
+    uint32_t getFrameCount() {
+      return myFrames;
+    }
+
+    /**
+     * average of the sent bytes per frame
+     */
+    uint16_t getAvgBytes() {
+      return myFrames == 0 ? 0 : myBytes / myFrames;
+    }
+
+    uint16_t getLastBytes() {
+      return myLastBytes;
+    }
+
+  private:
+    boolean isTileChanged(uint8_t* aBuffer, uint8_t aTileWidth, uint8_t aTx, uint8_t aTy) {
+      uint16_t offset = ((uint16_t) aTy * aTileWidth + aTx) * 8;
+      return memcmp(aBuffer + offset, myShadow + offset, 8) != 0;
+    }
+
+    uint16_t sendTiles(U8G2* aDisplay, uint8_t* aBuffer, uint8_t aTileWidth, uint8_t aTx, uint8_t aTy, uint8_t aWidth) {
+      aDisplay->updateDisplayArea(aTx, aTy, aWidth, 1);
+      uint16_t offset = ((uint16_t) aTy * aTileWidth + aTx) * 8;
+      memcpy(myShadow + offset, aBuffer + offset, aWidth * 8);
+      return aWidth * 8;
+    }
+
+    uint8_t myShadow[F3X_DISPLAY_BUFFER_MAX];
+    uint16_t myValidRows;    // rows, whose copy is the content of the display
+    uint16_t myPendingRows;  // rows of the current frame waiting to be sent
+    uint8_t myNextRow;
+    uint32_t myFrames;
+    uint32_t myBytes;
+    uint16_t myFrameBytes;
+    uint16_t myLastBytes;
+};
+
+#endif
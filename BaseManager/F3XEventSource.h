@@ -0,0 +1,129 @@
+#ifndef F3XEventSource_h
+#define F3XEventSource_h
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+
+#define F3X_SSE_MAX_CLIENTS 4  // browsers, which can watch a task at the same time
+
+/**
+ * server sent events (text/event-stream) for the web pages. A GET request on the event URL
+ * is taken over from the ESP8266WebServer and kept open, afterwards the data is pushed to all
+ * connected browsers with one write per client, instead of each browser polling for it.
+ * The data of an event has the format of the getDataReq response (id=value~~~...), so the
+ * browser parses it the same way.
+ * A write never blocks the loop: a client, which can not take an event completely (TCP window
+ * full), is closed. The browser reconnects automatically and gets a full update again.
+ */
+class F3XEventSource {
+  public:
+    F3XEventSource() {
+      myDroppedCnt = 0;
+    }
+
+    /**
+     * take over the client of the current web request, returns the slot of the client or -1,
+     * if all slots are in use
+     */
+    int8_t addClient(WiFiClient aClient) {
+      update();
+      for (uint8_t i=0; i<F3X_SSE_MAX_CLIENTS; i++) {
+        if (!myClients[i]) {
+          myClients[i] = aClient;
+          myClients[i].setNoDelay(true);
+          myClients[i].print(F("HTTP/1.1 200 OK\r\n"
+            "Content-Type: text/event-stream\r\n"
+            "Cache-Control: no-cache\r\n"
+            "Connection: keep-alive\r\n"
+            "Access-Control-Allow-Origin: *\r\n\r\n"
+            "retry: 2000\n\n"));
+          return i;
+        }
+      }
+      return -1;
+    }
+
+    /**
+     * release the slots of disconnected clients
+     */
+    void update() {
+      for (uint8_t i=0; i<F3X_SSE_MAX_CLIENTS; i++) {
+        if (myClients[i] && !myClients[i].connected()) {
+          myClients[i].stop();
+          myClients[i] = WiFiClient();
+        }
+      }
+    }
+
+    /**
+     * push aData to all connected clients
+     */
+    void send(const String& aData) {
+      if (aData.length() == 0) {
+        return;
+      }
+      String event = createEvent(aData);
+      for (uint8_t i=0; i<F3X_SSE_MAX_CLIENTS; i++) {
+        write(i, event);
+      }
+    }
+
+    /**
+     * push aData to the client of slot aSlot only, e.g. the initial data of a new client
+     */
+    void sendTo(int8_t aSlot, const String& aData) {
+      if (aSlot < 0 || aSlot >= F3X_SSE_MAX_CLIENTS || aData.length() == 0) {
+        return;
+      }
+      write(aSlot, createEvent(aData));
+    }
+
+    uint8_t getClientCount() {
+      uint8_t cnt = 0;
+      for (uint8_t i=0; i<F3X_SSE_MAX_CLIENTS; i++) {
+        if (myClients[i]) {
+          cnt++;
+        }
+      }
+      return cnt;
+    }
+
+    /**
+     * number of clients closed, because an event could not be written without blocking
+     */
+    uint16_t getDroppedCount() {
+      return myDroppedCnt;
+    }
+
+  private:
+    String createEvent(const String& aData) {
+      // the data never contains a line feed, so it is always a single data line
+      String event;
+      event.reserve(aData.length() + 8);
+      event += F("data: ");
+      event += aData;
+      event += F("\n\n");
+      return event;
+    }
+
+    void write(uint8_t aSlot, const String& aEvent) {
+      WiFiClient* client = &myClients[aSlot];
+      if (!*client) {
+        return;
+      }
+      if (!client->connected() || client->availableForWrite() < (int) aEvent.length()) {
+        if (client->connected()) {
+          myDroppedCnt++;
+        }
+        client->stop();
+        *client = WiFiClient();
+        return;
+      }
+      client->write((const uint8_t*) aEvent.c_str(), aEvent.length());
+    }
+
+    WiFiClient myClients[F3X_SSE_MAX_CLIENTS];
+    uint16_t myDroppedCnt;
+};
+
+#endif
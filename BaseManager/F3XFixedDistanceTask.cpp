@@ -1,4 +1,5 @@
 #include <Logger.h>
+#include "F3XLogFormats.h"
 #include "F3XFixedDistanceTask.h"
 
 /*
@@ -30,6 +31,7 @@ F3XFixedDistanceTask::F3XFixedDistanceTask(F3XType aType) {
   myDeadDistanceTimeStamp = (unsigned long *) malloc(sizeof(unsigned long) * (myLegNumberMax-1));
   myLoopTaskNum = 0;
   myLoopTaskEnabled = false;
+  myResetCount = 0;
   stop();
 }
 
@@ -188,7 +190,7 @@ void F3XFixedDistanceTask::timeOverflow() {
   if (getTaskState() != TaskRunning) {
     return;
   }
-  logMsg(LOG_MOD_SIG, INFO, String("FDT::timeOverflow"));
+  logEvent(LOG_MOD_SIG, INFO, LogFmtTaskTimeOverflow);
   setTaskState(TaskTimeOverflow);
 }
 
@@ -196,9 +198,27 @@ void F3XFixedDistanceTask::timeOverflow() {
  * method should be called if a signal event is given by a controller or local switch
  */
 void F3XFixedDistanceTask::signal(Signal aType) {
-  logMsg(LOG_MOD_SIG, INFO, String("FDT::signal(") + (aType == SignalA?'A':'B')+ String(")"));
+  signalAt(aType, millis());
+}
+
+/**
+ * method should be called if a signal event was captured earlier (e.g. by an ISR) with the
+ * given micros() time stamp aTimestampUs. The time stamp is converted to the millis() time base
+ * of the task, so the course times do not depend on the latency of the main loop.
+ */
+void F3XFixedDistanceTask::signal(Signal aType, uint32_t aTimestampUs) {
+  uint32_t age = micros() - aTimestampUs;
+  signalAt(aType, millis() - age/1000);
+}
+
+/**
+ * method should be called if the time of a signal event in the millis() time base is known,
+ * e.g. converted from the clock of a remote line controller
+ */
+void F3XFixedDistanceTask::signalAt(Signal aType, unsigned long aTime) {
+  logEvent(LOG_MOD_SIG, INFO, LogFmtTaskSignal, aType == SignalA ? "A" : "B");
   if (myTaskState != TaskRunning) {
-    logMsg(LOG_MOD_SIG, INFO, String(" not allowed in state ") + String(myTaskState));
+    logEvent(LOG_MOD_SIG, INFO, LogFmtTaskSignalNotAllowed, myTaskState);
     return;
   }
   if (mySignalAListener == nullptr) {
@@ -209,13 +229,17 @@ void F3XFixedDistanceTask::signal(Signal aType) {
     logMsg(LOG_MOD_SIG, ERROR, String("mySignalBListener is null !!! "));
     return;
   }
+  if (mySignalledLegCount >= F3X_COURSE_STARTED && aTime < mySignalTimeStamps[mySignalledLegCount]) {
+    // a captured time stamp must never be older than the last signalled crossing
+    aTime = mySignalTimeStamps[mySignalledLegCount];
+  }
 
   if (aType == SignalA) {
     if (myType == F3BSpeedType 
         && ( mySignalledLegCount == F3X_COURSE_INIT // (-3)
              || mySignalledLegCount == F3X_COURSE_STARTED) ) { // (0) in case of reflight or first A-Line reverse crossing
       mySignalledLegCount = F3X_COURSE_STARTED;  // =0 legs , but started, first A-Line crossing
-      mySignalTimeStamps[mySignalledLegCount] = millis();
+      mySignalTimeStamps[mySignalledLegCount] = aTime;
       mySignalAListener();
     } else 
     if (myType == F3FType 
@@ -237,31 +261,31 @@ void F3XFixedDistanceTask::signal(Signal aType) {
       mySignalledLegCount = F3X_COURSE_STARTED;  // 0 legs , but started, first A-Line crossing
       if (mySignalTimeStamps[mySignalledLegCount] == -1UL) {
         // only set if not auto set 
-        mySignalTimeStamps[mySignalledLegCount] = millis();
+        mySignalTimeStamps[mySignalledLegCount] = aTime;
       }
       mySignalAListener();  // force a A-Line signal
     } else 
     if (mySignalledLegCount > 0) { // task is ongoing
       if (mySignalledLegCount%2 == 1) {  // REGULAR : A line crossing n.th time, start of  1/3/5/... leg
         mySignalledLegCount++;
-        mySignalTimeStamps[mySignalledLegCount] = millis();
+        mySignalTimeStamps[mySignalledLegCount] = aTime;
         if ( mySignalledLegCount == myLegNumberMax) { // last leg finished
           logMsg(LOG_MOD_SIG, INFO, String("FDT::TaskFinised"));
           setTaskState(TaskFinished);
         }  
         mySignalAListener();
       } else { // NO crossing turn, additional A signal is used for dead time/distance measurement
-        myDeadDistanceTimeStamp[mySignalledLegCount-1] = millis();
+        myDeadDistanceTimeStamp[mySignalledLegCount-1] = aTime;
       }
     }
   } else if (aType == SignalB) {
     if (mySignalledLegCount >= F3X_COURSE_STARTED) { // task is ongoing
       if (mySignalledLegCount%2 == 0) {  // REGULAR : B line crossing n.th time, start of 2/4/6/.. leg 
         mySignalledLegCount++;
-        mySignalTimeStamps[mySignalledLegCount] = millis();
+        mySignalTimeStamps[mySignalledLegCount] = aTime;
         mySignalBListener();
       } else { // NO crossing turn, additional B signal is used for dead time/distance measurement
-        myDeadDistanceTimeStamp[mySignalledLegCount-1] = millis();
+        myDeadDistanceTimeStamp[mySignalledLegCount-1] = aTime;
       }
     }
   }
@@ -331,6 +355,7 @@ unsigned long F3XFixedDistanceTask::getInAirTime() {
 }
 
 void F3XFixedDistanceTask::resetSignals() {
+  myResetCount++;
   mySignalledLegCount = F3X_COURSE_INIT;
   for (int i=0; i<myLegNumberMax+1; i++) {
     mySignalTimeStamps[i] = -1UL;
@@ -379,6 +404,13 @@ int8_t F3XFixedDistanceTask::getSignalledLegCount() {
   return mySignalledLegCount;
 }
 
+/**
+ * number of resets of the signals (start, stop), a new run of the task
+ */
+uint16_t F3XFixedDistanceTask::getResetCount() {
+  return myResetCount;
+}
+
 F3XFixedDistanceTask::State F3XFixedDistanceTask::getTaskState() {
   return myTaskState;
 }
@@ -74,7 +74,8 @@ public:
   void addStateChangeListener( void (*aListener)(State));
   void addTimeProceedingListener( void (*aListener)());
   void signal(Signal aSignal);
-  void signal();
+  void signal(Signal aSignal, uint32_t aTimestampUs);
+  void signalAt(Signal aSignal, unsigned long aTime);
   void timeOverflow();
   void start();
   void stop();
@@ -88,6 +89,7 @@ public:
   float getFinalSpeed();
   float getSpeed();
   int8_t getSignalledLegCount();
+  uint16_t getResetCount();
   void update();
   State getTaskState();
   F3XType getType();
@@ -110,6 +112,7 @@ protected:
   void (*myStateChangeListener)(State);
   void (*myTimeProceedingListener)(void);
   int8_t mySignalledLegCount;
+  uint16_t myResetCount;
   State myTaskState;
   unsigned long myLaunchTime;
   uint8_t myListenerIndication;
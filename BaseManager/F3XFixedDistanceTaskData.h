@@ -1,16 +1,117 @@
 #ifndef F3XFixedDistanceTaskData_h
 #define F3XFixedDistanceTaskData_h
 
+#include <LittleFS.h>
+#include <Logger.h>
 #include "F3XFixedDistanceTask.h"
+#include "F3XRemoteCommand.h"
 
+#define F3X_RUN_RECORD_MAGIC  0xF3B3  // changed with each change of F3XRunRecord
+#define F3X_RUN_LEGS_MAX          10  // legs of a F3F task
+#define F3X_PILOT_NONE          0xFF  // run without pilot of the roster
+
+/**
+ * a finished run as stored in the run log. All times are in ms, the course times are relative
+ * to the first A-line crossing.
+ */
+typedef struct __attribute__((packed)) F3XRunRecord {
+  uint16_t magic;
+  uint16_t runNo;
+  uint8_t type;                                   // F3XFixedDistanceTask::F3XType
+  uint8_t legNumber;
+  uint16_t legLength;                             // meter
+  uint32_t timestamp;                             // millis() at the end of the run
+  uint32_t courseTime[F3X_RUN_LEGS_MAX];          // course time at the end of each leg
+  uint16_t deadTime[F3X_RUN_LEGS_MAX];            // dead time at the turn after each leg, 0: none
+  uint8_t pilot;                                  // index in the pilot roster or F3X_PILOT_NONE
+  uint8_t round;                                  // round of the schedule, 0: none
+  uint8_t group;                                  // group of the pilot in the round
+  uint8_t course;                                 // course the run was flown on
+  uint8_t roster;                                 // generation of the pilot roster pilot refers to
+  uint8_t reserved[2];
+  uint8_t crc;                                    // crc8 of the bytes above
+} F3XRunRecord;
+
+/**
+ * protocol of the finished tasks as binary run log, one fixed size F3XRunRecord per run.
+ * The records are only appended, so run n is found at n*sizeof(F3XRunRecord) without an
+ * index file, and a record torn by a reset is detected by its size or CRC.
+ * The CSV lines (e.g. for the download of the protocol) are created from the records on demand.
+ */
 class F3XFixedDistanceTaskData {
   private:
     String myProtocolFilePath;
+    String myLogFilePath;
     F3XFixedDistanceTask* myTask;
+    uint8_t myCourse;
     uint16_t myTaskNum;
+
+    void keepAsOld(const String& aPath, const __FlashStringHelper* aSuffix) {
+      String oldPath = aPath.substring(0, aPath.length()-4) + aSuffix;
+      LittleFS.remove(oldPath);
+      if (LittleFS.rename(aPath, oldPath)) {
+        logMsg(LOG_MOD_TASKDATA, INFO, String(F("former protocol kept as: ")) + oldPath);
+      }
+    }
+
+    static uint8_t getCrc(const F3XRunRecord* aRecord) {
+      return F3XRemoteCommand::crc8((const uint8_t*) aRecord, sizeof(F3XRunRecord)-1);
+    }
+
+    /**
+     * the CSV line of a stored run, the columns are the same as in the CSV protocol of the former versions
+     */
+    String getRunLine(const F3XRunRecord* aRecord) {
+      String line;
+      line.reserve(64 + aRecord->legNumber * 40);
+      line += aRecord->runNo;
+      line += ";";
+      line += F3XFixedDistanceTask::getHMSTimeStr(aRecord->timestamp);
+      line += ";";
+      switch(aRecord->type) {
+        case F3XFixedDistanceTask::F3BSpeedType:
+          line += F("F3BSpeed");
+          break;
+        case F3XFixedDistanceTask::F3FType:
+          line += F("F3F");
+          break;
+      }
+      line += ";";
+      line += aRecord->legLength;
+      line += ";";
+      unsigned long finalTime = aRecord->legNumber > 0 ? aRecord->courseTime[aRecord->legNumber-1] : 0;
+      line += myTask->getLegTimeString(finalTime, F3X_TIME_NOT_SET, 0, 0, 0);
+      line += ";";
+      line += String(finalTime > 0 ? ((float) aRecord->legNumber * 1000 * aRecord->legLength) / finalTime * 3.6f : 0.0f);
+      line += ";";
+      line += myTask->getLegTimeString(0, F3X_TIME_NOT_SET, 0, 0, 0, ';');
+      line += ";";
+      for (uint8_t i=0; i<aRecord->legNumber; i++) {
+        line += myTask->getLegTimeString(aRecord->courseTime[i], getLegTime(aRecord, i), getLegSpeed(aRecord, i)*3.6f,
+                  aRecord->deadTime[i], getDeadDistance(aRecord, i), ';', (i==(aRecord->legNumber-1))?false:true, false);
+        line += ";";
+      }
+      if (aRecord->pilot != F3X_PILOT_NONE) {
+        line += aRecord->round;
+        line += ";";
+        line += aRecord->group;
+        line += ";";
+        line += aRecord->pilot+1;
+        line += ";";
+      } else {
+        line += ";;;";
+      }
+      return line;
+    }
+
   public:
-    F3XFixedDistanceTaskData(F3XFixedDistanceTask* aTask) {
+    /**
+     * the run log of the task aTask on course aCourse, the log of course 0 is /<task>.bin, of
+     * the other courses /<task><course+1>.bin
+     */
+    F3XFixedDistanceTaskData(F3XFixedDistanceTask* aTask, uint8_t aCourse=0) {
       myTask = aTask;
+      myCourse = aCourse;
       myTaskNum = 0;
       switch(myTask->getType()) {
         case F3XFixedDistanceTask::F3BSpeedType:
@@ -20,161 +121,310 @@ class F3XFixedDistanceTaskData {
           myProtocolFilePath = F("/F3FTaskData.csv");
           break;
       }
+      myLogFilePath = myProtocolFilePath.substring(0, myProtocolFilePath.length()-4);
+      if (myCourse > 0) {
+        myLogFilePath += String(myCourse+1);
+      }
+      myLogFilePath += F(".bin");
     }
 
+    /**
+     * continue the run numbering of the run log. A CSV protocol of a former version is kept
+     * as *.old.csv, the CSV path is the URL of the protocol created from the run log. A run log
+     * with another record format is kept as *.old.bin.
+     */
     void init() {
+      if (myCourse == 0 && LittleFS.exists(myProtocolFilePath)) {
+        keepAsOld(myProtocolFilePath, F(".old.csv"));
+      }
+      File file = LittleFS.open(myLogFilePath.c_str(), "r");
+      if (file) {
+        uint16_t magic = F3X_RUN_RECORD_MAGIC;
+        if (file.size() >= sizeof(magic)) {
+          file.read((uint8_t*) &magic, sizeof(magic));
+        }
+        file.close();
+        if (magic != F3X_RUN_RECORD_MAGIC) {
+          keepAsOld(myLogFilePath, F(".old.bin"));
+        }
+      }
+      myTaskNum = 0;
+      uint16_t cnt = getRunCount();
+      F3XRunRecord record;
+      if (cnt > 0 && readRecord(cnt-1, &record)) {
+        myTaskNum = record.runNo;
+      }
+      logMsg(LOG_MOD_TASKDATA, INFO, String(F("run log: ")) + myLogFilePath + F(", runs: ") + String(cnt));
     }
 
-    void remove() {
-      logMsg(LOG_MOD_SIG, INFO, String(F("remove file: ")) + String(myProtocolFilePath.c_str()));
-      if (!LittleFS.remove(myProtocolFilePath.c_str())) {
-        logMsg(LOG_MOD_SIG, ERROR, String(F("remove file failed: ")) + String(myProtocolFilePath.c_str()));
-      }
-    }
-
-    void writeHeader() {
-      // check existing file
-      logMsg(LOG_MOD_TASKDATA, INFO, String(F("write header: ")) + String(myProtocolFilePath.c_str()));
-      logMsg(LOG_MOD_TASKDATA, INFO, String(F("check header file: ")) + String(myProtocolFilePath.c_str()));
-      File file = LittleFS.open(myProtocolFilePath.c_str(), "r");
-      if(!file) {
-        // protocol file not existing, so create a empty one with header
-        file = LittleFS.open(myProtocolFilePath.c_str(), "w");
-        if(!file){
-          logMsg(LOG_MOD_TASKDATA, ERROR, String(F("cannot create protocol file: ")) + String(myProtocolFilePath.c_str()));
-        } else {
-          logMsg(LOG_MOD_TASKDATA, INFO, String(F("write header to file: ")) + String(myProtocolFilePath.c_str()));
-          String line;
-          line += "No;";
-          line += "Timestamp;";
-          line += "Task;";
-          line += "Leg length;";
-          line += "Course time;";
-          line += "Course Speed;";
-          line += "Time 000m (A);";
-          char buffer[20];
-          for (uint8_t i=0; i<myTask->getLegNumberMax(); i++) { // e.g F3BSpeed: 0..3
-            F3XLeg leg = myTask->getLeg(i);
-            sprintf(buffer, "Course time %dm (%c);", ((i+1)*myTask->getLegLength()), (i%2==0) ? 'B':'A');
-            // line += "Course time 150m (B);";
-            line += String(buffer);
-            sprintf(buffer, "Time %d.leg;", (i+1));
-            // line += "Time 1.leg;";
-            line += String(buffer);
-            sprintf(buffer, "Speed %d.leg;", (i+1));
-            // line += "Speed 1.leg;";
-            line += String(buffer);
-            if ( (i+1) != myTask->getLegNumberMax()) {
-              line += "dead time;";
-              line += "dead distance;";
-            }
-          }
-          // /// 0
-          // line += "Time 150m (B);";
-          // line += "Time 1.leg;";
-          // line += "Speed 1.leg;";
-          // line += "deadtime;";
-          // line += "dead distance;";
-          // /// 1
-          // line += "Time 300m (A);";
-          // line += "Time 2.leg;";
-          // line += "Speed 2.leg;";
-          // line += "deadtime;";
-          // line += "dead distance;";
-          // line += "Time 450m (B);";
-          // line += "Time 3.leg;";
-          // line += "Speed 3.leg;";
-          // line += "deadtime;";
-          // line += "dead distance;";
-          // line += "Time 600m (A);";
-          // line += "Time 4.leg;";
-          // line += "Speed 4.leg";
-          if(!file.print(line)){
-            logMsg(LOG_MOD_TASKDATA, ERROR, String(F("cannot write protocol file: ")) + String(myProtocolFilePath.c_str()));
-          }
-          line = "\n";
-          line += ";"; // No
-          line += "h:m:s;"; // Time
-          line += ";";  // Task
-          line += "meter;"; // Leg length
-          line += "min:sec.msec;"; // course time
-          line += "km/h;"; // course speed
-          line += "min:sec.msec;"; // Time at 000m (0s)
-
-          for (uint8_t i=0; i<myTask->getLegNumberMax(); i++) { // e.g F3BSpeed: 0..3
-            line += "min:sec.msec;"; // course time at xxx m
-            line += "sec.msec;";     // leg time
-            line += "km/h;";         // leg speed
-            if ( (i+1) != myTask->getLegNumberMax()) {
-              // not for last leg
-              line += "sec.msec;"; // dead time
-              line += "meter;"; // dead distance
-            }
-          }
+    static boolean isValid(const F3XRunRecord* aRecord) {
+      return aRecord->magic == F3X_RUN_RECORD_MAGIC && aRecord->legNumber <= F3X_RUN_LEGS_MAX
+        && aRecord->crc == getCrc(aRecord);
+    }
+
+    /**
+     * time of leg aIdx of a stored run in ms
+     */
+    static unsigned long getLegTime(const F3XRunRecord* aRecord, uint8_t aIdx) {
+      return aRecord->courseTime[aIdx] - (aIdx > 0 ? aRecord->courseTime[aIdx-1] : 0);
+    }
+
+    /**
+     * speed of leg aIdx of a stored run in m/s
+     */
+    static float getLegSpeed(const F3XRunRecord* aRecord, uint8_t aIdx) {
+      unsigned long legTime = getLegTime(aRecord, aIdx);
+      return legTime > 0 ? ((float) aRecord->legLength * 1000) / legTime : 0.0f;
+    }
+
+    /**
+     * dead distance at the turn after leg aIdx of a stored run in m, calculated as F3XFixedDistanceTask::getLeg()
+     */
+    static uint16_t getDeadDistance(const F3XRunRecord* aRecord, uint8_t aIdx) {
+      return getLegSpeed(aRecord, aIdx) * aRecord->deadTime[aIdx] / 1000;
+    }
+
+    F3XFixedDistanceTask::F3XType getType() {
+      return myTask->getType();
+    }
+
+    uint8_t getCourse() {
+      return myCourse;
+    }
+
+    /**
+     * number of the last run written or snapshotted
+     */
+    uint16_t getLastRunNo() {
+      return myTaskNum;
+    }
+
+    /**
+     * the URL of the CSV protocol, the same for all courses
+     */
+    const String& getProtocolFilePath() {
+      return myProtocolFilePath;
+    }
+
+    /**
+     * number of stored runs, an incomplete last record is not counted
+     */
+    uint16_t getRunCount() {
+      File file = LittleFS.open(myLogFilePath.c_str(), "r");
+      if (!file) {
+        return 0;
+      }
+      uint16_t cnt = file.size() / sizeof(F3XRunRecord);
+      file.close();
+      return cnt;
+    }
+
+    /**
+     * read run aIdx (0 = oldest), returns false if it does not exist or is corrupted
+     */
+    boolean readRecord(uint16_t aIdx, F3XRunRecord* aRecord) {
+      File file = LittleFS.open(myLogFilePath.c_str(), "r");
+      if (!file) {
+        return false;
+      }
+      boolean ok = file.seek((uint32_t) aIdx * sizeof(F3XRunRecord))
+        && file.read((uint8_t*) aRecord, sizeof(F3XRunRecord)) == sizeof(F3XRunRecord)
+        && isValid(aRecord);
+      file.close();
+      return ok;
+    }
+
+    /**
+     * the line with the column names
+     */
+    String getHeaderLine() {
+      String line;
+      line += F("No;Timestamp;Task;Leg length;Course time;Course Speed;Time 000m (A);");
+      char buffer[30];
+      for (uint8_t i=0; i<myTask->getLegNumberMax(); i++) { // e.g F3BSpeed: 0..3
+        sprintf(buffer, "Course time %dm (%c);", ((i+1)*myTask->getLegLength()), (i%2==0) ? 'B':'A');
+        line += String(buffer);
+        sprintf(buffer, "Time %d.leg;", (i+1));
+        line += String(buffer);
+        sprintf(buffer, "Speed %d.leg;", (i+1));
+        line += String(buffer);
+        if ( (i+1) != myTask->getLegNumberMax()) {
+          line += F("dead time;dead distance;");
+        }
+      }
+      line += F("Round;Group;Pilot;");
+      return line;
+    }
+
+    /**
+     * the line with the units of the columns
+     */
+    String getUnitsLine() {
+      String line;
+      line += F(";h:m:s;;meter;min:sec.msec;km/h;min:sec.msec;");
+      for (uint8_t i=0; i<myTask->getLegNumberMax(); i++) { // e.g F3BSpeed: 0..3
+        line += F("min:sec.msec;sec.msec;km/h;"); // course time at xxx m, leg time, leg speed
+        if ( (i+1) != myTask->getLegNumberMax()) {
+          // not for last leg
+          line += F("sec.msec;meter;"); // dead time, dead distance
+        }
+      }
+      line += F(";;No;"); // round, group, pilot in the start order
+      return line;
+    }
 
-          if(!file.print(line)){
-            logMsg(LOG_MOD_TASKDATA, ERROR, String(F("cannot write protocol file: ")) + String(myProtocolFilePath.c_str()));
+    /**
+     * append the CSV lines of the runs in the records aFrom to aFrom+aCount-1 (0 = oldest) to
+     * aLines, corrupted records are skipped. Returns the number of records read, less than aCount
+     * at the end of the run log, so the run log can be read page by page.
+     */
+    uint16_t appendRunLines(uint16_t aFrom, uint16_t aCount, String* aLines) {
+      File file = LittleFS.open(myLogFilePath.c_str(), "r");
+      uint16_t cnt = 0;
+      if (file && file.seek((uint32_t) aFrom * sizeof(F3XRunRecord))) {
+        F3XRunRecord record;
+        while (cnt < aCount && file.read((uint8_t*) &record, sizeof(record)) == sizeof(record)) {
+          cnt++;
+          if (isValid(&record)) {
+            *aLines += getRunLine(&record);
+            *aLines += '\n';
           }
         }
+      }
+      if (file) {
         file.close();
-      } else {
-        file.close();
-      } 
+      }
+      return cnt;
     }
 
-    void writeData() {
-      writeHeader();
-      File file;
-      file = LittleFS.open(myProtocolFilePath.c_str(), "a");
-      logMsg(LOG_MOD_TASKDATA, INFO, String(F("write data log file: ")) + String(myProtocolFilePath.c_str()));
-      if(!file){
-        logMsg(LOG_MOD_TASKDATA, ERROR, String(F("cannot open protocol file for append: ")) + String(myProtocolFilePath.c_str()));
-      } else {
-        String taskName;
-        switch(myTask->getType()) {
-          case F3XFixedDistanceTask::F3BSpeedType:
-            taskName = F("F3BSpeed");
-            break;
-          case F3XFixedDistanceTask::F3FType:
-            taskName = F("F3F");
-            break;
-        }
-        myTaskNum++;
-        String line;
-        line += "\n";
-        line += myTaskNum;
-        line += ";";
-        line += F3XFixedDistanceTask::getHMSTimeStr(millis());
-        line += ";";
-        line += taskName;
-        line += ";";
-        line += myTask->getLegLength();
-        line += ";";
-        line += myTask->getLegTimeString(myTask->getCourseTime(F3X_GFT_FINAL_TIME), F3X_TIME_NOT_SET, 0, 0, 0);
-        line += ";";
-        line += myTask->getFinalSpeed()*3.6f;
-        line += ";";
-        line += myTask->getLegTimeString(myTask->getCourseTime(0),F3X_TIME_NOT_SET,0,0,0,';');
-        line += ";";
-        
-        for (uint8_t i=0; i<myTask->getLegNumberMax(); i++) { // e.g F3BSpeed: 0..3
-          F3XLeg leg = myTask->getLeg(i);
-          line += myTask->getLegTimeString(
-                    myTask->getCourseTime(i+1), 
-                    leg.time,
-                    leg.speed*3.6f, 
-                    leg.deadTime,
-                    leg.deadDistance, ';', (i==(myTask->getLegNumberMax()-1))?false:true, false);
-          if (i != myTask->getLegNumberMax()) {
-            line += ";";
+    /**
+     * read aCount runs starting with run aFrom (0 = oldest) and call aConsumer with the CSV line
+     * of each run, returns the number of runs read. Corrupted records are skipped.
+     */
+    uint16_t readRuns(uint16_t aFrom, uint16_t aCount, void (*aConsumer)(const String& aLine, void* aContext), void* aContext) {
+      File file = LittleFS.open(myLogFilePath.c_str(), "r");
+      uint16_t cnt = 0;
+      if (file && file.seek((uint32_t) aFrom * sizeof(F3XRunRecord))) {
+        F3XRunRecord record;
+        while (cnt < aCount && file.read((uint8_t*) &record, sizeof(record)) == sizeof(record)) {
+          if (isValid(&record)) {
+            aConsumer(getRunLine(&record), aContext);
+            cnt++;
           }
         }
-        logMsg(LOG_MOD_TASKDATA, INFO, String(F("write data: ")) + String(myProtocolFilePath.c_str()));
-        if(!file.print(line)){
-          logMsg(LOG_MOD_TASKDATA, ERROR, String(F("cannot write protocol file: ")) + String(myProtocolFilePath.c_str()));
+      }
+      if (file) {
+        file.close();
+      }
+      return cnt;
+    }
+
+    /**
+     * call aConsumer for aCount valid records starting with run aFrom (0 = oldest), returns the
+     * number of records read
+     */
+    uint16_t readRecords(uint16_t aFrom, uint16_t aCount, void (*aConsumer)(const F3XRunRecord* aRecord, void* aContext), void* aContext) {
+      File file = LittleFS.open(myLogFilePath.c_str(), "r");
+      uint16_t cnt = 0;
+      if (file && file.seek((uint32_t) aFrom * sizeof(F3XRunRecord))) {
+        F3XRunRecord record;
+        while (cnt < aCount && file.read((uint8_t*) &record, sizeof(record)) == sizeof(record)) {
+          if (isValid(&record)) {
+            aConsumer(&record, aContext);
+            cnt++;
+          }
         }
+      }
+      if (file) {
+        file.close();
+      }
+      return cnt;
+    }
+
+    /**
+     * call aConsumer with the lines of the complete CSV protocol: column names, units and all runs
+     */
+    void exportCsv(void (*aConsumer)(const String& aLine, void* aContext), void* aContext) {
+      aConsumer(getHeaderLine(), aContext);
+      aConsumer(getUnitsLine(), aContext);
+      readRuns(0, UINT16_MAX, aConsumer, aContext);
+    }
+
+    void remove() {
+      logMsg(LOG_MOD_SIG, INFO, String(F("remove file: ")) + myLogFilePath);
+      if (!LittleFS.remove(myLogFilePath.c_str())) {
+        logMsg(LOG_MOD_SIG, ERROR, String(F("remove file failed: ")) + myLogFilePath);
+      }
+      myTaskNum = 0;
+    }
+
+    /**
+     * snapshot the finished task into aRecord with the next run number, the run is tagged with
+     * the pilot index aPilot of the roster generation aRoster, the round aRound and the group
+     * aGroup of the schedule
+     */
+    void createRecord(F3XRunRecord* aRecord, uint8_t aPilot=F3X_PILOT_NONE, uint8_t aRound=0, uint8_t aGroup=0, uint8_t aRoster=0) {
+      memset(aRecord, 0, sizeof(F3XRunRecord));
+      aRecord->magic = F3X_RUN_RECORD_MAGIC;
+      aRecord->runNo = ++myTaskNum;
+      aRecord->type = myTask->getType();
+      aRecord->legNumber = myTask->getLegNumberMax() > F3X_RUN_LEGS_MAX ? F3X_RUN_LEGS_MAX : myTask->getLegNumberMax();
+      aRecord->legLength = myTask->getLegLength();
+      aRecord->timestamp = millis();
+      for (uint8_t i=0; i<aRecord->legNumber; i++) {
+        F3XLeg leg = myTask->getLeg(i);
+        aRecord->courseTime[i] = myTask->getCourseTime(i+1);
+        aRecord->deadTime[i] = leg.deadTime > UINT16_MAX ? UINT16_MAX : leg.deadTime;
+      }
+      aRecord->pilot = aPilot;
+      aRecord->round = aRound;
+      aRecord->group = aGroup;
+      aRecord->course = myCourse;
+      aRecord->roster = aRoster;
+      aRecord->crc = getCrc(aRecord);
+    }
+
+    /**
+     * append aRecord to the run log
+     */
+    boolean appendRecord(const F3XRunRecord* aRecord) {
+      File file = LittleFS.open(myLogFilePath.c_str(), "a");
+      if (!file) {
+        logMsg(LOG_MOD_TASKDATA, ERROR, String(F("cannot open run log for append: ")) + myLogFilePath);
+        return false;
+      }
+      uint32_t size = file.size();
+      if (size % sizeof(F3XRunRecord) != 0) {
+        // a record torn by a reset, the next one is written behind it and would be misaligned
         file.close();
+        logMsg(LOG_MOD_TASKDATA, WARNING, String(F("run log truncated to complete records: ")) + myLogFilePath);
+        file = LittleFS.open(myLogFilePath.c_str(), "r+");
+        if (!file || !file.truncate(size - size % sizeof(F3XRunRecord)) || !file.seek(0, SeekEnd)) {
+          logMsg(LOG_MOD_TASKDATA, ERROR, String(F("cannot truncate run log: ")) + myLogFilePath);
+          if (file) {
+            file.close();
+          }
+          return false;
+        }
+      }
+      boolean ok = file.write((const uint8_t*) aRecord, sizeof(F3XRunRecord)) == sizeof(F3XRunRecord);
+      if (!ok) {
+        logMsg(LOG_MOD_TASKDATA, ERROR, String(F("cannot write run log: ")) + myLogFilePath);
+      }
+      file.close();
+      if (aRecord->runNo > myTaskNum) {
+        myTaskNum = aRecord->runNo;
       }
+      return ok;
+    }
+
+    /**
+     * append the finished task as one record to the run log
+     */
+    void writeData() {
+      F3XRunRecord record;
+      createRecord(&record);
+      appendRecord(&record);
     }
 };
 #endif
@@ -0,0 +1,30 @@
+#ifndef F3XLogFormats_h
+#define F3XLogFormats_h
+
+#include <Arduino.h>
+
+/**
+ * ids of the formats of logEvent() (see Logger::setFormats()), the messages of the hot paths
+ * (signals, radio, scheduler) are recorded binary and formatted when they are printed.
+ * The formats are defined in ourLogFormats in the same order.
+ */
+enum F3XLogFormat {
+  LogFmtSignalA = 0,
+  LogFmtSignalB,
+  LogFmtSignalBuzzing,
+  LogFmtSenderAge,
+  LogFmtSenderAgeImplausible,
+  LogFmtRadioBuzzerFailed,
+  LogFmtRadioBuzzerDone,
+  LogFmtDuplicateFrame,
+  LogFmtTaskSignal,
+  LogFmtTaskSignalNotAllowed,
+  LogFmtTaskTimeOverflow,
+  LogFmtSchedOverrun,
+  LogFmtSchedSlowLoop,
+  LogFmtCount
+};
+
+extern const char* const ourLogFormats[LogFmtCount];
+
+#endif
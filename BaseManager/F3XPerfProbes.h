@@ -0,0 +1,128 @@
+#ifndef F3XPerfProbes_h
+#define F3XPerfProbes_h
+
+#include <Arduino.h>
+#include "LatencyHistogram.h"
+
+#define F3X_PERF_PROBES_MAX   24
+#define F3X_PERF_PROBE_NONE  255
+
+/**
+ * static table of named probes of the hot paths (loop tasks, radio, OLED, HTTP). A probe is
+ * started and stopped by the CPU cycle counter, the duration in us is recorded in a log2
+ * histogram (count, max, percentiles). Recording does not allocate, only the reports are
+ * built as String.
+ */
+class F3XPerfProbes {
+  public:
+    F3XPerfProbes() {
+      myCount = 0;
+    }
+
+    /**
+     * register a probe, aName must stay valid (string literal), returns the id of the probe or
+     * F3X_PERF_PROBE_NONE if the table is full
+     */
+    uint8_t add(const char* aName) {
+      if (myCount == F3X_PERF_PROBES_MAX) {
+        return F3X_PERF_PROBE_NONE;
+      }
+      myProbes[myCount].name = aName;
+      myProbes[myCount].start = 0;
+      return myCount++;
+    }
+
+    void start(uint8_t aId) {
+      if (aId < myCount) {
+        myProbes[aId].start = ESP.getCycleCount();
+      }
+    }
+
+    /**
+     * record the time since start(aId) and return it in us
+     */
+    uint32_t stop(uint8_t aId) {
+      if (aId >= myCount) {
+        return 0;
+      }
+      uint32_t duration = (ESP.getCycleCount() - myProbes[aId].start) / ESP.getCpuFreqMHz();
+      myProbes[aId].hist.record(duration);
+      return duration;
+    }
+
+    /**
+     * record a duration in us measured otherwise (e.g. between two calls)
+     */
+    void record(uint8_t aId, uint32_t aDuration) {
+      if (aId < myCount) {
+        myProbes[aId].hist.record(aDuration);
+      }
+    }
+
+    uint8_t getCount() {
+      return myCount;
+    }
+
+    const char* getName(uint8_t aId) {
+      return aId < myCount ? myProbes[aId].name : "";
+    }
+
+    LatencyHistogram* getHistogram(uint8_t aId) {
+      return aId < myCount ? &myProbes[aId].hist : nullptr;
+    }
+
+    void reset() {
+      for (uint8_t i=0; i<myCount; i++) {
+        myProbes[i].hist.reset();
+      }
+    }
+
+    /**
+     * the probes as JSON array, times in us, buckets: counts of the log2 buckets
+     * (bucket i: [2^(i-1), 2^i) us)
+     */
+    void appendJson(String* aJson) {
+      *aJson += F("[");
+      for (uint8_t i=0; i<myCount; i++) {
+        LatencyHistogram* hist = &myProbes[i].hist;
+        *aJson += (i > 0 ? F(",{\"name\":\"") : F("{\"name\":\""));
+        *aJson += myProbes[i].name;
+        *aJson += F("\",\"count\":");
+        *aJson += String(hist->getCount());
+        *aJson += F(",\"p50\":");
+        *aJson += String(hist->getPercentile(50));
+        *aJson += F(",\"p90\":");
+        *aJson += String(hist->getPercentile(90));
+        *aJson += F(",\"p99\":");
+        *aJson += String(hist->getPercentile(99));
+        *aJson += F(",\"max\":");
+        *aJson += String(hist->getMax());
+        *aJson += F(",\"buckets\":[");
+        // the buckets up to the last used one
+        int8_t last = LATENCY_HIST_BUCKETS-1;
+        while (last > 0 && hist->getBucket(last) == 0) {
+          last--;
+        }
+        for (int8_t b=0; b<=last; b++) {
+          if (b > 0) {
+            *aJson += F(",");
+          }
+          *aJson += String(hist->getBucket(b));
+        }
+        *aJson += F("]}");
+      }
+      *aJson += F("]");
+    }
+
+  private:
+    typedef struct {
+      const char* name;
+      uint32_t start;  // cycle count of start()
+      LatencyHistogram hist;
+    } Probe;
+
+    Probe myProbes[F3X_PERF_PROBES_MAX];
+    uint8_t myCount;
+};
+
+#endif
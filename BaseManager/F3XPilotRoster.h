@@ -0,0 +1,245 @@
+#ifndef F3XPilotRoster_h
+#define F3XPilotRoster_h
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <Logger.h>
+#include "F3XFixedDistanceTaskData.h"
+
+#define F3X_PILOTS_MAX        32
+#define F3X_PILOT_NAME_LEN    16
+#define F3X_ROUNDS_MAX       250
+#define F3X_ROSTER_FILE      "/pilots.txt"    // one pilot per line: <name>;<group>
+#define F3X_SCHEDULE_FILE    "/schedule.txt"  // <round>;<position in the start order>;<roster generation>
+
+/**
+ * the pilots of a training day or competition and the schedule of their runs. The start order
+ * of a round is the order of the roster, grouped by the group of the pilots (group 1 first).
+ * After each finished run the schedule advances to the next pilot, after the last pilot of the
+ * start order to the next round.
+ * The schedule is kept in RAM and only marked dirty on a change, it is saved by save() from the
+ * loop, not by the signal listener.
+ * The runs refer to a pilot by the index in the roster, so each new roster gets the next
+ * generation, which is stored with the runs. Generation 0 is the roster of the runs logged before
+ * there were generations.
+ */
+class F3XPilotRoster {
+  public:
+    F3XPilotRoster() {
+      myCount = 0;
+      myRound = 1;
+      myPosition = 0;
+      myGeneration = 0;
+      myDirty = false;
+    }
+
+    /**
+     * read roster and schedule from the file system
+     */
+    void load() {
+      File file = LittleFS.open(F3X_ROSTER_FILE, "r");
+      String text;
+      if (file) {
+        text = file.readString();
+        file.close();
+      }
+      parse(text);
+      file = LittleFS.open(F3X_SCHEDULE_FILE, "r");
+      if (file) {
+        String line = file.readStringUntil('\n');
+        file.close();
+        int sep = line.indexOf(';');
+        int sep2 = sep > 0 ? line.indexOf(';', sep+1) : -1;
+        myRound = constrain(line.substring(0, sep).toInt(), 1, F3X_ROUNDS_MAX);
+        myPosition = sep > 0 ? line.substring(sep+1, sep2 > 0 ? sep2 : line.length()).toInt() : 0;
+        myGeneration = sep2 > 0 ? line.substring(sep2+1).toInt() : 0;
+        if (myPosition >= myCount) {
+          myPosition = 0;
+        }
+      }
+      logMsg(LOG_MOD_TASKDATA, INFO, String(F("pilot roster: ")) + String(myCount) + F(" pilots, round: ") + String(myRound));
+    }
+
+    /**
+     * replace the roster by aText (one pilot per line: <name>;<group>, group 1 if missing),
+     * the schedule starts again with round 1 and the next roster generation
+     */
+    boolean setPilots(const String& aText) {
+      parse(aText);
+      File file = LittleFS.open(F3X_ROSTER_FILE, "w");
+      if (!file) {
+        logMsg(LOG_MOD_TASKDATA, ERROR, F("cannot write pilot roster"));
+        return false;
+      }
+      for (uint8_t i=0; i<myCount; i++) {
+        file.print(myPilots[i].name + F(";") + String(myPilots[i].group) + F("\n"));
+      }
+      file.close();
+      // 0 is kept for the runs without generation
+      myGeneration = myGeneration == UINT8_MAX ? 1 : myGeneration+1;
+      reset();
+      // roster and generation must not get out of sync by a reset
+      save();
+      return true;
+    }
+
+    /**
+     * true, if runs are scheduled for pilots
+     */
+    boolean isActive() {
+      return myCount > 0;
+    }
+
+    uint8_t getCount() {
+      return myCount;
+    }
+
+    const String& getName(uint8_t aPilot) {
+      static const String none;
+      return aPilot < myCount ? myPilots[aPilot].name : none;
+    }
+
+    uint8_t getGroup(uint8_t aPilot) {
+      return aPilot < myCount ? myPilots[aPilot].group : 0;
+    }
+
+    uint8_t getRound() {
+      return myRound;
+    }
+
+    /**
+     * generation of the roster, the pilot indices of the runs of another generation refer to
+     * another roster
+     */
+    uint8_t getGeneration() {
+      return myGeneration;
+    }
+
+    /**
+     * position of the current pilot in the start order of the round
+     */
+    uint8_t getPosition() {
+      return myPosition;
+    }
+
+    /**
+     * index of the pilot of the next run or F3X_PILOT_NONE
+     */
+    uint8_t getCurrentPilot() {
+      return myCount == 0 ? F3X_PILOT_NONE : myOrder[myPosition];
+    }
+
+    /**
+     * index of the pilot at aPosition of the start order
+     */
+    uint8_t getPilotAt(uint8_t aPosition) {
+      return aPosition < myCount ? myOrder[aPosition] : F3X_PILOT_NONE;
+    }
+
+    void next() {
+      if (myCount == 0) {
+        return;
+      }
+      if (++myPosition >= myCount) {
+        myPosition = 0;
+        if (myRound < F3X_ROUNDS_MAX) {
+          myRound++;
+        }
+      }
+      myDirty = true;
+    }
+
+    void previous() {
+      if (myCount == 0) {
+        return;
+      }
+      if (myPosition > 0) {
+        myPosition--;
+      } else if (myRound > 1) {
+        myRound--;
+        myPosition = myCount-1;
+      }
+      myDirty = true;
+    }
+
+    void reset() {
+      myRound = 1;
+      myPosition = 0;
+      myDirty = true;
+    }
+
+    /**
+     * write the schedule, if it was changed
+     */
+    void save() {
+      if (!myDirty) {
+        return;
+      }
+      myDirty = false;
+      File file = LittleFS.open(F3X_SCHEDULE_FILE, "w");
+      if (!file) {
+        logMsg(LOG_MOD_TASKDATA, ERROR, F("cannot write schedule"));
+        return;
+      }
+      file.print(String(myRound) + F(";") + String(myPosition) + F(";") + String(myGeneration) + F("\n"));
+      file.close();
+    }
+
+  private:
+    typedef struct {
+      String name;
+      uint8_t group;
+    } Pilot;
+
+    void parse(const String& aText) {
+      myCount = 0;
+      int start = 0;
+      while (start < (int) aText.length() && myCount < F3X_PILOTS_MAX) {
+        int end = aText.indexOf('\n', start);
+        if (end < 0) {
+          end = aText.length();
+        }
+        String line = aText.substring(start, end);
+        start = end + 1;
+        line.trim();
+        int sep = line.indexOf(';');
+        String name = sep < 0 ? line : line.substring(0, sep);
+        name.trim();
+        if (name.length() == 0) {
+          continue;
+        }
+        if (name.length() > F3X_PILOT_NAME_LEN) {
+          name = name.substring(0, F3X_PILOT_NAME_LEN);
+        }
+        // the names are sent as CSV and JSON
+        name.replace(';', ',');
+        name.replace('"', '\'');
+        name.replace('\\', '/');
+        Pilot* pilot = &myPilots[myCount++];
+        pilot->name = name;
+        pilot->group = sep < 0 ? 1 : constrain(line.substring(sep+1).toInt(), 1, 99);
+      }
+      // start order: by group, within a group in the order of the roster
+      uint8_t pos = 0;
+      for (uint8_t group=1; group<=99 && pos<myCount; group++) {
+        for (uint8_t i=0; i<myCount; i++) {
+          if (myPilots[i].group == group) {
+            myOrder[pos++] = i;
+          }
+        }
+      }
+      if (myPosition >= myCount) {
+        myPosition = 0;
+      }
+    }
+
+    Pilot myPilots[F3X_PILOTS_MAX];
+    uint8_t myOrder[F3X_PILOTS_MAX];
+    uint8_t myCount;
+    uint8_t myRound;
+    uint8_t myPosition;
+    uint8_t myGeneration;
+    boolean myDirty;
+};
+
+#endif
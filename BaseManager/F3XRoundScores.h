@@ -0,0 +1,186 @@
+#ifndef F3XRoundScores_h
+#define F3XRoundScores_h
+
+#include <Arduino.h>
+#include "F3XFixedDistanceTaskData.h"
+#include "F3XPilotRoster.h"
+
+#define F3X_SCORES_GROW  F3X_PILOTS_MAX  // round times added per allocation
+
+/**
+ * normalised scores of the scheduled runs of one task type: in each round and group the fastest
+ * pilot gets 1000 points, the others 1000 * best time / own time. If a pilot flies more than once
+ * in a round, the best run counts, also if the round is flown again later (reflight after
+ * "previous" of the schedule, a reset schedule, the runs read from the run log at boot).
+ * The best time of each pilot and round is kept, a run is added by a search of its round time
+ * without reading the run log again. The totals are summed up on the next read after a change.
+ * Only the runs of the current roster generation are scored, the pilot index of older runs
+ * refers to another roster.
+ */
+class F3XRoundScores {
+  public:
+    F3XRoundScores() {
+      myRoster = 0;
+      myTimes = nullptr;
+      myCapacity = 0;
+      reset();
+    }
+
+    /**
+     * start the scores of the roster generation aRoster, no run is scored yet
+     */
+    void setRoster(uint8_t aRoster) {
+      myRoster = aRoster;
+      reset();
+    }
+
+    void reset() {
+      myRound = 0;
+      myRoundCount = 0;
+      myTimeCount = 0;
+      myChanged = false;
+      for (uint8_t i=0; i<F3X_PILOTS_MAX; i++) {
+        myTotal[i] = 0.0f;
+        myBestTime[i] = 0;
+      }
+    }
+
+    void add(const F3XRunRecord* aRecord) {
+      if (aRecord->pilot >= F3X_PILOTS_MAX || aRecord->round == 0 || aRecord->legNumber == 0 || aRecord->roster != myRoster) {
+        return;
+      }
+      uint8_t pilot = aRecord->pilot;
+      uint32_t time = aRecord->courseTime[aRecord->legNumber-1];
+      myRound = aRecord->round;
+      if (myBestTime[pilot] == 0 || time < myBestTime[pilot]) {
+        myBestTime[pilot] = time;
+      }
+      RoundTime* roundTime = find(myRound, pilot);
+      if (roundTime == nullptr) {
+        if (myTimeCount == myCapacity) {
+          RoundTime* times = (RoundTime*) realloc(myTimes, sizeof(RoundTime) * (myCapacity + F3X_SCORES_GROW));
+          if (times == nullptr) {
+            logMsg(LOG_MOD_TASKDATA, ERROR, F("no memory for the round scores"));
+            return;
+          }
+          myTimes = times;
+          myCapacity += F3X_SCORES_GROW;
+        }
+        roundTime = &myTimes[myTimeCount++];
+        roundTime->round = myRound;
+        roundTime->pilot = pilot;
+        roundTime->time = 0;
+      }
+      if (roundTime->time == 0 || time < roundTime->time) {
+        roundTime->time = time;
+        roundTime->group = aRecord->group;
+      }
+      myChanged = true;
+    }
+
+    /**
+     * the round of the last added run, 0 if there is none
+     */
+    uint8_t getRound() {
+      return myRound;
+    }
+
+    /**
+     * number of rounds with scored runs
+     */
+    uint8_t getRoundCount() {
+      sumUp();
+      return myRoundCount;
+    }
+
+    /**
+     * course time of aPilot in the current round in ms, 0 if not flown yet
+     */
+    uint32_t getRoundTime(uint8_t aPilot) {
+      RoundTime* roundTime = find(myRound, aPilot);
+      return roundTime != nullptr ? roundTime->time : 0;
+    }
+
+    float getRoundScore(uint8_t aPilot) {
+      RoundTime* roundTime = find(myRound, aPilot);
+      return roundTime != nullptr ? getScore(roundTime) : 0.0f;
+    }
+
+    /**
+     * sum of the scores of all rounds including the current one
+     */
+    float getTotalScore(uint8_t aPilot) {
+      sumUp();
+      return aPilot < F3X_PILOTS_MAX ? myTotal[aPilot] : 0.0f;
+    }
+
+    /**
+     * personal best course time of aPilot in ms, 0 if not flown yet
+     */
+    uint32_t getBestTime(uint8_t aPilot) {
+      return aPilot < F3X_PILOTS_MAX ? myBestTime[aPilot] : 0;
+    }
+
+  private:
+    typedef struct {
+      uint8_t round;
+      uint8_t pilot;
+      uint8_t group;
+      uint32_t time;  // best course time of the pilot in the round
+    } RoundTime;
+
+    RoundTime* find(uint8_t aRound, uint8_t aPilot) {
+      for (uint16_t i=0; i<myTimeCount; i++) {
+        if (myTimes[i].round == aRound && myTimes[i].pilot == aPilot) {
+          return &myTimes[i];
+        }
+      }
+      return nullptr;
+    }
+
+    float getScore(RoundTime* aRoundTime) {
+      uint32_t best = aRoundTime->time;
+      for (uint16_t i=0; i<myTimeCount; i++) {
+        if (myTimes[i].round == aRoundTime->round && myTimes[i].group == aRoundTime->group && myTimes[i].time < best) {
+          best = myTimes[i].time;
+        }
+      }
+      return 1000.0f * best / aRoundTime->time;
+    }
+
+    /**
+     * totals and number of rounds of the round times, if a run was added since the last call
+     */
+    void sumUp() {
+      if (!myChanged) {
+        return;
+      }
+      myChanged = false;
+      for (uint8_t i=0; i<F3X_PILOTS_MAX; i++) {
+        myTotal[i] = 0.0f;
+      }
+      myRoundCount = 0;
+      for (uint16_t i=0; i<myTimeCount; i++) {
+        myTotal[myTimes[i].pilot] += getScore(&myTimes[i]);
+        boolean counted = false;
+        for (uint16_t j=0; j<i && !counted; j++) {
+          counted = myTimes[j].round == myTimes[i].round;
+        }
+        if (!counted) {
+          myRoundCount++;
+        }
+      }
+    }
+
+    uint8_t myRoster;
+    uint8_t myRound;
+    uint8_t myRoundCount;
+    boolean myChanged;
+    RoundTime* myTimes;
+    uint16_t myTimeCount;
+    uint16_t myCapacity;
+    float myTotal[F3X_PILOTS_MAX];
+    uint32_t myBestTime[F3X_PILOTS_MAX];
+};
+
+#endif
@@ -0,0 +1,185 @@
+#ifndef F3XRunStatistics_h
+#define F3XRunStatistics_h
+
+#include <Arduino.h>
+#include "F3XFixedDistanceTaskData.h"
+
+#define F3X_STATS_BINS          128  // bins of the course time histogram, the last bin takes all longer times
+#define F3X_STATS_TREND_WEIGHT    4  // weight 1/n of the last run in the recent course time
+#define F3X_STATS_TREND_LIMIT    10  // per mille, difference of the recent to the average course time shown as trend
+
+/**
+ * running aggregates of the stored runs of one task type (e.g. all runs or the runs of a session).
+ * Each finished run is added in constant time, nothing has to be read from the run log again:
+ * best and average course time, best leg time and average dead time/distance per leg position,
+ * a histogram of the course times for percentiles, and the recent course time (EWMA) as trend.
+ */
+class F3XRunStatistics {
+  public:
+    /**
+     * aBinWidth: width of a histogram bin in ms, the resolution of the percentiles
+     */
+    F3XRunStatistics(uint16_t aBinWidth) {
+      myBinWidth = aBinWidth;
+      reset();
+    }
+
+    void reset() {
+      myCount = 0;
+      myBestCourseTime = 0;
+      myBestRunNo = 0;
+      myMaxCourseTime = 0;
+      myCourseTimeSum = 0;
+      myRecentCourseTime = 0;
+      for (uint8_t i=0; i<F3X_RUN_LEGS_MAX; i++) {
+        myBestLegTime[i] = 0;
+        myDeadTimeSum[i] = 0;
+        myDeadDistanceSum[i] = 0;
+        myDeadCount[i] = 0;
+      }
+      for (uint8_t i=0; i<F3X_STATS_BINS; i++) {
+        myBins[i] = 0;
+      }
+    }
+
+    void add(const F3XRunRecord* aRecord) {
+      if (aRecord->legNumber == 0) {
+        return;
+      }
+      uint32_t courseTime = aRecord->courseTime[aRecord->legNumber-1];
+      myCount++;
+      myCourseTimeSum += courseTime;
+      if (myBestCourseTime == 0 || courseTime < myBestCourseTime) {
+        myBestCourseTime = courseTime;
+        myBestRunNo = aRecord->runNo;
+      }
+      if (courseTime > myMaxCourseTime) {
+        myMaxCourseTime = courseTime;
+      }
+      myRecentCourseTime = myCount == 1 ? courseTime
+        : myRecentCourseTime + ((float) courseTime - myRecentCourseTime) / F3X_STATS_TREND_WEIGHT;
+      uint32_t bin = courseTime / myBinWidth;
+      bin = bin < F3X_STATS_BINS ? bin : F3X_STATS_BINS-1;
+      if (myBins[bin] < UINT16_MAX) {
+        myBins[bin]++;
+      }
+      for (uint8_t i=0; i<aRecord->legNumber; i++) {
+        uint32_t legTime = F3XFixedDistanceTaskData::getLegTime(aRecord, i);
+        if (myBestLegTime[i] == 0 || legTime < myBestLegTime[i]) {
+          myBestLegTime[i] = legTime;
+        }
+        if (aRecord->deadTime[i] != 0) {
+          myDeadTimeSum[i] += aRecord->deadTime[i];
+          myDeadDistanceSum[i] += F3XFixedDistanceTaskData::getDeadDistance(aRecord, i);
+          myDeadCount[i]++;
+        }
+      }
+    }
+
+    uint16_t getCount() {
+      return myCount;
+    }
+
+    /**
+     * best course time in ms, 0 if there is no run
+     */
+    uint32_t getBestCourseTime() {
+      return myBestCourseTime;
+    }
+
+    uint16_t getBestRunNo() {
+      return myBestRunNo;
+    }
+
+    uint32_t getAvgCourseTime() {
+      return myCount == 0 ? 0 : myCourseTimeSum / myCount;
+    }
+
+    /**
+     * the upper limit of the bin containing the aPercent percentile of the course times in ms
+     */
+    uint32_t getPercentile(uint8_t aPercent) {
+      if (myCount == 0) {
+        return 0;
+      }
+      uint32_t rank = ((uint32_t) myCount * aPercent + 99) / 100;
+      uint32_t sum = 0;
+      for (uint8_t i=0; i<F3X_STATS_BINS; i++) {
+        sum += myBins[i];
+        if (sum >= rank) {
+          uint32_t upper = (uint32_t) (i+1) * myBinWidth;
+          return (i == F3X_STATS_BINS-1 || upper > myMaxCourseTime) ? myMaxCourseTime : upper;
+        }
+      }
+      return myMaxCourseTime;
+    }
+
+    /**
+     * course time of the recent runs in ms, weighted to the last runs
+     */
+    uint32_t getRecentCourseTime() {
+      return myRecentCourseTime;
+    }
+
+    /**
+     * '+': the recent runs are faster than the average, '-': slower, '=': about the average
+     */
+    char getTrendChar() {
+      uint32_t avg = getAvgCourseTime();
+      if (myCount < 2 || avg == 0) {
+        return '=';
+      }
+      float diff = (myRecentCourseTime - avg) * 1000 / avg;
+      if (diff < -F3X_STATS_TREND_LIMIT) {
+        return '+';
+      }
+      if (diff > F3X_STATS_TREND_LIMIT) {
+        return '-';
+      }
+      return '=';
+    }
+
+    /**
+     * best time of leg aIdx in ms, 0 if not flown
+     */
+    uint32_t getBestLegTime(uint8_t aIdx) {
+      return aIdx < F3X_RUN_LEGS_MAX ? myBestLegTime[aIdx] : 0;
+    }
+
+    /**
+     * average dead time in ms of the turns with dead time after leg aIdx
+     */
+    uint32_t getAvgDeadTime(uint8_t aIdx) {
+      return (aIdx >= F3X_RUN_LEGS_MAX || myDeadCount[aIdx] == 0) ? 0 : myDeadTimeSum[aIdx] / myDeadCount[aIdx];
+    }
+
+    /**
+     * average dead distance in m of the turns with dead time after leg aIdx
+     */
+    float getAvgDeadDistance(uint8_t aIdx) {
+      return (aIdx >= F3X_RUN_LEGS_MAX || myDeadCount[aIdx] == 0) ? 0.0f : (float) myDeadDistanceSum[aIdx] / myDeadCount[aIdx];
+    }
+
+    /**
+     * number of turns with dead time after leg aIdx
+     */
+    uint16_t getDeadCount(uint8_t aIdx) {
+      return aIdx < F3X_RUN_LEGS_MAX ? myDeadCount[aIdx] : 0;
+    }
+
+  private:
+    uint16_t myBinWidth;
+    uint16_t myCount;
+    uint32_t myBestCourseTime;
+    uint16_t myBestRunNo;
+    uint32_t myMaxCourseTime;
+    uint32_t myCourseTimeSum;
+    float myRecentCourseTime;
+    uint32_t myBestLegTime[F3X_RUN_LEGS_MAX];
+    uint32_t myDeadTimeSum[F3X_RUN_LEGS_MAX];
+    uint32_t myDeadDistanceSum[F3X_RUN_LEGS_MAX];
+    uint16_t myDeadCount[F3X_RUN_LEGS_MAX];
+    uint16_t myBins[F3X_STATS_BINS];
+};
+
+#endif
@@ -0,0 +1,201 @@
+#ifndef F3XRunWriteQueue_h
+#define F3XRunWriteQueue_h
+
+#include <Arduino.h>
+#include "F3XFixedDistanceTaskData.h"
+
+#define F3X_RUN_QUEUE_SIZE            4      // finished runs waiting to be written
+#define F3X_RUN_QUEUE_TASKS           4      // task data objects (F3BSpeed, F3F of each course)
+#define F3X_RUN_QUEUE_RTC_OFFSET     32      // in blocks of 4 bytes, the first 128 bytes of the RTC user memory are used by OTA
+#define F3X_RUN_QUEUE_MAX_DELAY   60000      // ms, after which a run is written even if the loop is not idle
+
+/**
+ * write behind of the finished runs: the signal listener only takes a snapshot of the task into
+ * a F3XRunRecord, the record is written to the run log later from the loop, if it is idle (no
+ * course flown, no signal pending).
+ * Each pending record is mirrored into the RTC user memory, which survives a reset (watchdog,
+ * exception, restart), but no power loss. On boot replay() appends the mirrored records, whose
+ * run number is behind the last run of the run log, so a run is neither lost nor written twice.
+ */
+class F3XRunWriteQueue {
+  public:
+    F3XRunWriteQueue() {
+      myDataCount = 0;
+      myHead = 0;
+      myCount = 0;
+      myReplayCnt = 0;
+      myWriteCnt = 0;
+    }
+
+    void addTaskData(F3XFixedDistanceTaskData* aData) {
+      if (myDataCount < F3X_RUN_QUEUE_TASKS) {
+        myData[myDataCount++] = aData;
+      }
+    }
+
+    /**
+     * append the records left in the RTC memory by the last reset, must be called after the
+     * init() of the task data. Returns the number of replayed runs.
+     */
+    uint8_t replay() {
+      uint8_t cnt = 0;
+      boolean replayed[F3X_RUN_QUEUE_SIZE];
+      for (uint8_t i=0; i<F3X_RUN_QUEUE_SIZE; i++) {
+        replayed[i] = !readSlot(i, &mySlots[i]);
+      }
+      // oldest first, to keep the run log in order
+      while (true) {
+        int8_t next = -1;
+        for (uint8_t i=0; i<F3X_RUN_QUEUE_SIZE; i++) {
+          if (!replayed[i] && (next < 0 || mySlots[i].runNo < mySlots[next].runNo)) {
+            next = i;
+          }
+        }
+        if (next < 0) {
+          break;
+        }
+        replayed[next] = true;
+        F3XRunRecord* record = &mySlots[next];
+        F3XFixedDistanceTaskData* data = getData(record->course, record->type);
+        if (data != nullptr && record->runNo > data->getLastRunNo() && data->appendRecord(record)) {
+          logMsg(LOG_MOD_TASKDATA, WARNING, String(F("run replayed after reset: ")) + String(record->runNo));
+          cnt++;
+        }
+      }
+      for (uint8_t i=0; i<F3X_RUN_QUEUE_SIZE; i++) {
+        clearSlot(i);
+      }
+      myHead = 0;
+      myCount = 0;
+      myReplayCnt += cnt;
+      return cnt;
+    }
+
+    /**
+     * snapshot the finished task of aData, tagged with pilot, round, group and roster generation (see
+     * F3XFixedDistanceTaskData::createRecord()), and return the snapshot. If the queue is full,
+     * the oldest run is written at once.
+     */
+    const F3XRunRecord* push(F3XFixedDistanceTaskData* aData, uint8_t aPilot=F3X_PILOT_NONE, uint8_t aRound=0, uint8_t aGroup=0, uint8_t aRoster=0) {
+      if (myCount == F3X_RUN_QUEUE_SIZE) {
+        logMsg(LOG_MOD_TASKDATA, WARNING, F("run write queue full"));
+        writeNext();
+      }
+      uint8_t idx = (myHead + myCount) % F3X_RUN_QUEUE_SIZE;
+      aData->createRecord(&mySlots[idx], aPilot, aRound, aGroup, aRoster);
+      myPushTime[idx] = millis();
+      writeSlot(idx);
+      myCount++;
+      return &mySlots[idx];
+    }
+
+    /**
+     * write the oldest pending run, if aIdle is set or it is pending longer than
+     * F3X_RUN_QUEUE_MAX_DELAY. Only one run is written per call.
+     */
+    boolean update(boolean aIdle) {
+      if (myCount == 0 || (!aIdle && millis() - myPushTime[myHead] < F3X_RUN_QUEUE_MAX_DELAY)) {
+        return false;
+      }
+      writeNext();
+      return true;
+    }
+
+    /**
+     * drop the pending runs of aData, e.g. if its run log is removed
+     */
+    void discard(F3XFixedDistanceTaskData* aData) {
+      uint8_t cnt = myCount;
+      for (uint8_t i=0; i<cnt; i++) {
+        uint8_t idx = myHead;
+        F3XRunRecord record = mySlots[idx];
+        clearSlot(idx);
+        myHead = (myHead + 1) % F3X_RUN_QUEUE_SIZE;
+        myCount--;
+        if (record.course != aData->getCourse() || record.type != aData->getType()) {
+          // keep it, appended at the end in the same order
+          uint8_t tail = (myHead + myCount) % F3X_RUN_QUEUE_SIZE;
+          mySlots[tail] = record;
+          myPushTime[tail] = myPushTime[idx];
+          writeSlot(tail);
+          myCount++;
+        }
+      }
+    }
+
+    uint8_t getPendingCount() {
+      return myCount;
+    }
+
+    uint16_t getWriteCount() {
+      return myWriteCnt;
+    }
+
+    uint16_t getReplayCount() {
+      return myReplayCnt;
+    }
+
+  private:
+    // the RTC memory is written in blocks of 4 bytes
+    static_assert(sizeof(F3XRunRecord) % 4 == 0, "size of F3XRunRecord is not a multiple of 4");
+
+    uint32_t getRtcOffset(uint8_t aIdx) {
+      return F3X_RUN_QUEUE_RTC_OFFSET + aIdx * (sizeof(F3XRunRecord) / 4);
+    }
+
+    // the packed F3XRunRecord is copied through a word aligned buffer, the RTC memory is
+    // accessed by 32 bit words
+    typedef uint32_t RtcBlocks[sizeof(F3XRunRecord) / 4];
+
+    boolean readSlot(uint8_t aIdx, F3XRunRecord* aRecord) {
+      RtcBlocks blocks;
+      if (!ESP.rtcUserMemoryRead(getRtcOffset(aIdx), blocks, sizeof(blocks))) {
+        return false;
+      }
+      memcpy(aRecord, blocks, sizeof(F3XRunRecord));
+      return F3XFixedDistanceTaskData::isValid(aRecord);
+    }
+
+    void writeSlot(uint8_t aIdx) {
+      RtcBlocks blocks;
+      memcpy(blocks, &mySlots[aIdx], sizeof(F3XRunRecord));
+      ESP.rtcUserMemoryWrite(getRtcOffset(aIdx), blocks, sizeof(blocks));
+    }
+
+    void clearSlot(uint8_t aIdx) {
+      uint32_t zero = 0; // invalidates the magic of the record
+      ESP.rtcUserMemoryWrite(getRtcOffset(aIdx), &zero, sizeof(zero));
+    }
+
+    F3XFixedDistanceTaskData* getData(uint8_t aCourse, uint8_t aType) {
+      for (uint8_t i=0; i<myDataCount; i++) {
+        if (myData[i]->getCourse() == aCourse && myData[i]->getType() == aType) {
+          return myData[i];
+        }
+      }
+      return nullptr;
+    }
+
+    void writeNext() {
+      F3XRunRecord* record = &mySlots[myHead];
+      F3XFixedDistanceTaskData* data = getData(record->course, record->type);
+      if (data != nullptr && data->appendRecord(record)) {
+        myWriteCnt++;
+      }
+      // the slot is released even if the write failed, a retry would block the queue
+      clearSlot(myHead);
+      myHead = (myHead + 1) % F3X_RUN_QUEUE_SIZE;
+      myCount--;
+    }
+
+    F3XFixedDistanceTaskData* myData[F3X_RUN_QUEUE_TASKS];
+    uint8_t myDataCount;
+    F3XRunRecord mySlots[F3X_RUN_QUEUE_SIZE];
+    unsigned long myPushTime[F3X_RUN_QUEUE_SIZE];
+    uint8_t myHead;
+    uint8_t myCount;
+    uint16_t myReplayCnt;
+    uint16_t myWriteCnt;
+};
+
+#endif
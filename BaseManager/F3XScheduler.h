@@ -0,0 +1,212 @@
+#ifndef F3XScheduler_h
+#define F3XScheduler_h
+
+#include <Arduino.h>
+#include <Logger.h>
+#include "F3XLogFormats.h"
+#include "F3XPerfProbes.h"
+
+#define F3X_SCHED_TASKS_MAX         16
+#define F3X_SCHED_MAX_DEFER_MS    1000  // a yielding task runs at the latest this long after its deadline
+#define F3X_SCHED_LOG_INTERVAL    1000  // ms, minimum time between two overrun messages of a task
+
+/**
+ * deadline based cooperative scheduler of the loop. Each task has a priority, a period (0: every
+ * loop) and a time budget. Per loop the due tasks are run by priority, within a priority by the
+ * earliest deadline.
+ * The critical tasks (signal handling, radio) always run. The other tasks yield, if a signal is
+ * pending (see setPreemptCheck()) or their budget does not fit into the rest of the loop budget.
+ * A yielding task stays due and runs in one of the next loops, at the latest
+ * F3X_SCHED_MAX_DEFER_MS after its deadline.
+ * The run time of each task and the loop time are recorded by a probe of the same name in
+ * F3XPerfProbes, a run longer than the budget of the task is counted and logged as overrun, a
+ * loop longer than the loop budget as slow loop.
+ */
+class F3XScheduler {
+  public:
+    typedef void (*TaskFunction)(unsigned long aNow);
+    typedef boolean (*PreemptCheck)();
+    typedef enum {
+      PrioCritical = 0,
+      PrioHigh,
+      PrioNormal,
+      PrioLow,
+    } Priority;
+
+    /**
+     * aProbes: the probes of the tasks, aLoopBudget: time in us a loop should take at most
+     */
+    F3XScheduler(F3XPerfProbes* aProbes, uint32_t aLoopBudget) {
+      myProbes = aProbes;
+      myLoopProbe = aProbes->add("loop");
+      myLoopBudget = aLoopBudget;
+      myCount = 0;
+      myPass = 0;
+      myPreemptCheck = nullptr;
+      myLastRun = 0;
+      mySlowLoops = 0;
+      myLastSlowLog = 0;
+    }
+
+    /**
+     * add a task, aPeriod: ms between two runs, 0: every loop, aBudget: expected run time in us
+     */
+    boolean add(const char* aName, TaskFunction aFunction, Priority aPrio, uint16_t aPeriod, uint32_t aBudget) {
+      if (myCount == F3X_SCHED_TASKS_MAX) {
+        logMsg(LOG_MOD_PERF, ERROR, String(F("too many scheduler tasks: ")) + aName);
+        return false;
+      }
+      Task* task = &myTasks[myCount++];
+      task->name = aName;
+      task->function = aFunction;
+      task->prio = aPrio;
+      task->period = aPeriod;
+      task->budget = aBudget;
+      task->deadline = millis();
+      task->pass = myPass;
+      task->probe = myProbes->add(aName);
+      task->overruns = 0;
+      task->deferred = 0;
+      task->lastLog = 0;
+      return true;
+    }
+
+    /**
+     * aCheck returns true, if a time critical event is waiting (e.g. a captured signal), then all
+     * not critical tasks yield
+     */
+    void setPreemptCheck(PreemptCheck aCheck) {
+      myPreemptCheck = aCheck;
+    }
+
+    /**
+     * one loop: run the due tasks
+     */
+    void run(unsigned long aNow) {
+      uint32_t start = micros();
+      if (myLastRun != 0) {
+        uint32_t loopTime = start - myLastRun;
+        myProbes->record(myLoopProbe, loopTime);
+        if (loopTime > myLoopBudget) {
+          mySlowLoops++;
+          if (aNow - myLastSlowLog >= F3X_SCHED_LOG_INTERVAL) {
+            myLastSlowLog = aNow;
+            logEvent(LOG_MOD_PERF, WARNING, LogFmtSchedSlowLoop, loopTime/1000);
+          }
+        }
+      }
+      myLastRun = start;
+      myPass++;
+      while (true) {
+        Task* next = nullptr;
+        for (uint8_t i=0; i<myCount; i++) {
+          Task* task = &myTasks[i];
+          if (task->pass == myPass || (long) (aNow - task->deadline) < 0) {
+            continue;
+          }
+          if (next == nullptr || task->prio < next->prio
+              || (task->prio == next->prio && (long) (task->deadline - next->deadline) < 0)) {
+            next = task;
+          }
+        }
+        if (next == nullptr) {
+          break;
+        }
+        next->pass = myPass;
+        if (next->prio != PrioCritical && mustYield(next, start, aNow)) {
+          next->deferred++;
+          continue;
+        }
+        execute(next, aNow);
+      }
+    }
+
+    /**
+     * run time of the tasks: name:p50/p99/max in ms (overruns/deferred runs), and of the loop
+     */
+    String getInfo() {
+      String info;
+      for (uint8_t i=0; i<myCount; i++) {
+        Task* task = &myTasks[i];
+        info += String(task->name) + F(":") + getLatencyStr(myProbes->getHistogram(task->probe))
+          + F("(") + String(task->overruns) + F("/") + String(task->deferred) + F(") ");
+      }
+      info += String(F("loop:")) + getLatencyStr(myProbes->getHistogram(myLoopProbe)) + F("(") + String(mySlowLoops) + F(")");
+      return info;
+    }
+
+    /**
+     * reset the counters of the scheduler, the probes are reset by F3XPerfProbes::reset()
+     */
+    void resetStatistics() {
+      for (uint8_t i=0; i<myCount; i++) {
+        myTasks[i].overruns = 0;
+        myTasks[i].deferred = 0;
+      }
+      mySlowLoops = 0;
+    }
+
+  private:
+    typedef struct {
+      const char* name;
+      TaskFunction function;
+      Priority prio;
+      uint16_t period;
+      uint32_t budget;
+      unsigned long deadline; // ms, the task is due from then on
+      uint16_t pass;          // loop in which the task was run or deferred last
+      uint8_t probe;
+      uint16_t overruns;
+      uint16_t deferred;
+      unsigned long lastLog;
+    } Task;
+
+    boolean mustYield(Task* aTask, uint32_t aStart, unsigned long aNow) {
+      // the cap goes first, otherwise a steady stream of signals starves the yielding tasks
+      if ((long) (aNow - aTask->deadline) >= F3X_SCHED_MAX_DEFER_MS) {
+        return false;
+      }
+      if (myPreemptCheck != nullptr && myPreemptCheck()) {
+        return true;
+      }
+      return (micros() - aStart) + aTask->budget > myLoopBudget;
+    }
+
+    void execute(Task* aTask, unsigned long aNow) {
+      myProbes->start(aTask->probe);
+      aTask->function(aNow);
+      uint32_t duration = myProbes->stop(aTask->probe);
+      aTask->deadline = aNow + aTask->period;
+      if (duration > aTask->budget) {
+        if (aTask->overruns < UINT16_MAX) {
+          aTask->overruns++;
+        }
+        if (aNow - aTask->lastLog >= F3X_SCHED_LOG_INTERVAL) {
+          aTask->lastLog = aNow;
+          logEvent(LOG_MOD_PERF, DEBUG, LogFmtSchedOverrun, aTask->name, duration, aTask->budget);
+        }
+      }
+    }
+
+    static String getLatencyStr(LatencyHistogram* aHist) {
+      if (aHist == nullptr) {
+        return String(F("-"));
+      }
+      return String(aHist->getPercentile(50)/1000.0f, 1) + F("/")
+        + String(aHist->getPercentile(99)/1000.0f, 1) + F("/")
+        + String(aHist->getMax()/1000.0f, 1);
+    }
+
+    F3XPerfProbes* myProbes;
+    uint8_t myLoopProbe;
+    Task myTasks[F3X_SCHED_TASKS_MAX];
+    uint8_t myCount;
+    uint16_t myPass;
+    uint32_t myLoopBudget;
+    PreemptCheck myPreemptCheck;
+    uint32_t myLastRun;
+    uint16_t mySlowLoops;
+    unsigned long myLastSlowLog;
+};
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef F3XTaskStateTracker_h
+#define F3XTaskStateTracker_h
+
+#include <Arduino.h>
+#include "F3XFixedDistanceTask.h"
+
+#define F3X_TRACKED_LEGS_MAX 10  // legs of a F3F task
+
+/**
+ * versioning of the task state for the delta protocol of /api/task.
+ * The version is incremented with each observed change (task state, signalled leg, leg time,
+ * dead distance of a leg), the version of the last change of each leg is kept, so a client with
+ * version V only gets the legs changed after V. If the legs were reset (new task, other task
+ * type, new run) after V, the client gets the complete state.
+ * update() compares the task with the state of the last update(), a reset in between is seen
+ * by the reset count of the task, so it only has to be called before the state is sent.
+ */
+class F3XTaskStateTracker {
+  public:
+    F3XTaskStateTracker() {
+      myTask = nullptr;
+      myResetCount = 0;
+      myVersion = 0;
+      myResetVersion = 0;
+      myState = F3XFixedDistanceTask::TaskNotSet;
+      myLegCount = F3X_COURSE_INIT;
+      for (uint8_t i=0; i<F3X_TRACKED_LEGS_MAX; i++) {
+        myLegVersion[i] = 0;
+        myLegTime[i] = 0;
+        myLegDeadTime[i] = 0;
+      }
+    }
+
+    void update(F3XFixedDistanceTask* aTask) {
+      int8_t legCount = aTask->getSignalledLegCount();
+      F3XFixedDistanceTask::State state = aTask->getTaskState();
+      if (aTask != myTask || aTask->getResetCount() != myResetCount || legCount < myLegCount) {
+        // legs are reset
+        myTask = aTask;
+        myResetCount = aTask->getResetCount();
+        myVersion++;
+        myResetVersion = myVersion;
+        for (uint8_t i=0; i<F3X_TRACKED_LEGS_MAX; i++) {
+          myLegVersion[i] = 0;
+          myLegTime[i] = 0;
+          myLegDeadTime[i] = 0;
+        }
+        myLegCount = F3X_COURSE_INIT;
+      }
+      if (state != myState) {
+        myState = state;
+        myVersion++;
+      }
+      uint8_t legs = getLegCount();
+      for (uint8_t i=0; i<legs; i++) {
+        F3XLeg leg = aTask->getLeg(i);
+        if (i >= myLegCount || leg.time != myLegTime[i] || leg.deadTime != myLegDeadTime[i]) {
+          myLegVersion[i] = ++myVersion;
+          myLegTime[i] = leg.time;
+          myLegDeadTime[i] = leg.deadTime;
+        }
+      }
+      myLegCount = legCount;
+    }
+
+    uint32_t getVersion() {
+      return myVersion;
+    }
+
+    /**
+     * returns true, if the client with version aVersion needs the complete state
+     */
+    boolean isFullUpdate(uint32_t aVersion) {
+      return aVersion < myResetVersion || aVersion > myVersion;
+    }
+
+    /**
+     * returns true, if leg aIdx changed after aVersion
+     */
+    boolean isLegChanged(uint8_t aIdx, uint32_t aVersion) {
+      return aIdx < F3X_TRACKED_LEGS_MAX && myLegVersion[aIdx] > aVersion;
+    }
+
+    /**
+     * number of completed legs
+     */
+    uint8_t getLegCount() {
+      if (myTask == nullptr || myTask->getSignalledLegCount() <= 0) {
+        return 0;
+      }
+      uint8_t legs = myTask->getSignalledLegCount();
+      return legs > F3X_TRACKED_LEGS_MAX ? F3X_TRACKED_LEGS_MAX : legs;
+    }
+
+  private:
+    F3XFixedDistanceTask* myTask;
+    uint16_t myResetCount;
+    uint32_t myVersion;
+    uint32_t myResetVersion;
+    F3XFixedDistanceTask::State myState;
+    int8_t myLegCount;
+    uint32_t myLegVersion[F3X_TRACKED_LEGS_MAX];
+    unsigned long myLegTime[F3X_TRACKED_LEGS_MAX];
+    unsigned long myLegDeadTime[F3X_TRACKED_LEGS_MAX];
+};
+
+#endif
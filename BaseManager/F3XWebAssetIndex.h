@@ -0,0 +1,75 @@
+#ifndef F3XWebAssetIndex_h
+#define F3XWebAssetIndex_h
+
+#include <Arduino.h>
+#include "LittleFS.h"
+
+#define F3X_WEB_ASSETS_MAX     24
+#define F3X_WEB_ASSET_INDEX    "/assets.idx"
+
+/**
+ * index of the web assets, written by tools/build_web_assets.py: one line per file with
+ * "<path> <etag> <immutable>". Assets with a content hash in their name are immutable and can
+ * be cached by the browser forever, the other files (html pages) are revalidated by their ETag.
+ * Files not in the index (e.g. the csv protocols of former versions) are served without cache headers.
+ */
+class F3XWebAssetIndex {
+  public:
+    F3XWebAssetIndex() {
+      myCount = 0;
+    }
+
+    /**
+     * read the index from the file system, returns the number of assets
+     */
+    uint8_t load() {
+      myCount = 0;
+      File file = LittleFS.open(F3X_WEB_ASSET_INDEX, "r");
+      if (!file) {
+        return 0;
+      }
+      while (file.available() && myCount < F3X_WEB_ASSETS_MAX) {
+        String line = file.readStringUntil('\n');
+        int sep1 = line.indexOf(' ');
+        int sep2 = line.indexOf(' ', sep1+1);
+        if (sep1 <= 0 || sep2 <= sep1) {
+          continue;
+        }
+        Asset* asset = &myAssets[myCount++];
+        asset->path = line.substring(0, sep1);
+        asset->etag = String(F("\"")) + line.substring(sep1+1, sep2) + F("\"");
+        asset->immutable = line.substring(sep2+1).toInt() == 1;
+      }
+      file.close();
+      return myCount;
+    }
+
+    /**
+     * returns the quoted ETag of aPath (without .gz) or nullptr, if the file is not in the index
+     */
+    const String* getETag(const String& aPath, boolean* aImmutable) {
+      for (uint8_t i=0; i<myCount; i++) {
+        if (myAssets[i].path == aPath) {
+          *aImmutable = myAssets[i].immutable;
+          return &myAssets[i].etag;
+        }
+      }
+      return nullptr;
+    }
+
+    uint8_t getCount() {
+      return myCount;
+    }
+
+  private:
+    typedef struct {
+      String path;
+      String etag;
+      boolean immutable;
+    } Asset;
+
+    Asset myAssets[F3X_WEB_ASSETS_MAX];
+    uint8_t myCount;
+};
+
+#endif
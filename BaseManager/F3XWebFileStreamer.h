@@ -0,0 +1,215 @@
+#ifndef F3XWebFileStreamer_h
+#define F3XWebFileStreamer_h
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include "LittleFS.h"
+
+#define F3X_WEB_STREAMS          3     // file transfers in parallel
+#define F3X_WEB_CHUNK_SIZE     512     // bytes written to a client at once
+#define F3X_WEB_STREAM_STALL  5000     // ms without progress, after which a transfer is aborted
+
+/**
+ * transfers files to web clients in chunks from the loop, instead of ESP8266WebServer::streamFile(),
+ * which blocks until the whole file is written. The HTTP header is sent by the web server, the
+ * body is written by update() within a time budget and only as much as the TCP send buffer of
+ * the client takes without blocking.
+ * A body created on the fly (e.g. the CSV protocol of the run log) is transferred the same way
+ * page by page, each page is created when the previous one is written and sent as one chunk of
+ * the chunked transfer encoding.
+ */
+class F3XWebFileStreamer {
+  public:
+    /**
+     * append page aPage (0 = first) of the body to aBuffer, returns false after the last page
+     */
+    typedef boolean (*PageFunction)(uint16_t aPage, String* aBuffer, void* aContext);
+
+    F3XWebFileStreamer() {
+      for (uint8_t i=0; i<F3X_WEB_STREAMS; i++) {
+        myTransfers[i].used = false;
+      }
+      myNext = 0;
+      myAbortCnt = 0;
+    }
+
+    /**
+     * take over the (opened) file aFile for the client aClient, aLength bytes are sent from the
+     * current position of the file (e.g. for a range request). Returns false if all transfer slots
+     * are in use.
+     */
+    boolean add(File aFile, WiFiClient aClient, uint32_t aLength=UINT32_MAX) {
+      for (uint8_t i=0; i<F3X_WEB_STREAMS; i++) {
+        Transfer* s = &myTransfers[i];
+        if (!s->used) {
+          s->file = aFile;
+          s->pages = nullptr;
+          s->client = aClient;
+          s->remaining = aLength;
+          s->lastProgress = millis();
+          s->used = true;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /**
+     * take over the client aClient for a body created by aPages with the context aContext. The
+     * HTTP header with "Transfer-Encoding: chunked" has to be sent already. Returns false if all
+     * transfer slots are in use.
+     */
+    boolean add(PageFunction aPages, void* aContext, WiFiClient aClient) {
+      for (uint8_t i=0; i<F3X_WEB_STREAMS; i++) {
+        Transfer* s = &myTransfers[i];
+        if (!s->used) {
+          s->pages = aPages;
+          s->context = aContext;
+          s->nextPage = 0;
+          s->buffer = String();
+          s->offset = 0;
+          s->client = aClient;
+          s->remaining = UINT32_MAX;
+          s->lastProgress = millis();
+          s->used = true;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /**
+     * write the next chunks of the active transfers round robin, until aBudgetUs is consumed or
+     * aPreempt returns true (e.g. a signal is pending). Returns true, if transfers are still active.
+     */
+    boolean update(uint32_t aBudgetUs, boolean (*aPreempt)()) {
+      uint32_t start = micros();
+      uint8_t idle = 0;
+      while (idle < F3X_WEB_STREAMS && (micros() - start) < aBudgetUs && !aPreempt()) {
+        Transfer* s = &myTransfers[myNext];
+        myNext = (myNext + 1) % F3X_WEB_STREAMS;
+        if (!s->used || !writeChunk(s)) {
+          idle++;
+        } else {
+          idle = 0;
+        }
+      }
+      return getActiveCount() > 0;
+    }
+
+    uint8_t getActiveCount() {
+      uint8_t cnt = 0;
+      for (uint8_t i=0; i<F3X_WEB_STREAMS; i++) {
+        if (myTransfers[i].used) {
+          cnt++;
+        }
+      }
+      return cnt;
+    }
+
+    /**
+     * number of transfers aborted, because the client disconnected or stalled
+     */
+    uint16_t getAbortCount() {
+      return myAbortCnt;
+    }
+
+  private:
+    typedef struct {
+      boolean used;
+      File file;
+      PageFunction pages;       // nullptr: transfer of file
+      void* context;
+      uint16_t nextPage;
+      String buffer;            // the current page as chunk
+      uint16_t offset;          // bytes of buffer written
+      WiFiClient client;
+      uint32_t remaining;       // bytes of the file, of a paged body 0 after the last chunk
+      unsigned long lastProgress;
+    } Transfer;
+
+    /**
+     * bytes of the current page not written yet, the next page is created, if it is written
+     * completely. After the last page the terminating chunk is sent.
+     */
+    int getPageAvailable(Transfer* aTransfer) {
+      if (aTransfer->offset >= aTransfer->buffer.length() && aTransfer->remaining > 0) {
+        String page;
+        if (aTransfer->pages(aTransfer->nextPage++, &page, aTransfer->context) && page.length() > 0) {
+          aTransfer->buffer = String(page.length(), HEX) + F("\r\n") + page + F("\r\n");
+        } else {
+          aTransfer->buffer = F("0\r\n\r\n");
+          aTransfer->remaining = 0;
+        }
+        aTransfer->offset = 0;
+      }
+      return aTransfer->buffer.length() - aTransfer->offset;
+    }
+
+    /**
+     * write one chunk, returns false if nothing was written
+     */
+    boolean writeChunk(Transfer* aTransfer) {
+      if (!aTransfer->client.connected()) {
+        myAbortCnt++;
+        finish(aTransfer);
+        return false;
+      }
+      int len;
+      if (aTransfer->pages != nullptr) {
+        len = getPageAvailable(aTransfer);
+      } else {
+        len = aTransfer->file.available();
+        if ((uint32_t) len > aTransfer->remaining) {
+          len = aTransfer->remaining;
+        }
+      }
+      if (len <= 0) {
+        // the remaining data is sent by the TCP stack, the connection is closed with the last reference
+        finish(aTransfer);
+        return false;
+      }
+      int space = aTransfer->client.availableForWrite();
+      if (space <= 0) {
+        if (millis() - aTransfer->lastProgress > F3X_WEB_STREAM_STALL) {
+          myAbortCnt++;
+          aTransfer->client.stop();
+          finish(aTransfer);
+        }
+        return false;
+      }
+      if (len > space) {
+        len = space;
+      }
+      if (len > F3X_WEB_CHUNK_SIZE) {
+        len = F3X_WEB_CHUNK_SIZE;
+      }
+      if (aTransfer->pages != nullptr) {
+        aTransfer->client.write((const uint8_t*) aTransfer->buffer.c_str() + aTransfer->offset, len);
+        aTransfer->offset += len;
+        aTransfer->lastProgress = millis();
+        return true;
+      }
+      uint8_t buffer[F3X_WEB_CHUNK_SIZE];
+      len = aTransfer->file.read(buffer, len);
+      aTransfer->client.write(buffer, len);
+      aTransfer->remaining -= len;
+      aTransfer->lastProgress = millis();
+      return true;
+    }
+
+    void finish(Transfer* aTransfer) {
+      if (aTransfer->pages == nullptr) {
+        aTransfer->file.close();
+      }
+      aTransfer->buffer = String();
+      aTransfer->client = WiFiClient();
+      aTransfer->used = false;
+    }
+
+    Transfer myTransfers[F3X_WEB_STREAMS];
+    uint8_t myNext;
+    uint16_t myAbortCnt;
+};
+
+#endif
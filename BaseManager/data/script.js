@@ -17,6 +17,12 @@
     htmlElement.innerHTML = aValue;
   }
 
+  // aText as HTML text, e.g. the pilot names entered by the users
+  function escapeHtml(aText) {
+    return String(aText).replace(/&/g, "&amp;").replace(/</g, "&lt;").replace(/>/g, "&gt;")
+      .replace(/"/g, "&quot;").replace(/'/g, "&#39;");
+  }
+
   function pollData(aId, aCount) {
     if( typeof pollData.counter == 'undefined' ) {
       pollData.counter = 0;
@@ -46,6 +52,18 @@
   var MYSEP_STR = "~~~";
   var MYPSEP_STR = "=";
 
+  // course of the page by the URL argument course, 0 is the course of the A-line button
+  function getCourse() {
+    var course = new URLSearchParams(window.location.search).get("course");
+    return course === null ? 0 : parseInt(course);
+  }
+
+  // the course as request argument, empty for course 0
+  function getCourseArg() {
+    var course = getCourse();
+    return course > 0 ? "&course=" + course : "";
+  }
+
   function sendNameValue(aName, aValue) {
     // console.log("sendNameValue(" + aName + ", " + aValue + ")");
     // console.log("sendNameValue(" + aName + ", " + encodeURIComponent(aValue) + ")");
@@ -57,7 +75,7 @@
     xhttp.onreadystatechange = function() {
       parseResponse(this);
     };
-    xhttp.open("GET", "setDataReq?name" + MYPSEP_STR +aName+"&value" + MYPSEP_STR + encodeURIComponent(aValue), true);
+    xhttp.open("GET", "setDataReq?name" + MYPSEP_STR +aName+"&value" + MYPSEP_STR + encodeURIComponent(aValue) + getCourseArg(), true);
     xhttp.send();
   }
 
@@ -74,70 +92,335 @@
     return retVal;
   }
 
+  // table of the stored runs read page by page from api/runs, aTask: "f3b" or "f3f"
+  var RUNS_PAGE_SIZE = 10;
+  var ourRunsPage = { from: 0, total: 0 };
+
+  function showRuns(aTask, aFrom) {
+    var xhttp = new XMLHttpRequest();
+    xhttp.timeout = 5000;
+    xhttp.onreadystatechange = function() {
+      if (this.readyState == 4 && this.status == 200) {
+        var page = JSON.parse(this.responseText);
+        ourRunsPage.from = page.from;
+        ourRunsPage.total = page.total;
+        var table = "<table><thead>" + getTableRow(page.header[0], "th") + "</thead><tbody>";
+        for (var i = 0; i < page.runs.length; i++) {
+          table += getTableRow(page.runs[i], "td");
+        }
+        table += "</tbody></table>";
+        document.getElementById("table_here").innerHTML = table;
+        var info = page.total == 0 ? "no runs" : (page.from + 1) + " - " + (page.from + page.runs.length) + " of " + page.total;
+        setElementValue("id_runs_info", info);
+      }
+    };
+    var requestLocation = "api/runs?task=" + aTask + "&count=" + RUNS_PAGE_SIZE + getCourseArg();
+    if (aFrom !== undefined) {
+      requestLocation += "&from=" + aFrom;
+    }
+    xhttp.open("GET", requestLocation, true);
+    xhttp.send();
+  }
+
+  // aDirection: -1 older runs, 1 newer runs
+  function showRunsPage(aTask, aDirection) {
+    var from = ourRunsPage.from + aDirection * RUNS_PAGE_SIZE;
+    if (from < 0) {
+      from = 0;
+    }
+    if (from < ourRunsPage.total && from != ourRunsPage.from) {
+      showRuns(aTask, from);
+    }
+  }
+
+  // CSV protocol aPath of the course of the page
+  function downloadCsv(aPath) {
+    var course = getCourse();
+    window.location.href = aPath + (course > 0 ? "?course=" + course : "");
+  }
+
+  function getTableRow(aCsvLine, aCellTag) {
+    var cells = aCsvLine.split(";");
+    var row = "<tr>";
+    for (var i = 0; i < cells.length; i++) {
+      row += "<" + aCellTag + ">" + cells[i] + "</" + aCellTag + ">";
+    }
+    return row + "</tr>";
+  }
+
+  // statistics of all stored runs and of the session from api/stats as table, times in ms
+  function showStatistics(aTask) {
+    var xhttp = new XMLHttpRequest();
+    xhttp.timeout = 5000;
+    xhttp.onreadystatechange = function() {
+      if (this.readyState == 4 && this.status == 200) {
+        var stats = JSON.parse(this.responseText);
+        var table = "<table><thead><tr><th></th><th>all runs</th><th>session</th></tr></thead><tbody>";
+        table += getStatisticsRow("runs", stats, function(s) { return s.count; });
+        table += getStatisticsRow("best course time", stats, function(s) { return formatCourseTime(s.best) + " (" + s.bestRun + ")"; });
+        table += getStatisticsRow("average course time", stats, function(s) { return formatCourseTime(s.avg); });
+        table += getStatisticsRow("median/90% course time", stats, function(s) { return formatCourseTime(s.p50) + " / " + formatCourseTime(s.p90); });
+        table += getStatisticsRow("recent course time", stats, function(s) { return formatCourseTime(s.recent) + " " + s.trend; });
+        for (var i = 0; i < stats.all.legs.length; i++) {
+          table += getStatisticsRow("best " + (i+1) + ".leg", stats, function(s) { return formatSeconds(s.legs[i][0]); });
+          if (i < stats.all.legs.length - 1) {
+            table += getStatisticsRow("avg. dead time/distance " + (i+1) + ".turn", stats, function(s) {
+              return formatSeconds(s.legs[i][1]) + " / " + s.legs[i][2] + "m"; });
+          }
+        }
+        table += "</tbody></table>";
+        document.getElementById("stats_here").innerHTML = table;
+      }
+    };
+    xhttp.open("GET", "api/stats?task=" + aTask + getCourseArg(), true);
+    xhttp.send();
+  }
+
+  function getStatisticsRow(aName, aStats, aFormat) {
+    var all = aStats.all.count > 0 ? aFormat(aStats.all) : "-";
+    var session = aStats.session.count > 0 ? aFormat(aStats.session) : "-";
+    return "<tr><td>" + aName + "</td><td>" + all + "</td><td>" + session + "</td></tr>";
+  }
+
+  // roster and schedule from api/pilots, the roster is shown as text in id_pilots
+  var ourPilots = { pilots: [] };
+  function showPilots(aSetText) {
+    var xhttp = new XMLHttpRequest();
+    xhttp.timeout = 5000;
+    xhttp.onreadystatechange = function() {
+      if (this.readyState == 4 && this.status == 200) {
+        ourPilots = JSON.parse(this.responseText);
+        renderPilots(aSetText);
+      }
+    };
+    xhttp.open("GET", "api/pilots", true);
+    xhttp.send();
+  }
+
+  function savePilots() {
+    var xhttp = new XMLHttpRequest();
+    xhttp.timeout = 5000;
+    xhttp.onreadystatechange = function() {
+      if (this.readyState == 4 && this.status == 200) {
+        ourPilots = JSON.parse(this.responseText);
+        renderPilots(true);
+      }
+    };
+    xhttp.open("POST", "api/pilots", true);
+    xhttp.setRequestHeader("Content-Type", "text/plain");
+    xhttp.send(document.getElementById("id_pilots").value);
+  }
+
+  function sendScheduleCmd(aName) {
+    sendNameValue(aName, "true");
+    setTimeout(showPilots, 500, false);
+  }
+
+  function renderPilots(aSetText) {
+    if (aSetText) {
+      var text = "";
+      for (var i = 0; i < ourPilots.pilots.length; i++) {
+        text += ourPilots.pilots[i][0] + ";" + ourPilots.pilots[i][1] + "\n";
+      }
+      document.getElementById("id_pilots").value = text;
+    }
+    var current = ourPilots.current >= 0 ? ourPilots.pilots[ourPilots.current][0] : "-";
+    setElementValue("id_schedule", "round " + ourPilots.round + ", " + (ourPilots.position + 1) + ". pilot: " + escapeHtml(current));
+    var table = "<table><thead><tr><th>No</th><th>Pilot</th><th>Group</th></tr></thead><tbody>";
+    for (var i = 0; i < ourPilots.order.length; i++) {
+      var pilot = ourPilots.pilots[ourPilots.order[i]];
+      var mark = i == ourPilots.position ? " &lt;" : "";
+      table += "<tr><td>" + (i+1) + "</td><td>" + escapeHtml(pilot[0]) + mark + "</td><td>" + pilot[1] + "</td></tr>";
+    }
+    document.getElementById("order_here").innerHTML = table + "</tbody></table>";
+  }
+
+  // scores of the pilots from api/results, ordered by the total score
+  function showResults(aTask) {
+    var xhttp = new XMLHttpRequest();
+    xhttp.timeout = 5000;
+    xhttp.onreadystatechange = function() {
+      if (this.readyState == 4 && this.status == 200) {
+        var results = JSON.parse(this.responseText);
+        var pilots = results.pilots.slice().sort(function(a, b) { return b[4] - a[4]; });
+        var table = "<table><thead><tr><th>Rank</th><th>Pilot</th><th>Group</th><th>Round " + results.round +
+          "</th><th>Points</th><th>Total (" + results.rounds + " rounds)</th><th>Best</th></tr></thead><tbody>";
+        for (var i = 0; i < pilots.length; i++) {
+          var p = pilots[i];
+          table += "<tr><td>" + (i+1) + "</td><td>" + escapeHtml(p[0]) + "</td><td>" + p[1] + "</td><td>" +
+            (p[2] > 0 ? formatSeconds(p[2]) : "-") + "</td><td>" + p[3].toFixed(2) + "</td><td>" +
+            p[4].toFixed(2) + "</td><td>" + (p[5] > 0 ? formatSeconds(p[5]) : "-") + "</td></tr>";
+        }
+        document.getElementById("results_here").innerHTML = table + "</tbody></table>";
+      }
+    };
+    xhttp.open("GET", "api/results?task=" + aTask + getCourseArg(), true);
+    xhttp.send();
+  }
+
+  // receive the data pushed by server sent events, if not possible poll the task state
+  // from api/task and show it with aRender. The events are sent for course 0 only.
+  function subscribeData(aRender, aPollInterval) {
+    if (typeof(EventSource) === "undefined" || getCourse() > 0) {
+      startTaskStatePolling(aRender, aPollInterval);
+      return;
+    }
+    var source = new EventSource("events");
+    source.onmessage = function(aEvent) {
+      parseData(aEvent.data);
+    };
+    source.onerror = function() {
+      if (source.readyState == EventSource.CLOSED) {
+        // refused by the server (e.g. too many clients), no automatic reconnect
+        console.log("server sent events not possible, polling");
+        startTaskStatePolling(aRender, aPollInterval);
+      }
+    };
+  }
+
+  function startTaskStatePolling(aRender, aPollInterval) {
+    setInterval(pollTaskState, aPollInterval, aRender);
+    setInterval(getData, 5000, "initHeaderData");
+  }
+
+  // task state, merged from the deltas of api/task, times in ms
+  var ourTaskState = { v: 0, legs: [] };
+
+  function pollTaskState(aRender) {
+    var xhttp = new XMLHttpRequest();
+    xhttp.timeout = 2000;
+    xhttp.onreadystatechange = function() {
+      if (this.readyState == 4 && this.status == 200) {
+        var delta = JSON.parse(this.responseText);
+        if (delta.full) {
+          ourTaskState.legs = [];
+        }
+        for (var i = 0; i < delta.legs.length; i++) {
+          var leg = delta.legs[i];
+          ourTaskState.legs[leg[0]] = { time: leg[1], deadTime: leg[2], deadDistance: leg[3] };
+        }
+        delete delta.legs;
+        delete delta.full;
+        Object.assign(ourTaskState, delta);
+        aRender(ourTaskState);
+      }
+    };
+    xhttp.open("GET", "api/task?v=" + ourTaskState.v + getCourseArg(), true);
+    xhttp.send();
+  }
+
+  function pad2(aValue) {
+    return (aValue < 10 ? "0" : "") + aValue;
+  }
+
+  // mm:ss.cc like F3XFixedDistanceTask::getLegTimeString()
+  function formatCourseTime(aTime) {
+    if (aTime < 0) {
+      return "__:__.__";
+    }
+    var secs = Math.floor(aTime / 1000);
+    return pad2(Math.floor(secs / 60) % 60) + ":" + pad2(secs % 60) + "." + pad2(Math.floor(aTime / 10) % 100);
+  }
+
+  // mm:ss like F3XFixedDistanceTask::getHMSTimeStr(aTime, true)
+  function formatTaskTime(aTime) {
+    if (aTime < 0) {
+      return "__:__";
+    }
+    var secs = Math.floor(aTime / 1000);
+    return pad2(Math.floor(secs / 60) % 60) + ":" + pad2(secs % 60);
+  }
+
+  function formatSeconds(aTime) {
+    return pad2(Math.floor(aTime / 1000)) + "." + pad2(Math.floor(aTime / 10) % 100);
+  }
+
+  // course time at the end of leg aIdx/leg time/speed[/dead time/dead distance]
+  function formatLegTime(aTask, aIdx) {
+    var course = 0;
+    for (var i = 0; i <= aIdx; i++) {
+      if (aTask.legs[i] === undefined) {
+        return formatCourseTime(-1);
+      }
+      course += aTask.legs[i].time;
+    }
+    var leg = aTask.legs[aIdx];
+    var str = formatCourseTime(course) + "/" + formatSeconds(leg.time) + "/"
+      + Math.floor(aTask.legLength * 3600 / leg.time);
+    if (leg.deadTime != 0) {
+      str += "/" + formatSeconds(leg.deadTime) + "/" + leg.deadDistance;
+    }
+    return str;
+  }
+
   function parseResponse(aResponse) {
       if (aResponse.readyState == 4 && aResponse.status == 200) {
-        var responseValues = aResponse.responseText.split(MYSEP_STR);
-        // console.log("responseValues.length:" + responseValues.length);
-        for (var i = 0; i < responseValues.length; i++) {
-          var element = responseValues[i].split(MYPSEP_STR);
-          var elementId = element[0];
-          // console.log("response : " + elementId + " : " + Date.now());
-          // console.log("elementId:" + elementId);
-          if (elementId == "") { break }
-          var elementValue = element[1];
-          if (elementId == "__speedtask__") { 
-            // console.log("elementId:" + elementId);
-            if ( myF3XTask != null ){
-              // console.log("speedtask.setState");
-              myF3XTask.setState(elementValue); 
-            }
-            break; 
-          }
-          // console.log("elementValue:" + elementValue);
-          var htmlElement = document.getElementById(elementId);
-          if (htmlElement === null) {
-            // console.error("in parseResponose: not element with given id found :" + elementId);
-            continue;
-          }
-          // console.log("elementType:" + htmlElement.type);
-          if (htmlElement.type == "radio") {
-             htmlElement.checked = true;
-          } else if (htmlElement.type == "checkbox") {
-            if (elementValue == "checked") {
-              htmlElement.checked = true;
+        parseData(aResponse.responseText);
+      }
+  }
+
+  function parseData(aData) {
+    var responseValues = aData.split(MYSEP_STR);
+    // console.log("responseValues.length:" + responseValues.length);
+    for (var i = 0; i < responseValues.length; i++) {
+      var element = responseValues[i].split(MYPSEP_STR);
+      var elementId = element[0];
+      // console.log("response : " + elementId + " : " + Date.now());
+      // console.log("elementId:" + elementId);
+      if (elementId == "") { break }
+      var elementValue = element[1];
+      if (elementId == "__speedtask__") { 
+        // console.log("elementId:" + elementId);
+        if ( myF3XTask != null ){
+          // console.log("speedtask.setState");
+          myF3XTask.setState(elementValue); 
+        }
+        break; 
+      }
+      // console.log("elementValue:" + elementValue);
+      var htmlElement = document.getElementById(elementId);
+      if (htmlElement === null) {
+        // console.error("in parseResponose: not element with given id found :" + elementId);
+        continue;
+      }
+      // console.log("elementType:" + htmlElement.type);
+      if (htmlElement.type == "radio") {
+         htmlElement.checked = true;
+      } else if (htmlElement.type == "checkbox") {
+        if (elementValue == "checked") {
+          htmlElement.checked = true;
 	    } else {
-              htmlElement.checked = false;
+          htmlElement.checked = false;
 	    }
-          } else if (htmlElement.type == "password") {
-            htmlElement.value = elementValue;
-          } else if (htmlElement.type == "text") {
-            htmlElement.value = elementValue;
-          } else if (htmlElement.type == "range") {
-            htmlElement.value = elementValue;
-            if (element.length > 3) {
-              // console.log("min :" + element[2]);
-              htmlElement.min = element[2];
-              // console.log("max :" + element[3]);
-              htmlElement.max = element[3];
-            }
-          } else if (htmlElement.type == "number") {
-            htmlElement.value = elementValue;
-            if (element.length > 3) {
-              // console.log("min :" + element[2]);
-              htmlElement.min = element[2];
-              // console.log("max :" + element[3]);
-              htmlElement.max = element[3];
-            }
-          } else if (htmlElement.type == "select-one") {
-            // htmlElement.options.selectedIndex = elementValue;
-            htmlElement.value = elementValue;
-          } else if (htmlElement.type == "select") {
-            htmlElement.value = elementValue;
-          } else {
-            htmlElement.innerHTML = elementValue;
-          }
+      } else if (htmlElement.type == "password") {
+        htmlElement.value = elementValue;
+      } else if (htmlElement.type == "text") {
+        htmlElement.value = elementValue;
+      } else if (htmlElement.type == "range") {
+        htmlElement.value = elementValue;
+        if (element.length > 3) {
+          // console.log("min :" + element[2]);
+          htmlElement.min = element[2];
+          // console.log("max :" + element[3]);
+          htmlElement.max = element[3];
+        }
+      } else if (htmlElement.type == "number") {
+        htmlElement.value = elementValue;
+        if (element.length > 3) {
+          // console.log("min :" + element[2]);
+          htmlElement.min = element[2];
+          // console.log("max :" + element[3]);
+          htmlElement.max = element[3];
         }
+      } else if (htmlElement.type == "select-one") {
+        // htmlElement.options.selectedIndex = elementValue;
+        htmlElement.value = elementValue;
+      } else if (htmlElement.type == "select") {
+        htmlElement.value = elementValue;
+      } else {
+        htmlElement.innerHTML = elementValue;
       }
+    }
   }
 
   function getDataRS() {
@@ -149,7 +432,7 @@
     for (var i = 0; i < arguments.length; i++) {
        requestLocation += arguments[i]+"&";
     }
-    requestLocation = requestLocation.substring(0,requestLocation.length-1);
+    requestLocation = requestLocation.substring(0,requestLocation.length-1) + getCourseArg();
     xhttp.open("GET", requestLocation, true);
     xhttp.send();
   }
@@ -165,7 +448,7 @@
       for (var i = 1; i < arguments.length; i++) {
          requestLocation += arguments[i]+"=0&";
       }
-      requestLocation = requestLocation.substring(0,requestLocation.length-1);
+      requestLocation = requestLocation.substring(0,requestLocation.length-1) + getCourseArg();
       xhttp.open("GET", requestLocation, true);
       xhttp.send();
     }
@@ -181,7 +464,7 @@
     for (var i = 0; i < arguments.length; i++) {
        requestLocation += arguments[i]+"=0&";
     }
-    requestLocation = requestLocation.substring(0,requestLocation.length-1);
+    requestLocation = requestLocation.substring(0,requestLocation.length-1) + getCourseArg();
     xhttp.open("GET", requestLocation, true);
     xhttp.send();
   }
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+"""
+build the LittleFS web root of the BaseManager from BaseManager/data
+
+  * html/css/js files are minified (conservatively: comments and indentation)
+  * css/js assets get a content hash in their name (script.js -> script.1a2b3c4d.js)
+    and the references in the html pages are rewritten, so they can be cached forever
+  * all text files are gzipped, only the .gz file is stored
+  * runtime data files (csv) are copied unchanged
+  * the index /assets.idx holds "<path> <etag> <immutable>" per file for the web server
+
+usage: build_web_assets.py [--src BaseManager/data] [--out BaseManager/build/data]
+the output directory is the content of the LittleFS image (e.g. mklittlefs -c <out> ...)
+"""
+
+import argparse
+import gzip
+import hashlib
+import os
+import re
+import shutil
+import sys
+
+HASHED_TYPES = (".css", ".js")
+TEXT_TYPES = (".html", ".css", ".js", ".map")
+COPY_TYPES = (".csv",)
+INDEX_FILE = "assets.idx"
+
+
+def minify_html(aText):
+    aText = re.sub(r"<!--.*?-->", "", aText, flags=re.S)
+    return minify_lines(aText)
+
+
+def minify_css(aText):
+    aText = re.sub(r"/\*.*?\*/", "", aText, flags=re.S)
+    return minify_lines(aText)
+
+
+def minify_js(aText):
+    # no tokenizer, so only whole line comments are removed, "//" may be part of a string
+    lines = [l for l in aText.splitlines() if not l.strip().startswith("//")]
+    return minify_lines("\n".join(lines))
+
+
+def minify_lines(aText):
+    lines = [l.strip() for l in aText.splitlines()]
+    return "\n".join(l for l in lines if l) + "\n"
+
+
+def minify(aName, aText):
+    if aName.endswith(".min.js"):
+        return aText
+    if aName.endswith(".html"):
+        return minify_html(aText)
+    if aName.endswith(".css"):
+        return minify_css(aText)
+    if aName.endswith(".js"):
+        return minify_js(aText)
+    return aText
+
+
+def content_hash(aData):
+    return hashlib.sha1(aData).hexdigest()[:8]
+
+
+def hashed_name(aName, aHash):
+    base, ext = os.path.splitext(aName)
+    return "%s.%s%s" % (base, aHash, ext)
+
+
+def write_gzip(aPath, aData):
+    # mtime=0: same input, same output
+    with open(aPath, "wb") as f:
+        with gzip.GzipFile(fileobj=f, mode="wb", compresslevel=9, mtime=0, filename="") as gz:
+            gz.write(aData)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="build the BaseManager web assets")
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser.add_argument("--src", default=os.path.join(here, "..", "data"))
+    parser.add_argument("--out", default=os.path.join(here, "..", "build", "data"))
+    args = parser.parse_args()
+
+    src = os.path.normpath(args.src)
+    out = os.path.normpath(args.out)
+    if os.path.exists(out):
+        shutil.rmtree(out)
+    os.makedirs(out)
+
+    names = sorted(n for n in os.listdir(src) if os.path.isfile(os.path.join(src, n)))
+    contents = {}
+    for name in names:
+        with open(os.path.join(src, name), "rb") as f:
+            data = f.read()
+        if name.endswith(TEXT_TYPES):
+            data = minify(name, data.decode("utf-8")).encode("utf-8")
+        contents[name] = data
+
+    # assets first, their hashed names are needed to rewrite the pages
+    renames = {}
+    for name in names:
+        if name.endswith(HASHED_TYPES):
+            renames[name] = hashed_name(name, content_hash(contents[name]))
+
+    index = []
+    for name in names:
+        data = contents[name]
+        if name.endswith(".html"):
+            text = data.decode("utf-8")
+            for orig, new in renames.items():
+                text = re.sub(r'(["\'/])' + re.escape(orig) + r'(["\'])', r"\g<1>" + new + r"\g<2>", text)
+            data = text.encode("utf-8")
+        target = renames.get(name, name)
+        if name.endswith(COPY_TYPES) or not name.endswith(TEXT_TYPES):
+            with open(os.path.join(out, target), "wb") as f:
+                f.write(data)
+            if not name.endswith(COPY_TYPES):
+                index.append("/%s %s 0" % (target, content_hash(data)))
+            continue
+        write_gzip(os.path.join(out, target + ".gz"), data)
+        index.append("/%s %s %d" % (target, content_hash(data), 1 if name in renames else 0))
+
+    with open(os.path.join(out, INDEX_FILE), "w") as f:
+        f.write("\n".join(index) + "\n")
+
+    total_src = sum(os.path.getsize(os.path.join(src, n)) for n in names)
+    total_out = sum(os.path.getsize(os.path.join(out, n)) for n in os.listdir(out))
+    print("web assets: %d files, %d -> %d bytes in %s" % (len(names), total_src, total_out, out))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -2,12 +2,21 @@
 #include <Bounce2.h>
 #include <Logger.h>
 #include "PinManager.h"
+#include "LatencyHistogram.h"
 #include "Config.h"
 
 #define APP_VERSION F("V032")
 
 static const char myName[] = "B-Line";
 
+// B-Line controller of the second course, it sends to its own reading pipe of the BaseManager
+// #define USE_SECOND_COURSE
+#ifdef USE_SECOND_COURSE
+#define F3X_LINE_DEVICE RFTransceiver::F3XBLineController2
+#else
+#define F3X_LINE_DEVICE RFTransceiver::F3XBLineController
+#endif
+
 
 // Used Ports as as summary for a Arduino Nano
 /*
@@ -50,6 +59,14 @@ unsigned long ourSecond = 0;
 
 F3XRemoteCommand ourRemoteCmd;
 unsigned long ourTimedReset = 0;
+// if nothing is received after a change of the radio settings (e.g. the BaseManager could
+// not follow a channel switch), the previous settings are restored
+#define RADIO_FALLBACK_DELAY 10000
+unsigned long ourRadioFallbackTime = 0;
+uint8_t ourRadioFallbackPower;
+uint8_t ourRadioFallbackChannel;
+uint8_t ourRadioFallbackDatarate;
+boolean ourRadioFallbackAck;
 unsigned long ourTimedResponse = 0;
 uint16_t ourBatteryVoltage=0;
 uint16_t ourBatteryVoltageRaw=0;
@@ -61,6 +78,14 @@ Bounce2::Button ourSignalButton = Bounce2::Button();
 void(* resetFunc) (void) = 0;  //declare reset function at address 0
 
 uint8_t ourSignalBCounter=0;
+LatencyHistogram ourSignalTransmitLatency; // button pressed -> SignalB transmitted, in us
+
+// a not acknowledged SignalB is retransmitted unchanged (same sequence number and press
+// time stamp) in the next loops, so the BaseManager can drop duplicates
+#define SIGNAL_B_RETRANS       5  // transmit() retries per loop
+#define SIGNAL_B_RETRY_BUDGET  6  // loops to retry a not acknowledged SignalB
+F3XRemoteFrame ourPendingSignalB;
+uint8_t ourPendingSignalBRetries = 0;
 
 void saveConfig() {
   logMsg(INFO, F("saving config to EEPROM "));   
@@ -106,7 +131,7 @@ void setupConfig() {
 }
 
 void setupRF() {
-  ourRadio.begin(RFTransceiver::F3XBLineController);
+  ourRadio.begin(F3X_LINE_DEVICE);
   logMsg(INFO, F("setup for RCTTransceiver/nRF24L01 successful "));   
 }
 
@@ -135,9 +160,10 @@ void updateBatteryIn(unsigned long aNow) {
     ourBatteryVoltage=((float) ourBatteryVoltageRaw)/1024.0*V_REF*ourConfig.batCalibration;
   
     logMsg(INFO, String(F("battery voltage: ")) + String(ourBatteryVoltage) + String("/") + String(ourBatteryVoltageRaw));
+    logSignalTransmitLatency();
     
     // logMsg(INFO, "sending TESTEST  SignalB");
-    // if (!ourRadio.transmit(ourRemoteCmd.createCommand(F3XRemoteCommandType::SignalB, String(ourSignalBCounter))->c_str(), 5)) {
+    // if (!ourRadio.transmit(ourRemoteCmd.createFrame(F3XRemoteCommandType::SignalB, ourSignalBCounter), 5)) {
     //   logMsg(ERROR, String(F("Test Signal was NOT send: ")));
     // }
 
@@ -201,7 +227,7 @@ void setup() {
   #endif
 
   setupRF();
-  ourRemoteCmd.begin();
+  ourRemoteCmd.begin(F3X_LINE_DEVICE);
 
   setupSignallingButton();
   
@@ -210,6 +236,22 @@ void setup() {
 }
 
 
+/**
+ * log the SignalB transmit latency, if there were presses since the last report. Called with
+ * the battery cycle, so the String building is not part of the time critical press handling.
+ */
+void logSignalTransmitLatency() {
+  static uint32_t lastCount = 0;
+  if (ourSignalTransmitLatency.getCount() == lastCount) {
+    return;
+  }
+  lastCount = ourSignalTransmitLatency.getCount();
+  logMsg(INFO, String(F("SignalB transmit p50/p99/max us: ")) 
+    + String(ourSignalTransmitLatency.getPercentile(50)) + "/" 
+    + String(ourSignalTransmitLatency.getPercentile(99)) + "/" 
+    + String(ourSignalTransmitLatency.getMax()));
+}
+
 void handleButtonEvents(unsigned long aNow) { 
   for (int i=0; i<6; i++) {
     // DEBOUNCE INTERVAL IN MILLISECONDS
@@ -218,22 +260,54 @@ void handleButtonEvents(unsigned long aNow) {
 
   for (int i=0; i<6; i++) {
     if ( ourSignalButtons[i]->pressed() ) {
+      unsigned long pressed = millis();
       logMsg(INFO, "SignalButton pressed :" + String(++ourSignalBCounter));
     
+      if (ourPendingSignalBRetries > 0) {
+        logMsg(ERROR, String(F("SignalB not acknowledged, replaced by new one, seq: ")) + String(ourPendingSignalB.seq));
+      }
+      ourRemoteCmd.createFrame(F3XRemoteCommandType::SignalB, ourSignalBCounter);
+      memcpy(&ourPendingSignalB, ourRemoteCmd.setTimestamp(pressed), sizeof(F3XRemoteFrame));
+      ourPendingSignalBRetries = SIGNAL_B_RETRY_BUDGET;
+
       logMsg(INFO, "sending SignalB");
-      ourRadio.transmit(ourRemoteCmd.createCommand(F3XRemoteCommandType::SignalB, String(ourSignalBCounter))->c_str(), 5);
+      uint32_t start = micros();
+      transmitPendingSignalB();
+      ourSignalTransmitLatency.record(micros() - start);
       ourLED.on(400);
     }
   }
 }
 
+/**
+ * (re)transmit the pending SignalB frame, until it is acknowledged or the retry budget is exhausted
+ */
+void transmitPendingSignalB() {
+  if (ourPendingSignalBRetries == 0) {
+    return;
+  }
+  if (ourRadio.transmit(&ourPendingSignalB, SIGNAL_B_RETRANS)) {
+    ourPendingSignalBRetries = 0;
+  } else if (--ourPendingSignalBRetries == 0) {
+    logMsg(ERROR, String(F("SignalB lost, seq: ")) + String(ourPendingSignalB.seq));
+  } else {
+    logMsg(INFO, String(F("SignalB not acknowledged, retrying, seq: ")) + String(ourPendingSignalB.seq));
+  }
+}
+
 void updateRadio(unsigned long aNow) { 
+  transmitPendingSignalB();
+
+  // receive time, used to answer the clock synchronization round trips
+  static unsigned long rxTime = 0;
   while (ourRadio.available()) { 
-    ourRemoteCmd.write(ourRadio.read());
+    rxTime = millis();
+    char* payload = ourRadio.read();
+    ourRemoteCmd.write(payload, ourRadio.getReadLength());
   }
 
   if (ourRemoteCmd.available()) {
-    String* arg;
+    int16_t arg;
     uint8_t argNum = -1;
     int8_t radioPower;
     uint8_t radioChannel;
@@ -241,11 +315,19 @@ void updateRadio(unsigned long aNow) {
     boolean radioAck;
     switch (ourRemoteCmd.getType()) {
       case F3XRemoteCommandType::CmdSetRadio:
-        radioPower=ourRemoteCmd.getArg(0)->toInt();
-        radioChannel=ourRemoteCmd.getArg(1)->toInt();
-        radioDatarate=ourRemoteCmd.getArg(2)->toInt();
-        radioAck=ourRemoteCmd.getArg(3)->toInt()==1?true:false;
-
+        radioPower=ourRemoteCmd.getArg(0);
+        radioChannel=ourRemoteCmd.getArg(1);
+        radioDatarate=ourRemoteCmd.getArg(2);
+        radioAck=ourRemoteCmd.getArg(3)==1?true:false;
+
+        if (radioPower != ourRadio.getPower() || radioChannel != ourRadio.getChannel()
+            || radioDatarate != ourRadio.getDataRate() || radioAck != ourRadio.getAck()) {
+          ourRadioFallbackPower = ourRadio.getPower();
+          ourRadioFallbackChannel = ourRadio.getChannel();
+          ourRadioFallbackDatarate = ourRadio.getDataRate();
+          ourRadioFallbackAck = ourRadio.getAck();
+          ourRadioFallbackTime = aNow + RADIO_FALLBACK_DELAY;
+        }
         ourRadio.setPower(radioPower);
         ourRadio.setChannel(radioChannel);
         ourRadio.setDataRate(radioDatarate);
@@ -256,21 +338,21 @@ void updateRadio(unsigned long aNow) {
         logMsg(INFO, String(F("received CmdSetPower: channel: ")) + String(radioChannel));
         logMsg(INFO, String(F("received CmdSetPower: datarate: ")) + String(radioDatarate));
         logMsg(INFO, String(F("received CmdSetPower: ack: ")) + String(radioAck));
-        logMsg(INFO, String(F("received CmdSetPower: power,chan,rate,ack: ")) + *ourRemoteCmd.getArg());
         break;
       case F3XRemoteCommandType::CmdRestartMC:
         logMsg(INFO, String(F("received CmdRestartMC: ack: ")) + String(radioAck));
         ourTimedReset = aNow + 500; // reset in 500ms
         break;
       case F3XRemoteCommandType::CmdCycleTestRequest:
-        arg = ourRemoteCmd.getArg();
-        LOGGY(INFO, String("received CmdCycleTestRequest:") + *arg);
-        if (arg->toInt() == 17) {
-          LOGGY(INFO, String("!!!!!!!!!!!!!!  ignoring CmdCycleTestAnswer:") + *arg);
+        arg = ourRemoteCmd.getArg(0);
+        LOGGY(INFO, String("received CmdCycleTestRequest:") + String(arg));
+        if (arg == 17) {
+          LOGGY(INFO, String("!!!!!!!!!!!!!!  ignoring CmdCycleTestAnswer:") + String(arg));
         } else {
-          LOGGY(INFO, String("sending CmdCycleTestAnswer:") + *arg);
+          LOGGY(INFO, String("sending CmdCycleTestAnswer:") + String(arg));
           boolean sendSuccess;
-          sendSuccess = ourRadio.transmit(*ourRemoteCmd.createCommand(F3XRemoteCommandType::CmdCycleTestAnswer, *arg), 5);
+          // the frame time stamp is the send time, arg 1 the time since the request was received
+          sendSuccess = ourRadio.transmit(ourRemoteCmd.createFrame(F3XRemoteCommandType::CmdCycleTestAnswer, arg, millis() - rxTime), 5);
           if (!sendSuccess) {
             logMsg(INFO, String(F("sending TestAnswer not successsfull. Retransmissions: ")) + String(ourRadio.getRetransmissionCount()));
           }
@@ -288,6 +370,10 @@ void updateRadio(unsigned long aNow) {
         logMsg(INFO, "consuming wrong command");
         break;
     }
+    if (ourRemoteCmd.getType() != F3XRemoteCommandType::CmdSetRadio) {
+      // any other frame confirms the current radio settings
+      ourRadioFallbackTime = 0;
+    }
     ourRemoteCmd.consume();
   }
 
@@ -308,10 +394,18 @@ void updateTimedEvents(unsigned long aNow) {
      ourTimedReset = 0;
      resetFunc();
   }
+  if (ourRadioFallbackTime != 0 && aNow > ourRadioFallbackTime) {
+     ourRadioFallbackTime = 0;
+     logMsg(ERROR, String(F("nothing received with new radio settings, back to channel: ")) + String(ourRadioFallbackChannel));
+     ourRadio.setPower(ourRadioFallbackPower);
+     ourRadio.setChannel(ourRadioFallbackChannel);
+     ourRadio.setDataRate(ourRadioFallbackDatarate);
+     ourRadio.setAck(ourRadioFallbackAck);
+  }
   if (ourTimedResponse != 0 && aNow > ourTimedResponse) {
      ourTimedResponse = 0;
      boolean sendSuccess;
-     sendSuccess = ourRadio.transmit(*ourRemoteCmd.createCommand(F3XRemoteCommandType::BLineStateResp, String(ourBatteryVoltageRaw)), 5);
+     sendSuccess = ourRadio.transmit(ourRemoteCmd.createFrame(F3XRemoteCommandType::BLineStateResp, ourBatteryVoltageRaw), 5);
      if (!sendSuccess) {
        logMsg(INFO, String(F("sending BLineStateResp not successsfull. Retransmissions: ")) + String(ourRadio.getRetransmissionCount()));
      } else {
@@ -55,6 +55,14 @@ unsigned long ourSecond = 0;
 
 F3XRemoteCommand ourRemoteCmd;
 unsigned long ourTimedReset = 0;
+// if nothing is received after a change of the radio settings (e.g. the BaseManager could
+// not follow a channel switch), the previous settings are restored
+#define RADIO_FALLBACK_DELAY 10000
+unsigned long ourRadioFallbackTime = 0;
+uint8_t ourRadioFallbackPower;
+uint8_t ourRadioFallbackChannel;
+uint8_t ourRadioFallbackDatarate;
+boolean ourRadioFallbackAck;
 uint16_t ourBatteryVoltage=0;
 uint16_t ourBatteryVoltageRaw=0;
 
@@ -104,7 +112,7 @@ void setupConfig() {
 }
 
 void setupRF() {
-  ourRadio.begin(2);
+  ourRadio.begin(RFTransceiver::F3XRemoteBuzzer);
   logMsg(INFO, F("setup for RCTTransceiver/nRF24L01 successful "));   
 }
 
@@ -167,18 +175,22 @@ void setup() {
   #endif
 
   setupRF();
-  ourRemoteCmd.begin();
+  ourRemoteCmd.begin(RFTransceiver::F3XRemoteBuzzer);
   ourBuzzer.pattern(5, 100,50,100,50,500);
 }
 
 
 void updateRadio(unsigned long aNow) { 
+  // receive time, used to answer the clock synchronization round trips
+  static unsigned long rxTime = 0;
   while (ourRadio.available()) { 
-    ourRemoteCmd.write(ourRadio.read());
+    rxTime = millis();
+    char* payload = ourRadio.read();
+    ourRemoteCmd.write(payload, ourRadio.getReadLength());
   }
 
   if (ourRemoteCmd.available()) {
-    String* arg;
+    int16_t arg;
     uint8_t argNum = -1;
     int8_t radioPower;
     uint8_t radioChannel;
@@ -187,17 +199,25 @@ void updateRadio(unsigned long aNow) {
     switch (ourRemoteCmd.getType()) {
       case F3XRemoteCommandType::RemoteSignalBuzz:
         {
-          int duration=ourRemoteCmd.getArg(0)->toInt();
+          int duration=ourRemoteCmd.getArg(0);
           LOGGY(INFO, String("received RemoteSignalBuzz:") + String(duration));
           ourBuzzer.on(duration);
         }
         break;
       case F3XRemoteCommandType::CmdSetRadio:
-        radioPower=ourRemoteCmd.getArg(0)->toInt();
-        radioChannel=ourRemoteCmd.getArg(1)->toInt();
-        radioDatarate=ourRemoteCmd.getArg(2)->toInt();
-        radioAck=ourRemoteCmd.getArg(3)->toInt()==1?true:false;
-
+        radioPower=ourRemoteCmd.getArg(0);
+        radioChannel=ourRemoteCmd.getArg(1);
+        radioDatarate=ourRemoteCmd.getArg(2);
+        radioAck=ourRemoteCmd.getArg(3)==1?true:false;
+
+        if (radioPower != ourRadio.getPower() || radioChannel != ourRadio.getChannel()
+            || radioDatarate != ourRadio.getDataRate() || radioAck != ourRadio.getAck()) {
+          ourRadioFallbackPower = ourRadio.getPower();
+          ourRadioFallbackChannel = ourRadio.getChannel();
+          ourRadioFallbackDatarate = ourRadio.getDataRate();
+          ourRadioFallbackAck = ourRadio.getAck();
+          ourRadioFallbackTime = aNow + RADIO_FALLBACK_DELAY;
+        }
         ourRadio.setPower(radioPower);
         ourRadio.setChannel(radioChannel);
         ourRadio.setDataRate(radioDatarate);
@@ -208,20 +228,20 @@ void updateRadio(unsigned long aNow) {
         logMsg(INFO, String("received CmdSetPower: channel: ") + String(radioChannel));
         logMsg(INFO, String("received CmdSetPower: datarate: ") + String(radioDatarate));
         logMsg(INFO, String("received CmdSetPower: ack: ") + String(radioAck));
-        logMsg(INFO, String("received CmdSetPower: power,chan,rate,ack: ") + *ourRemoteCmd.getArg());
         break;
       case F3XRemoteCommandType::CmdRestartMC:
         ourTimedReset = aNow + 500; // reset in 500ms
         break;
       case F3XRemoteCommandType::CmdCycleTestRequest:
-        arg = ourRemoteCmd.getArg();
-        LOGGY(INFO, String("received CmdCycleTestRequest:") + *arg);
-        if (arg->toInt() == 17) {
-          LOGGY(INFO, String("!!!!!!!!!!!!!!  ignoring CmdCycleTestAnswer:") + *arg);
+        arg = ourRemoteCmd.getArg(0);
+        LOGGY(INFO, String("received CmdCycleTestRequest:") + String(arg));
+        if (arg == 17) {
+          LOGGY(INFO, String("!!!!!!!!!!!!!!  ignoring CmdCycleTestAnswer:") + String(arg));
         } else {
-          LOGGY(INFO, String("sending CmdCycleTestAnswer:") + *arg);
+          LOGGY(INFO, String("sending CmdCycleTestAnswer:") + String(arg));
           boolean sendSuccess;
-          sendSuccess = ourRadio.transmit(*ourRemoteCmd.createCommand(F3XRemoteCommandType::CmdCycleTestAnswer, *arg), 5);
+          // the frame time stamp is the send time, arg 1 the time since the request was received
+          sendSuccess = ourRadio.transmit(ourRemoteCmd.createFrame(F3XRemoteCommandType::CmdCycleTestAnswer, arg, millis() - rxTime), 5);
           if (!sendSuccess) {
             logMsg(INFO, String(F("sending TestAnswer not successsfull. Retransmissions: ")) + String(ourRadio.getRetransmissionCount()));
           }
@@ -232,7 +252,7 @@ void updateRadio(unsigned long aNow) {
         // String* arg = ourRemoteCmd.getArg();
         LOGGY(INFO, String("received RemoteSignalStateReq:"));
           boolean sendSuccess;
-          sendSuccess = ourRadio.transmit(*ourRemoteCmd.createCommand(F3XRemoteCommandType::RemoteSignalStateResp, String(ourBatteryVoltageRaw)), 5);
+          sendSuccess = ourRadio.transmit(ourRemoteCmd.createFrame(F3XRemoteCommandType::RemoteSignalStateResp, ourBatteryVoltageRaw), 5);
           if (!sendSuccess) {
             logMsg(INFO, String(F("sending RemoteSignalStateResp not successsfull. Retransmissions: ")) + String(ourRadio.getRetransmissionCount()));
           }
@@ -242,6 +262,10 @@ void updateRadio(unsigned long aNow) {
         logMsg(INFO, "consuming wrong command");
         break;
     }
+    if (ourRemoteCmd.getType() != F3XRemoteCommandType::CmdSetRadio) {
+      // any other frame confirms the current radio settings
+      ourRadioFallbackTime = 0;
+    }
     ourRemoteCmd.consume();
   }
 
@@ -262,6 +286,14 @@ void updateTimedEvents(unsigned long aNow) {
      ourTimedReset = 0;
      resetFunc();
   }
+  if (ourRadioFallbackTime != 0 && aNow > ourRadioFallbackTime) {
+     ourRadioFallbackTime = 0;
+     logMsg(ERROR, String(F("nothing received with new radio settings, back to channel: ")) + String(ourRadioFallbackChannel));
+     ourRadio.setPower(ourRadioFallbackPower);
+     ourRadio.setChannel(ourRadioFallbackChannel);
+     ourRadio.setDataRate(ourRadioFallbackDatarate);
+     ourRadio.setAck(ourRadioFallbackAck);
+  }
 }
 
 void loop() {
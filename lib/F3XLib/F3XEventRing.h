@@ -0,0 +1,89 @@
+#ifndef F3XEventRing_h
+#define F3XEventRing_h
+
+#include <Arduino.h>
+
+#ifndef IRAM_ATTR
+#define IRAM_ATTR // AVR: no separate instruction RAM, ISR code runs from flash
+#endif
+
+/**
+ * lock free single producer / single consumer ring for time stamps (e.g. micros()) of events.
+ * The producer (typically an ISR) only modifies myHead, the consumer (the main loop) only
+ * modifies myTail. Both indices are single bytes, so they are read and written atomically
+ * on the ESP8266 and the AVR and no interrupt locking is needed.
+ * SIZE has to be a power of 2, one slot is kept free to distinguish full and empty.
+ */
+template <uint8_t SIZE>
+class F3XEventRing {
+  static_assert(SIZE >= 2 && (SIZE & (SIZE - 1)) == 0, "F3XEventRing SIZE has to be a power of 2");
+  public:
+    F3XEventRing() {
+      clear();
+    }
+
+    /**
+     * drop all stored events, must not be called while the producer is active
+     */
+    void clear() {
+      myHead = 0;
+      myTail = 0;
+      myOverflowCnt = 0;
+    }
+
+    /**
+     * store a new time stamp, called by the producer (ISR) only
+     * returns false, if the ring is full and the time stamp was dropped
+     */
+    IRAM_ATTR bool push(uint32_t aTimestamp) {
+      uint8_t next = (myHead + 1) & (SIZE - 1);
+      if (next == myTail) {
+        myOverflowCnt++;
+        return false;
+      }
+      myBuffer[myHead] = aTimestamp;
+      myHead = next;
+      return true;
+    }
+
+    /**
+     * read and remove the oldest time stamp, called by the consumer only
+     * returns false, if no time stamp is available
+     */
+    bool pop(uint32_t* aTimestamp) {
+      if (myHead == myTail) {
+        return false;
+      }
+      *aTimestamp = myBuffer[myTail];
+      myTail = (myTail + 1) & (SIZE - 1);
+      return true;
+    }
+
+    /**
+     * read the oldest time stamp without removing it, called by the consumer only
+     * returns false, if no time stamp is available
+     */
+    bool peek(uint32_t* aTimestamp) {
+      if (myHead == myTail) {
+        return false;
+      }
+      *aTimestamp = myBuffer[myTail];
+      return true;
+    }
+
+    bool available() {
+      return myHead != myTail;
+    }
+
+    uint16_t getOverflowCount() {
+      return myOverflowCnt;
+    }
+
+  private:
+    volatile uint32_t myBuffer[SIZE];
+    volatile uint8_t myHead;
+    volatile uint8_t myTail;
+    volatile uint16_t myOverflowCnt;
+};
+
+#endif
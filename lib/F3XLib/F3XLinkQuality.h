@@ -0,0 +1,159 @@
+#ifndef F3XLinkQuality_h
+#define F3XLinkQuality_h
+
+#include <Arduino.h>
+#include "LatencyHistogram.h"
+
+#define F3X_LQ_WINDOW       32     // transmission attempts of the packet error window
+#define F3X_LQ_MAX_ARC      15     // auto retransmissions of the nRF24L01, a sample with this ARC has quality 0
+#define F3X_LQ_FAST_ALPHA   0.25f  // smoothing of the short term quality
+#define F3X_LQ_SLOW_ALPHA   0.03f  // smoothing of the long term quality
+#define F3X_LQ_TREND_DIFF   10.0f  // short/long term difference (%) for an improving/degrading trend
+
+/**
+ * non blocking link quality estimation of one peer, fed with the result (ACK received or not,
+ * auto retransmit count ARC) of each transmission attempt of the normal radio traffic.
+ * Delivers the packet error rate and mean ARC of the last F3X_LQ_WINDOW attempts, a latency
+ * histogram of the successful transmissions and the trend of a short vs. a long term quality.
+ */
+class F3XLinkQuality {
+  public:
+    typedef enum Trend {
+      TrendStable = 0,
+      TrendImproving,
+      TrendDegrading,
+    } Trend;
+
+    F3XLinkQuality() {
+      reset();
+    }
+
+    void reset() {
+      myLostMask = 0;
+      myArcSum = 0;
+      myCnt = 0;
+      myIdx = 0;
+      myTotal = 0;
+      myLostTotal = 0;
+      myFast = 0.0f;
+      mySlow = 0.0f;
+      myLatency.reset();
+    }
+
+    void record(boolean aSuccess, uint8_t aArc, uint32_t aLatencyUs) {
+      // the ARC of a lost attempt is the max. retransmission count, it is covered by the packet error rate
+      uint8_t arc = !aSuccess ? 0 : aArc > F3X_LQ_MAX_ARC ? F3X_LQ_MAX_ARC : aArc;
+      uint32_t bit = 1UL << myIdx;
+      if (myCnt == F3X_LQ_WINDOW) {
+        // drop the oldest sample of the window
+        myArcSum -= myArc[myIdx];
+      } else {
+        myCnt++;
+      }
+      myArc[myIdx] = arc;
+      myArcSum += arc;
+      if (aSuccess) {
+        myLostMask &= ~bit;
+        myLatency.record(aLatencyUs);
+      } else {
+        myLostMask |= bit;
+        myLostTotal++;
+      }
+      myIdx = (myIdx + 1) % F3X_LQ_WINDOW;
+
+      float quality = aSuccess ? 100.0f - (100.0f * arc) / F3X_LQ_MAX_ARC : 0.0f;
+      if (myTotal == 0) {
+        myFast = quality;
+        mySlow = quality;
+      } else {
+        myFast += F3X_LQ_FAST_ALPHA * (quality - myFast);
+        mySlow += F3X_LQ_SLOW_ALPHA * (quality - mySlow);
+      }
+      myTotal++;
+    }
+
+    /**
+     * packet error rate of the window in percent
+     */
+    float getPacketErrorRate() {
+      return myCnt == 0 ? 0.0f : (100.0f * getLostCnt()) / myCnt;
+    }
+
+    /**
+     * mean auto retransmit count of the acknowledged attempts of the window
+     */
+    float getMeanArc() {
+      uint8_t acked = myCnt - getLostCnt();
+      return acked == 0 ? 0.0f : (float) myArcSum / acked;
+    }
+
+    /**
+     * quality of the window in percent: lost attempts count 0%, successful ones are
+     * reduced by their retransmissions
+     */
+    float getQuality() {
+      if (myCnt == 0) {
+        return 0.0f;
+      }
+      float per = getPacketErrorRate();
+      return (100.0f - per) * (1.0f - getMeanArc() / F3X_LQ_MAX_ARC);
+    }
+
+    Trend getTrend() {
+      if (myFast > mySlow + F3X_LQ_TREND_DIFF) {
+        return TrendImproving;
+      }
+      if (myFast < mySlow - F3X_LQ_TREND_DIFF) {
+        return TrendDegrading;
+      }
+      return TrendStable;
+    }
+
+    /**
+     * trend as a single character: '+' improving, '-' degrading, '=' stable
+     */
+    char getTrendChar() {
+      switch (getTrend()) {
+        case TrendImproving:
+          return '+';
+        case TrendDegrading:
+          return '-';
+        default:
+          return '=';
+      }
+    }
+
+    LatencyHistogram* getLatency() {
+      return &myLatency;
+    }
+
+    uint32_t getSamples() {
+      return myTotal;
+    }
+
+    uint32_t getLostSamples() {
+      return myLostTotal;
+    }
+
+  private:
+    uint8_t getLostCnt() {
+      uint8_t lost = 0;
+      for (uint32_t mask = myLostMask; mask != 0; mask &= mask - 1) {
+        lost++;
+      }
+      return lost;
+    }
+
+    uint8_t myArc[F3X_LQ_WINDOW];
+    uint32_t myLostMask;          // bit i: attempt i of the window was not acknowledged
+    uint16_t myArcSum;
+    uint8_t myCnt;
+    uint8_t myIdx;
+    uint32_t myTotal;
+    uint32_t myLostTotal;
+    float myFast;
+    float mySlow;
+    LatencyHistogram myLatency;
+};
+
+#endif
@@ -2,214 +2,225 @@
 #include "Logger.h"
 #include "F3XRemoteCommand.h"
 
-#define F3X_RC_CMD_OUT_BUF_SIZE 30
-
 // #define DEBUG
 F3XRemoteCommand::F3XRemoteCommand() {
+  begin();
 }
 
-void F3XRemoteCommand::write(char aChar) {
-  // reads char by char from a serial interface and put it to buffer
-  //
-  // #ifdef USE_RXTX_AS_GPIO
-  // Serial.print("F3XRemoteCommand::write : ");
-  // Serial.println(aChar);
-  // Serial.print("F3XRemoteCommand::myBuffer : ");
-  // Serial.println(myBuffer);
-  // #endif
-  myBuffer += aChar;
-}
-void F3XRemoteCommand::write(char* aData) {
-  // reads char by char from a serial interface and put it to buffer
-  //
-  // #ifdef USE_RXTX_AS_GPIO
-  // Serial.print("F3XRemoteCommand::write : ");
-  // Serial.println(aChar);
-  // Serial.print("F3XRemoteCommand::myBuffer : ");
-  // Serial.println(myBuffer);
-  // #endif
-  myBuffer += String(aData);
+void F3XRemoteCommand::begin(uint8_t aDeviceId) {
+  myDeviceId = aDeviceId;
+  myHead = 0;
+  myTail = 0;
+  mySeq = F3X_RC_SEQ_NONE;
+  myCrcErrorCnt = 0;
+  myOverflowCnt = 0;
 }
 
-void F3XRemoteCommand::consume() {
-  int eofCmd = myBuffer.indexOf(';');
-  // #ifdef USE_RXTX_AS_GPIO
-  // Serial.print("F3XRemoteCommand::consume : ");
-  // Serial.println(eofCmd);
-  // Serial.print("F3XRemoteCommand::myBuffer : ");
-  // Serial.println(myBuffer);
-  // #endif
-  if (eofCmd != -1) {
-    myBuffer.remove(0, eofCmd+1);
-  // #ifdef USE_RXTX_AS_GPIO
-  // Serial.print("F3XRemoteCommand::myBuffer : ");
-  // Serial.println(myBuffer);
-  // #endif
+/**
+ * CRC-8 with polynomial 0x07, bitwise to avoid a 256 byte table on the Nano
+ */
+uint8_t F3XRemoteCommand::crc8(const uint8_t* aData, uint8_t aLen) {
+  uint8_t crc = 0;
+  for (uint8_t i=0; i<aLen; i++) {
+    crc ^= aData[i];
+    for (uint8_t b=0; b<8; b++) {
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+    }
   }
+  return crc;
 }
 
-void F3XRemoteCommand::begin() {
-  myBuffer = "";
+boolean F3XRemoteCommand::push(const F3XRemoteFrame* aFrame, uint32_t aRxTimestamp) {
+  uint8_t next = (myHead + 1) % F3X_RC_QUEUE_SIZE;
+  if (next == myTail) {
+    myOverflowCnt++;
+    logMsg(ERROR, String(F("F3XRemoteCommand: queue full, frame dropped, type: ")) + String(aFrame->type));
+    return false;
+  }
+  memcpy(&myQueue[myHead], aFrame, sizeof(F3XRemoteFrame));
+  myRxTimestamps[myHead] = aRxTimestamp;
+  myHead = next;
+  return true;
 }
 
-boolean F3XRemoteCommand::available() {
-  // #ifdef USE_RXTX_AS_GPIO
-  // Serial.print("F3XRemoteCommand::available : ");
-  // Serial.println(myBuffer.indexOf(';') != -1);
-  // #endif
-  return (myBuffer.indexOf(';') != -1);
-}
-
-String* F3XRemoteCommand::createCommand(F3XRemoteCommandType aCmdType, String aArg) {
-  String* cmd = createCommand(aCmdType);
-  cmd->remove(1,1);
-  *cmd = *cmd + aArg;
-  *cmd = *cmd + ";";
-  #ifdef DEBUG
-  #ifdef USE_RXTX_AS_GPIO
-  Serial.print("F3XRemoteCommand::createCommand : ");
-  Serial.println(*cmd);
-  #endif
+/**
+ * decode a received radio payload (binary frame or legacy ASCII command),
+ * aRxTimestamp is the reception time (e.g. micros()) kept with the frame.
+ * returns false, if the payload was rejected
+ */
+boolean F3XRemoteCommand::write(const char* aData, uint8_t aLen, uint32_t aRxTimestamp) {
+  const F3XRemoteFrame* frame = (const F3XRemoteFrame*) aData;
+  if (aLen == sizeof(F3XRemoteFrame) && frame->magic == F3X_RC_FRAME_MAGIC) {
+    if (crc8((const uint8_t*) aData, sizeof(F3XRemoteFrame)-1) != frame->crc) {
+      myCrcErrorCnt++;
+      logMsg(ERROR, String(F("F3XRemoteCommand: CRC error, frame dropped, type: ")) + String(frame->type));
+      return false;
+    }
+    if (frame->type == (uint8_t) F3XRemoteCommandType::Invalid
+        || frame->type > (uint8_t) F3XRemoteCommandType::RemoteSignalStateResp) {
+      logMsg(ERROR, String(F("F3XRemoteCommand: unknown command type: ")) + String(frame->type));
+      return false;
+    }
+    return push(frame, aRxTimestamp);
+  }
+  #ifdef F3X_RC_ACCEPT_LEGACY
+  writeLegacy(aData, aLen, aRxTimestamp);
+  return true;
+  #else
+  logMsg(ERROR, String(F("F3XRemoteCommand: invalid frame, len: ")) + String(aLen));
+  return false;
   #endif
-  return cmd;
-}
-
-String* F3XRemoteCommand::createCommand(F3XRemoteCommandType aCmdType) {
-  static String BUFFER;
-  switch (aCmdType) {
-    case F3XRemoteCommandType::CmdCycleTestAnswer:
-      BUFFER="A;";
-      break;
-    case F3XRemoteCommandType::SignalB:
-      BUFFER="B;";
-      break;
-    case F3XRemoteCommandType::RemoteSignalBuzz:
-      BUFFER="C;";
-      break;
-    case F3XRemoteCommandType::RemoteSignalStateReq:
-      BUFFER="D;";
-      break;
-    case F3XRemoteCommandType::RemoteSignalStateResp:
-      BUFFER="E;";
-      break;
-    case F3XRemoteCommandType::BLineStateReq:
-      BUFFER="M;";
-      break;
-    case F3XRemoteCommandType::BLineStateResp:
-      BUFFER="N;";
-      break;
-    case F3XRemoteCommandType::CmdCycleTestRequest:
-      BUFFER="R;";
-      break;
-    case F3XRemoteCommandType::CmdSetRadio:
-      BUFFER="S;";
-      break;
-    case F3XRemoteCommandType::ValBatB:
-      BUFFER="X;";
-      break;
-    case F3XRemoteCommandType::CmdRestartMC:
-      BUFFER="Y;";
-      break;
+}
+
+#ifdef F3X_RC_ACCEPT_LEGACY
+/**
+ * convert the legacy ASCII commands like "S1,83,0,1;" to frames,
+ * a payload may contain more than one command
+ */
+void F3XRemoteCommand::writeLegacy(const char* aData, uint8_t aLen, uint32_t aRxTimestamp) {
+  F3XRemoteFrame frame;
+  uint8_t pos = 0;
+  while (pos < aLen && aData[pos] != 0) {
+    memset(&frame, 0, sizeof(frame));
+    frame.magic = F3X_RC_FRAME_MAGIC;
+    frame.seq = F3X_RC_SEQ_NONE;
+    frame.device = F3X_RC_DEVICE_UNKNOWN;
+    F3XRemoteCommandType type = getLegacyType(aData[pos++]);
+    frame.type = (uint8_t) type;
+
+    uint8_t argIdx = 0;
+    int16_t value = 0;
+    boolean negative = false;
+    boolean complete = false;
+    while (pos < aLen && aData[pos] != 0) {
+      char c = aData[pos++];
+      if (c == ';' || c == ',') {
+        if (argIdx < F3X_RC_FRAME_ARGS) {
+          frame.args[argIdx++] = negative ? -value : value;
+        }
+        value = 0;
+        negative = false;
+        if (c == ';') {
+          complete = true;
+          break;
+        }
+      } else if (c == '-') {
+        negative = true;
+      } else if (c >= '0' && c <= '9') {
+        value = value * 10 + (c - '0');
+      }
+    }
+    if (!complete) {
+      logMsg(ERROR, F("F3XRemoteCommand: incomplete legacy command dropped"));
+      return;
+    }
+    if (type == F3XRemoteCommandType::Invalid) {
+      logMsg(ERROR, String(F("ERROR: F3XRemoteCommand unknown legacy command type: ")) + String(aData));
+      continue;
+    }
+    push(&frame, aRxTimestamp);
   }
+}
 
-  #ifdef DEBUG
-  #ifdef USE_RXTX_AS_GPIO
-  Serial.print("F3XRemoteCommand::createCommand : "); 
-  Serial.println(BUFFER);
-  #endif
-  #endif
-  return &BUFFER;
+F3XRemoteCommandType F3XRemoteCommand::getLegacyType(char aChar) {
+  switch (aChar) {
+    case 'A': return F3XRemoteCommandType::CmdCycleTestAnswer;
+    case 'B': return F3XRemoteCommandType::SignalB;
+    case 'C': return F3XRemoteCommandType::RemoteSignalBuzz;
+    case 'D': return F3XRemoteCommandType::RemoteSignalStateReq;
+    case 'E': return F3XRemoteCommandType::RemoteSignalStateResp;
+    case 'M': return F3XRemoteCommandType::BLineStateReq;
+    case 'N': return F3XRemoteCommandType::BLineStateResp;
+    case 'R': return F3XRemoteCommandType::CmdCycleTestRequest;
+    case 'S': return F3XRemoteCommandType::CmdSetRadio;
+    case 'X': return F3XRemoteCommandType::ValBatB;
+    case 'Y': return F3XRemoteCommandType::CmdRestartMC;
+    default:  return F3XRemoteCommandType::Invalid;
+  }
+}
+#endif
+
+void F3XRemoteCommand::consume() {
+  if (myHead != myTail) {
+    myTail = (myTail + 1) % F3X_RC_QUEUE_SIZE;
+  }
 }
 
-String* F3XRemoteCommand::getBuffer() {
-  static String retVal;
-  retVal = myBuffer;
-  return &retVal;
+boolean F3XRemoteCommand::available() {
+  return myHead != myTail;
 }
 
-String* F3XRemoteCommand::getArg(int8_t aIdx) {
-  static String retVal;
-  retVal=F(""); 
+F3XRemoteCommandType F3XRemoteCommand::getType() {
+  if (myHead == myTail) {
+    return F3XRemoteCommandType::Invalid;
+  }
+  return (F3XRemoteCommandType) myQueue[myTail].type;
+}
 
-  int eofCmd = myBuffer.indexOf(';');
-  if (eofCmd > 1) {
-    retVal = myBuffer.substring(1, eofCmd);
+int16_t F3XRemoteCommand::getArg(uint8_t aIdx) {
+  if (myHead == myTail || aIdx >= F3X_RC_FRAME_ARGS) {
+    return 0;
   }
+  return myQueue[myTail].args[aIdx];
+}
+
+uint8_t F3XRemoteCommand::getSeq() {
+  return myHead == myTail ? F3X_RC_SEQ_NONE : myQueue[myTail].seq;
+}
+
+uint8_t F3XRemoteCommand::getDevice() {
+  return myHead == myTail ? F3X_RC_DEVICE_UNKNOWN : myQueue[myTail].device;
+}
+
+uint32_t F3XRemoteCommand::getTimestamp() {
+  return myHead == myTail ? 0 : myQueue[myTail].timestamp;
+}
+
+uint32_t F3XRemoteCommand::getRxTimestamp() {
+  return myHead == myTail ? 0 : myRxTimestamps[myTail];
+}
+
+uint16_t F3XRemoteCommand::getCrcErrorCount() {
+  return myCrcErrorCnt;
+}
+
+uint16_t F3XRemoteCommand::getOverflowCount() {
+  return myOverflowCnt;
+}
+
+/**
+ * fill the (single) output frame with the next sequence number, the current time and the CRC,
+ * the returned frame is valid until the next call
+ */
+F3XRemoteFrame* F3XRemoteCommand::createFrame(F3XRemoteCommandType aCmdType,
+    int16_t aArg0, int16_t aArg1, int16_t aArg2, int16_t aArg3) {
+  if (++mySeq == F3X_RC_SEQ_NONE) {
+    mySeq++;
+  }
+  myOutFrame.magic = F3X_RC_FRAME_MAGIC;
+  myOutFrame.type = (uint8_t) aCmdType;
+  myOutFrame.seq = mySeq;
+  myOutFrame.device = myDeviceId;
+  myOutFrame.timestamp = millis();
+  myOutFrame.args[0] = aArg0;
+  myOutFrame.args[1] = aArg1;
+  myOutFrame.args[2] = aArg2;
+  myOutFrame.args[3] = aArg3;
+  myOutFrame.crc = crc8((const uint8_t*) &myOutFrame, sizeof(F3XRemoteFrame)-1);
   #ifdef DEBUG
   #ifdef USE_RXTX_AS_GPIO
-  Serial.print("F3XRemoteCommand::getArg : " );
-  Serial.print(myBuffer);
-  Serial.print("/");
-  Serial.print(retVal);
-  Serial.print("/");
-  Serial.print(String(eofCmd));
-  Serial.print("/");
-  Serial.print(String(aIdx));
-  Serial.println();
+  Serial.print("F3XRemoteCommand::createFrame : ");
+  Serial.println(myOutFrame.type);
   #endif
   #endif
-
-  if (aIdx > -1) {
-    int found = 0;
-    int strIndex[] = {0, -1};
-    int maxIndex = retVal.length()-1;
-      
-    for(int i=0; i<=maxIndex && found<=aIdx; i++){
-      if(retVal.charAt(i)== ',' || i==maxIndex){
-          found++;
-          strIndex[0] = strIndex[1]+1;
-          strIndex[1] = (i == maxIndex) ? i+1 : i;
-      }
-    }
-  
-    retVal =  found>aIdx ? retVal.substring(strIndex[0], strIndex[1]) : "";
-  }
-  return &retVal;
+  return &myOutFrame;
 }
 
-F3XRemoteCommandType F3XRemoteCommand::getType() {
-  F3XRemoteCommandType retVal = F3XRemoteCommandType::Invalid;
-  int eofCmd = myBuffer.indexOf(';');
-  if (eofCmd != -1) {
-    switch ( myBuffer.charAt(0)) {
-      case 'A':
-        retVal = F3XRemoteCommandType::CmdCycleTestAnswer;
-        break;
-      case 'B':
-        retVal = F3XRemoteCommandType::SignalB;
-        break;
-      case 'C':
-        retVal = F3XRemoteCommandType::RemoteSignalBuzz;
-        break;
-      case 'D':
-        retVal = F3XRemoteCommandType::RemoteSignalStateReq;
-        break;
-      case 'E':
-        retVal = F3XRemoteCommandType::RemoteSignalStateResp;
-        break;
-      case 'M':
-        retVal = F3XRemoteCommandType::BLineStateReq;
-        break;
-      case 'N':
-        retVal = F3XRemoteCommandType::BLineStateResp;
-        break;
-      case 'R':
-        retVal = F3XRemoteCommandType::CmdCycleTestRequest;
-        break;
-      case 'S':
-        retVal = F3XRemoteCommandType::CmdSetRadio;
-        break;
-      case 'X':
-        retVal = F3XRemoteCommandType::ValBatB;
-        break;
-      case 'Y':
-        retVal = F3XRemoteCommandType::CmdRestartMC;
-        break;
-      default:
-        Logger::getInstance().log(ERROR, String("ERROR: F3XRemoteCommand::getCommand unknown command type, buf : ") + myBuffer);
-        retVal = F3XRemoteCommandType::Invalid;
-        break;
-    }
-  }
-  return retVal;
+/**
+ * replace the time stamp of the last created frame, e.g. by the time a button was pressed
+ */
+F3XRemoteFrame* F3XRemoteCommand::setTimestamp(uint32_t aTimestamp) {
+  myOutFrame.timestamp = aTimestamp;
+  myOutFrame.crc = crc8((const uint8_t*) &myOutFrame, sizeof(F3XRemoteFrame)-1);
+  return &myOutFrame;
 }
@@ -1,7 +1,10 @@
 #ifndef F3XRemoteCommand_h
 #define F3XRemoteCommand_h
 
-enum class F3XRemoteCommandType { 
+#include <Arduino.h>
+
+// the numeric values are part of the binary radio protocol, do not reorder, only append
+enum class F3XRemoteCommandType {
   SignalB,
   CmdCycleTestRequest,
   CmdCycleTestAnswer,
@@ -17,22 +20,69 @@ enum class F3XRemoteCommandType {
   RemoteSignalStateResp,
 };
 
+#define F3X_RC_FRAME_MAGIC    0xF3  // never a valid first char of a legacy ASCII command
+#define F3X_RC_FRAME_ARGS        4
+#define F3X_RC_QUEUE_SIZE        4  // received frames, which can be buffered until consumed
+#define F3X_RC_DEVICE_UNKNOWN 0xFF  // device id of legacy ASCII commands
+#define F3X_RC_SEQ_NONE          0  // sequence number of legacy ASCII commands
+
+// accept the legacy ASCII commands (e.g. "B12;") of not yet updated devices
+#define F3X_RC_ACCEPT_LEGACY
+
+/**
+ * binary radio frame, sent as is via the nRF24L01 (17 of max. 32 bytes).
+ * All devices (AVR, ESP8266) are little endian, so no byte swapping is needed.
+ */
+typedef struct __attribute__((packed)) {
+  uint8_t magic;      // F3X_RC_FRAME_MAGIC
+  uint8_t type;       // F3XRemoteCommandType
+  uint8_t seq;        // sequence number per sender, 1..255, 0 for "no sequence"
+  uint8_t device;     // RFTransceiver::F3XDeviceType of the sender
+  uint32_t timestamp; // millis() of the sender at frame creation
+  int16_t args[F3X_RC_FRAME_ARGS];
+  uint8_t crc;        // CRC-8 of all preceding bytes
+} F3XRemoteFrame;
+
+/**
+ * encoder / decoder of F3XRemoteFrame without any heap usage.
+ * Received payloads are checked and copied to a small frame queue,
+ * the oldest frame is accessed by getType()/getArg() and removed by consume().
+ */
 class F3XRemoteCommand
 {
 public:
   F3XRemoteCommand();
-  void begin();
-  void write(char aChar);
-  void write(char* aData);
+  void begin(uint8_t aDeviceId=F3X_RC_DEVICE_UNKNOWN);
+  boolean write(const char* aData, uint8_t aLen, uint32_t aRxTimestamp=0);
   void consume();
   boolean available();
   F3XRemoteCommandType getType();
-  String* getArg(int8_t aIdx=-1);
-  String* getBuffer();
-  String* createCommand(F3XRemoteCommandType);
-  String* createCommand(F3XRemoteCommandType, String );
+  int16_t getArg(uint8_t aIdx=0);
+  uint8_t getSeq();
+  uint8_t getDevice();
+  uint32_t getTimestamp();
+  uint32_t getRxTimestamp();
+  F3XRemoteFrame* createFrame(F3XRemoteCommandType aCmdType,
+    int16_t aArg0=0, int16_t aArg1=0, int16_t aArg2=0, int16_t aArg3=0);
+  F3XRemoteFrame* setTimestamp(uint32_t aTimestamp);
+  uint16_t getCrcErrorCount();
+  uint16_t getOverflowCount();
+  static uint8_t crc8(const uint8_t* aData, uint8_t aLen);
 protected:
-  String myBuffer;
+  boolean push(const F3XRemoteFrame* aFrame, uint32_t aRxTimestamp);
+  #ifdef F3X_RC_ACCEPT_LEGACY
+  void writeLegacy(const char* aData, uint8_t aLen, uint32_t aRxTimestamp);
+  static F3XRemoteCommandType getLegacyType(char aChar);
+  #endif
+  F3XRemoteFrame myQueue[F3X_RC_QUEUE_SIZE];
+  uint32_t myRxTimestamps[F3X_RC_QUEUE_SIZE];
+  uint8_t myHead;
+  uint8_t myTail;
+  F3XRemoteFrame myOutFrame;
+  uint8_t myDeviceId;
+  uint8_t mySeq;
+  uint16_t myCrcErrorCnt;
+  uint16_t myOverflowCnt;
 };
 
 #endif
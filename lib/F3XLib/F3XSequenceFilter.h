@@ -0,0 +1,80 @@
+#ifndef F3XSequenceFilter_h
+#define F3XSequenceFilter_h
+
+#include <Arduino.h>
+#include "F3XRemoteCommand.h"
+
+#define F3X_SEQ_FILTER_DEVICES 5   // RFTransceiver::F3XDeviceType values
+#define F3X_SEQ_RESTART_MS  1000   // sender time stamp running backwards more than this: sender restarted
+
+/**
+ * per device duplicate filter for received frames, based on the sequence number with a
+ * sliding window of the last 32 sequence numbers (similar to the IPsec anti replay window).
+ * A retransmitted frame (e.g. the ACK of the first transmission was lost) has the same
+ * sequence number and is dropped, so a signal is counted only once.
+ * Frames without sequence number (legacy ASCII commands) are always accepted.
+ * A restart of the sender is detected by its time stamp running backwards.
+ */
+class F3XSequenceFilter {
+  public:
+    F3XSequenceFilter() {
+      reset();
+    }
+
+    void reset() {
+      for (uint8_t i=0; i<F3X_SEQ_FILTER_DEVICES; i++) {
+        myValid[i] = false;
+      }
+      myDuplicateCnt = 0;
+    }
+
+    /**
+     * returns true, if the frame is new and has to be handled, false for a duplicate
+     */
+    boolean accept(uint8_t aDevice, uint8_t aSeq, uint32_t aTimestamp) {
+      if (aSeq == F3X_RC_SEQ_NONE || aDevice >= F3X_SEQ_FILTER_DEVICES) {
+        return true;
+      }
+      if (!myValid[aDevice] || aTimestamp + F3X_SEQ_RESTART_MS < myLastTimestamp[aDevice]) {
+        // first frame or sender restarted
+        myValid[aDevice] = true;
+        myLastSeq[aDevice] = aSeq;
+        myWindow[aDevice] = 1;
+        myLastTimestamp[aDevice] = aTimestamp;
+        return true;
+      }
+      int8_t diff = (int8_t) (uint8_t) (aSeq - myLastSeq[aDevice]);
+      if (diff > 0) {
+        // newer sequence number, move the window
+        myWindow[aDevice] = diff >= 32 ? 1 : (myWindow[aDevice] << diff) | 1;
+        myLastSeq[aDevice] = aSeq;
+        myLastTimestamp[aDevice] = aTimestamp;
+        return true;
+      }
+      uint8_t offset = -diff;
+      if (offset >= 32) {
+        // too old to be checked, but a sequence that far behind is no retransmission
+        return true;
+      }
+      uint32_t bit = 1UL << offset;
+      if (myWindow[aDevice] & bit) {
+        myDuplicateCnt++;
+        return false;
+      }
+      myWindow[aDevice] |= bit;
+      return true;
+    }
+
+    uint16_t getDuplicateCount() {
+      return myDuplicateCnt;
+    }
+
+  private:
+    boolean myValid[F3X_SEQ_FILTER_DEVICES];
+    uint8_t myLastSeq[F3X_SEQ_FILTER_DEVICES];
+    uint32_t myWindow[F3X_SEQ_FILTER_DEVICES];
+    uint32_t myLastTimestamp[F3X_SEQ_FILTER_DEVICES];
+    uint16_t myDuplicateCnt;
+};
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef LatencyHistogram_h
+#define LatencyHistogram_h
+
+#include <Arduino.h>
+
+#define LATENCY_HIST_BUCKETS 24  // bucket i counts values in [2^(i-1), 2^i), last bucket: >= 2^22
+
+/**
+ * allocation free latency histogram with log2 buckets,
+ * used to get p50/p99/max values of time critical code paths in microseconds
+ */
+class LatencyHistogram {
+  public:
+    LatencyHistogram() {
+      reset();
+    }
+
+    void reset() {
+      for (uint8_t i=0; i<LATENCY_HIST_BUCKETS; i++) {
+        myBuckets[i] = 0;
+      }
+      myCount = 0;
+      myMax = 0;
+    }
+
+    void record(uint32_t aValue) {
+      uint8_t idx = 0;
+      uint32_t v = aValue;
+      while (v != 0 && idx < LATENCY_HIST_BUCKETS-1) {
+        v >>= 1;
+        idx++;
+      }
+      if (myBuckets[idx] < UINT16_MAX) {
+        myBuckets[idx]++;
+      }
+      myCount++;
+      if (aValue > myMax) {
+        myMax = aValue;
+      }
+    }
+
+    /**
+     * return the upper limit of the bucket containing the aPercent percentile,
+     * e.g. getPercentile(50) for the median, max is used as upper limit for the highest bucket
+     */
+    uint32_t getPercentile(uint8_t aPercent) {
+      uint32_t total = 0;
+      for (uint8_t i=0; i<LATENCY_HIST_BUCKETS; i++) {
+        total += myBuckets[i];
+      }
+      if (total == 0) {
+        return 0;
+      }
+      uint32_t rank = (total * aPercent + 99) / 100;
+      uint32_t sum = 0;
+      for (uint8_t i=0; i<LATENCY_HIST_BUCKETS; i++) {
+        sum += myBuckets[i];
+        if (sum >= rank) {
+          uint32_t upper = (1UL << i) - 1;
+          return (i == LATENCY_HIST_BUCKETS-1 || upper > myMax) ? myMax : upper;
+        }
+      }
+      return myMax;
+    }
+
+    uint32_t getMax() {
+      return myMax;
+    }
+
+    uint32_t getCount() {
+      return myCount;
+    }
+
+    uint16_t getBucket(uint8_t aIdx) {
+      return myBuckets[aIdx];
+    }
+
+  private:
+    uint16_t myBuckets[LATENCY_HIST_BUCKETS];
+    uint32_t myCount;
+    uint32_t myMax;
+};
+
+#endif
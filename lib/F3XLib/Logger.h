@@ -32,15 +32,84 @@ enum LogSeverity {
 #define LOG_MOD_RADIO     5
 #define LOG_MOD_SIG       6
 #define LOG_MOD_BAT       7
-#define LOG_MOD_TASK      8 
+#define LOG_MOD_TASK      8
 #define LOG_MOD_TASKDATA  9
-#define LOG_MOD_NET      10 
-#define LOG_MOD_INTERNAL 11 
+#define LOG_MOD_NET      10
+#define LOG_MOD_INTERNAL 11
 
-#define NUM_MOD_LOG      12 
+#define NUM_MOD_LOG      12
 
-#define LOGBUFFSIZE 10
+#define LOGBUFFSIZE 10         // messages shown by the web log
 
+// calls of logMsg()/logEvent() below this severity are removed by the compiler, define it before
+// including Logger.h
+#ifndef LOG_MIN_SEVERITY
+#define LOG_MIN_SEVERITY DEBUG
+#endif
+
+#ifdef ESP8266
+#define LOG_RING_SIZE    24    // records not yet printed to Serial
+#define LOG_WEB_RING_SIZE LOGBUFFSIZE // records of the web log
+#define LOG_TEXT_LEN     72    // chars of a text message incl. '\0', longer ones are truncated
+#else
+#define LOG_RING_SIZE     4    // AVR: records of logEvent() only, text messages are printed at once
+#define LOG_WEB_RING_SIZE 0    // AVR: no web log
+#define LOG_TEXT_LEN      0
+#endif
+#define LOG_ARGS_MAX      3    // arguments of a logEvent() record
+#define LOG_FMT_TEXT    255    // format of a record of a text message
+#define LOG_FLUSH_MAX     4    // records printed per call of flush()
+
+/**
+ * argument of a logEvent() record: an integer for "%d" or a string literal for "%s", the pointer
+ * has its own member, it does not fit into an integer on every target
+ */
+class LogArg {
+  public:
+    LogArg(int aNum=0) {
+      myNum = aNum;
+    }
+    LogArg(unsigned int aNum) {
+      myNum = aNum;
+    }
+    LogArg(long aNum) {
+      myNum = aNum;
+    }
+    LogArg(unsigned long aNum) {
+      myNum = aNum;
+    }
+    LogArg(const char* aStr) {
+      myStr = aStr;
+    }
+
+    int32_t getNum() const {
+      return myNum;
+    }
+
+    const char* getStr() const {
+      return myStr;
+    }
+
+  private:
+    union {
+      int32_t myNum;
+      const char* myStr;
+    };
+};
+
+/**
+ * logging into a fixed ring of binary records (time stamp, module, severity, format id,
+ * arguments), nothing is allocated or formatted when a message is recorded. The records are
+ * printed to Serial later by flush(), called from the idle time of the loop. If the ring is full,
+ * the oldest not yet printed record is printed at once, so no message is lost.
+ * The records of the web log have their own ring of the last LOGBUFFSIZE messages, which are
+ * formatted on request, so a burst of Serial output does not evict them.
+ * logEvent() records the arguments for a format of the table set by setFormats(), e.g. for the
+ * hot paths. logMsg() records a text message, which is truncated to LOG_TEXT_LEN chars (AVR:
+ * printed at once). Both macros only evaluate their arguments, if the message is logged, and are
+ * removed completely below LOG_MIN_SEVERITY.
+ * The records are written and read from the loop only, so no interrupt locking is needed.
+ */
 class Logger {
   public:
     Logger(const Logger&) = delete;
@@ -62,6 +131,15 @@ class Logger {
       myWebLogLevel = aSeverity;
     }
 
+    /**
+     * the formats of logEvent(), aFormats[i] is the PROGMEM format of id i, each "%d" is replaced
+     * by the next integer argument, each "%s" by the next argument as string literal
+     */
+    void setFormats(const char* const* aFormats, uint8_t aCount) {
+      myFormats = aFormats;
+      myFormatCount = aCount;
+    }
+
     void setup(const char* aName) {
       myApplication = aName;
       mySeverity=INFO;
@@ -89,65 +167,219 @@ class Logger {
       myDoSerialLogging = aArg;
     }
 
-    void log(LogSeverity aSeverity, String aMessage) {
+    /**
+     * true, if a message of aModule and aSeverity is printed or shown by the web log
+     */
+    bool isLogged(byte aModule, LogSeverity aSeverity) {
+      return isWebLogged(aModule, aSeverity) || isSerialLogged(aModule, aSeverity);
+    }
+
+    void log(LogSeverity aSeverity, const String& aMessage) {
       log(LOG_MOD_ALL, aSeverity, aMessage);
-    } 
-    
-    void log(byte aModule, LogSeverity aSeverity, String aMessage) {
-      if (aModule == LOG_MOD_WEB || aSeverity >= myWebLogLevel ) {
-      myWebLogLevel = aSeverity;
-        // b[9] = b[8];
-        // b[8] = b[7];
-        // ...
-        // b[1] = b[0];
-        for (int i=LOGBUFFSIZE-1 ; i>0; i--) {
-          myInternalLogBuffer[i] = myInternalLogBuffer[i-1];
-        }
-        char t[25];
-        snprintf (t, 25, "%08d: ", millis());
-        String buf;
-        buf.concat(t);
-        buf.concat(aMessage);
-        myInternalLogBuffer[0] = buf;
+    }
+
+    void log(byte aModule, LogSeverity aSeverity, const String& aMessage) {
+#if LOG_TEXT_LEN > 0
+      LogRecord record;
+      if (init(&record, aModule, aSeverity, LOG_FMT_TEXT)) {
+        strncpy(record.text, aMessage.c_str(), LOG_TEXT_LEN - 1);
+        record.text[LOG_TEXT_LEN - 1] = '\0';
+        add(&record);
       }
-      if (!myDoSerialLogging) return;
-    
-    //   if (aSeverity >= mySeverity) {
-      if (aSeverity >= myLogSevArray[aModule]) {
-        log_printSecond();
-        Serial.print(myApplication);
-        Serial.print(':');
-        Serial.print(aSeverity);
-        Serial.print(':');
+#else
+      if (isSerialLogged(aModule, aSeverity)) {
+        printHead(millis(), aSeverity);
         Serial.print(aMessage);
         Serial.println();
       }
+#endif
     }
 
-    // void log(byte aModule, LogSeverity aSeverity, String aMessage) {
-    //   // if (aModule & myModules) {
-    //   if (aSeverity >= myLogSevArray[aModule])
-    //     log_(aSeverity, aMessage);
-    //   }
-    // }
+    /**
+     * record a message of format aFormat (see setFormats()) with its arguments
+     */
+    void event(byte aModule, LogSeverity aSeverity, uint8_t aFormat, LogArg aArg0=LogArg(), LogArg aArg1=LogArg(), LogArg aArg2=LogArg()) {
+      LogRecord record;
+      if (init(&record, aModule, aSeverity, aFormat)) {
+        record.args[0] = aArg0;
+        record.args[1] = aArg1;
+        record.args[2] = aArg2;
+        add(&record);
+      }
+    }
+
+    /**
+     * print at most aMax of the pending records to Serial, returns the number of printed records
+     */
+    uint8_t flush(uint8_t aMax=LOG_FLUSH_MAX) {
+      uint8_t cnt = 0;
+      while (myUnprinted > 0 && cnt < aMax) {
+        uint8_t idx = (myHead + LOG_RING_SIZE - myUnprinted) % LOG_RING_SIZE;
+        myUnprinted--;
+        printRecord(&myRecords[idx]);
+        cnt++;
+      }
+      return cnt;
+    }
 
+    /**
+     * the aIdx-th newest message of the web log, formatted
+     */
     String getInternalMsg(uint8_t aIdx) {
-      return myInternalLogBuffer[aIdx];
+      String msg;
+#if LOG_WEB_RING_SIZE > 0
+      if (aIdx < myWebCount) {
+        const LogRecord* record = &myWebRecords[(myWebHead + LOG_WEB_RING_SIZE - 1 - aIdx) % LOG_WEB_RING_SIZE];
+        LogStringPrint out(&msg);
+        printTime(&out, record->time);
+        printMessage(&out, record);
+      }
+#endif
+      return msg;
     }
   private:
     Logger() {
       mySeverity=DEBUG;
       myDoSerialLogging=true;
+      myWebLogLevel=WARNING;
+      myApplication="";
+      myFormats=nullptr;
+      myFormatCount=0;
+      myHead=0;
+      myUnprinted=0;
+#if LOG_WEB_RING_SIZE > 0
+      myWebHead=0;
+      myWebCount=0;
+#endif
     }
     ~Logger() = default;
 
-    void log_printSecond() {
-      if (!myDoSerialLogging) return;
-    
-      char buf[25];
-      unsigned long now = millis();
-      snprintf (buf, 25, "%08lu: ", now);
-      Serial.print(buf);
+    typedef struct {
+      uint32_t time;      // millis()
+      uint8_t module;
+      uint8_t severity;
+      uint8_t format;     // id of the format or LOG_FMT_TEXT
+      LogArg args[LOG_ARGS_MAX];
+#if LOG_TEXT_LEN > 0
+      char text[LOG_TEXT_LEN];
+#endif
+    } LogRecord;
+
+    // builds the web log messages by the formatting of Serial
+    class LogStringPrint : public Print {
+      public:
+        LogStringPrint(String* aString) {
+          myString = aString;
+        }
+        size_t write(uint8_t aChar) override {
+          myString->concat((char) aChar);
+          return 1;
+        }
+      private:
+        String* myString;
+    };
+
+    bool isWebLogged(byte aModule, LogSeverity aSeverity) {
+      return aModule == LOG_MOD_WEB || aSeverity >= myWebLogLevel;
+    }
+
+    bool isSerialLogged(byte aModule, LogSeverity aSeverity) {
+      return myDoSerialLogging && aSeverity >= myLogSevArray[aModule];
+    }
+
+    /**
+     * the head of aRecord, returns false, if the message is not logged
+     */
+    bool init(LogRecord* aRecord, byte aModule, LogSeverity aSeverity, uint8_t aFormat) {
+      if (!isLogged(aModule, aSeverity)) {
+        return false;
+      }
+      aRecord->time = millis();
+      aRecord->module = aModule;
+      aRecord->severity = aSeverity;
+      aRecord->format = aFormat;
+      return true;
+    }
+
+    /**
+     * copy aRecord into the ring of Serial and of the web log, if it is logged there. The oldest
+     * record of Serial is overwritten, after it is printed, the oldest one of the web log at once.
+     */
+    void add(const LogRecord* aRecord) {
+      if (isSerialLogged(aRecord->module, (LogSeverity) aRecord->severity)) {
+        if (myUnprinted == LOG_RING_SIZE) {
+          flush(1);
+        }
+        myRecords[myHead] = *aRecord;
+        myHead = (myHead + 1) % LOG_RING_SIZE;
+        myUnprinted++;
+      }
+#if LOG_WEB_RING_SIZE > 0
+      if (isWebLogged(aRecord->module, (LogSeverity) aRecord->severity)) {
+        myWebRecords[myWebHead] = *aRecord;
+        myWebHead = (myWebHead + 1) % LOG_WEB_RING_SIZE;
+        if (myWebCount < LOG_WEB_RING_SIZE) {
+          myWebCount++;
+        }
+      }
+#endif
+    }
+
+    void printRecord(const LogRecord* aRecord) {
+      printHead(aRecord->time, aRecord->severity);
+      printMessage(&Serial, aRecord);
+      Serial.println();
+    }
+
+    void printHead(uint32_t aTime, uint8_t aSeverity) {
+      printTime(&Serial, aTime);
+      Serial.print(myApplication);
+      Serial.print(':');
+      Serial.print((int) aSeverity);
+      Serial.print(':');
+    }
+
+    // the time stamp as "%08lu: "
+    static void printTime(Print* aOut, uint32_t aTime) {
+      for (uint32_t div=10000000; div>1 && aTime<div; div/=10) {
+        aOut->print('0');
+      }
+      aOut->print(aTime);
+      aOut->print(F(": "));
+    }
+
+    void printMessage(Print* aOut, const LogRecord* aRecord) {
+#if LOG_TEXT_LEN > 0
+      if (aRecord->format == LOG_FMT_TEXT) {
+        aOut->print(aRecord->text);
+        return;
+      }
+#endif
+      if (aRecord->format >= myFormatCount) {
+        aOut->print(F("unknown log format: "));
+        aOut->print((int) aRecord->format);
+        return;
+      }
+      const char* fmt = myFormats[aRecord->format];
+      uint8_t arg = 0;
+      for (char c = pgm_read_byte(fmt); c != '\0'; c = pgm_read_byte(++fmt)) {
+        if (c != '%' || arg == LOG_ARGS_MAX) {
+          aOut->print(c);
+          continue;
+        }
+        c = pgm_read_byte(++fmt);
+        if (c == 's') {
+          aOut->print(aRecord->args[arg++].getStr());
+        } else if (c == 'd') {
+          aOut->print((long) aRecord->args[arg++].getNum());
+        } else {
+          aOut->print('%');
+          if (c == '\0') {
+            break;
+          }
+          aOut->print(c);
+        }
+      }
     }
 
     int myLogSevArray[NUM_MOD_LOG];
@@ -155,15 +387,39 @@ class Logger {
     LogSeverity mySeverity;
     const char* myApplication;
     bool myDoSerialLogging;
-    String myInternalLogBuffer[LOGBUFFSIZE];
+    const char* const* myFormats;
+    uint8_t myFormatCount;
+    LogRecord myRecords[LOG_RING_SIZE];
+    uint8_t myHead;      // next record to write
+    uint8_t myUnprinted; // newest records, which are not yet printed
+#if LOG_WEB_RING_SIZE > 0
+    LogRecord myWebRecords[LOG_WEB_RING_SIZE];
+    uint8_t myWebHead;   // next record of the web log to write
+    uint8_t myWebCount;  // used records of the web log
+#endif
 };
 
+#define LOG_ENABLED(aModule, aSeverity) \
+  ((aSeverity) >= LOG_MIN_SEVERITY && Logger::getInstance().isLogged(aModule, aSeverity))
+#define LOG_MSG2(aSeverity, aMessage) LOG_MSG3(LOG_MOD_ALL, aSeverity, aMessage)
+#define LOG_MSG3(aModule, aSeverity, aMessage) \
+  do { if (LOG_ENABLED(aModule, aSeverity)) Logger::getInstance().log(aModule, aSeverity, aMessage); } while (0)
+#define LOG_SELECT(a1, a2, a3, aName, ...) aName
+
+/**
+ * logMsg([aModule,] aSeverity, aMessage), aMessage is only built, if it is logged
+ */
+#define logMsg(...) LOG_SELECT(__VA_ARGS__, LOG_MSG3, LOG_MSG2, )(__VA_ARGS__)
+/**
+ * logEvent(aModule, aSeverity, aFormat, up to LOG_ARGS_MAX integer or string literal arguments)
+ */
+#define logEvent(aModule, aSeverity, ...) \
+  do { if (LOG_ENABLED(aModule, aSeverity)) Logger::getInstance().event(aModule, aSeverity, __VA_ARGS__); } while (0)
+
 #define LOGGY(a, b) logMsg(a, b)
-// #define LOGGY(a, b) 
+// #define LOGGY(a, b)
 #define LOGGY2(a, b) logMsg(a, b)
 #define LOGGY3(a, b, c) logMsg(a, b, c)
-// #define LOGGY2(a, b) 
-#define logMsg Logger::getInstance().log
+// #define LOGGY2(a, b)
 
 #endif
-
@@ -9,6 +9,10 @@
 RFTransceiver::RFTransceiver(const char* aName, uint8_t aCEPin, uint8_t aCSNPin) {
   strncpy(myName, aName, 7);
   myRadio = new RF24(aCEPin, aCSNPin); // (CE, CSN)
+  myRecvLen = 0;
+  memset(myPipeStats, 0, sizeof(myPipeStats));
+  myWritingPipe = 0;
+  myIsTransmitting = false;
 }
 
 
@@ -67,7 +71,7 @@ void RFTransceiver::setDefaults() {
 void RFTransceiver::begin(F3XDeviceType aDeviceType) {
 
   if (!myRadio->begin()) {
-    Logger::getInstance().log(LOG_MOD_RADIO, INFO, F("radio hardware not responding!"));
+    logMsg(LOG_MOD_RADIO, INFO, F("radio hardware not responding!"));
     delay(100);
     while (1) {} // hold program in infinite loop to prevent subsequent errors
   }
@@ -79,7 +83,7 @@ void RFTransceiver::begin(F3XDeviceType aDeviceType) {
   } else {
     printout += F(": NOT connected!");
   }
-  Logger::getInstance().log(LOG_MOD_RADIO, INFO, printout);
+  logMsg(LOG_MOD_RADIO, INFO, printout);
 
   setDefaults();
 
@@ -90,7 +94,7 @@ void RFTransceiver::begin(F3XDeviceType aDeviceType) {
   memcpy(&myAddress[0][0], &rf24addr[0][0], 6);  // better 1abcd : BaseManager  <-> ALineController 
   memcpy(&myAddress[1][0], &rf24addr[1][0], 6);  // better 2efgh : BaseManager  <-> BLineController
   memcpy(&myAddress[2][0], &rf24addr[2][0], 6);  // better 3efgh : BaseManager  <-> RemoteBuzzer
-  memcpy(&myAddress[3][0], &rf24addr[3][0], 6);  // better 3efgh : BaseManager  <-> RemoteBuzzer
+  memcpy(&myAddress[3][0], &rf24addr[3][0], 6);  // better 4efgh : BaseManager  <-> BLineController of the second course
 
 	myRadio->setAddressWidth(5);
   switch (aDeviceType) {
@@ -98,10 +102,11 @@ void RFTransceiver::begin(F3XDeviceType aDeviceType) {
       myRadio->openReadingPipe(0, &myAddress[0][0]); // set the address
       myRadio->openReadingPipe(1, &myAddress[1][0]); // set the address
       myRadio->openReadingPipe(2, &myAddress[2][0]); // set the address
+      myRadio->openReadingPipe(3, &myAddress[3][0]); // set the address
       myRadio->openWritingPipe(&myAddress[0][0]);
       break;
     case F3XALineController:
-      Logger::getInstance().log(LOG_MOD_RADIO, ERROR, F("F3XALineController not yet implemented"));
+      logMsg(LOG_MOD_RADIO, ERROR, F("F3XALineController not yet implemented"));
       myRadio->openReadingPipe(0, &myAddress[1][0]); // set the address
       myRadio->openWritingPipe(&myAddress[1][0]);
       break;
@@ -114,6 +119,10 @@ void RFTransceiver::begin(F3XDeviceType aDeviceType) {
       myRadio->openReadingPipe(0, &myAddress[2][0]); // set the address
       myRadio->openWritingPipe(&myAddress[2][0]);
       break;
+    case F3XBLineController2:
+      myRadio->openReadingPipe(0, &myAddress[3][0]); // set the address
+      myRadio->openWritingPipe(&myAddress[3][0]);
+      break;
   }
   myRadio->startListening(); // set as receiver
 }
@@ -164,7 +173,7 @@ void RFTransceiver::begin(F3XDeviceType aDeviceType) {
 //   }
 // 
 //   if (!myRadio->begin()) {
-//     Logger::getInstance().log(INFO, F("radio hardware not responding!"));
+//     logMsg(INFO, F("radio hardware not responding!"));
 //     delay(100);
 //     while (1) {} // hold program in infinite loop to prevent subsequent errors
 //   }
@@ -176,7 +185,7 @@ void RFTransceiver::begin(F3XDeviceType aDeviceType) {
 //   } else {
 //     printout += F(": NOT connected!");
 //   }
-//   Logger::getInstance().log(INFO, printout);
+//   logMsg(INFO, printout);
 // 
 //   setDefaults();
 // 
@@ -200,26 +209,22 @@ void RFTransceiver::begin(F3XDeviceType aDeviceType) {
 // }
 
 void RFTransceiver::setWritingPipe(uint8_t aPipeNumber) {
+  myWritingPipe = aPipeNumber;
   myRadio->stopListening();
   myRadio->openWritingPipe(&myAddress[aPipeNumber][0]);
   myRadio->startListening(); // set as receiver
 }
 
-uint8_t  RFTransceiver::getSignalStrength() {
-
-  myRadio->setRetries(0,0); // by default nrf tries 15 times. Change to no retries to measure strength
-  char buffer[10];
-  int counter = 0;
+uint8_t RFTransceiver::getWritingPipe() {
+  return myWritingPipe;
+}
 
-  for(int i=0; i<101; i++) {
-    int status = myRadio->write(buffer,10); // send 32 bytes of data. It does not matter what it is
-    if(status) {
-       counter++;
-    }
-   delay(1); // try again in 1 millisecond
-  }
-  myRadio->setRetries(DELAY_RETRIES,NUM_RETRIES);
-  return counter;
+/**
+ * the IRQ pin of the nRF24L01 is only activated by received data (RX_DR),
+ * the TX_DS and MAX_RT interrupts are masked
+ */
+void RFTransceiver::setRxIrqOnly() {
+  myRadio->maskIRQ(true, true, false);
 }
 
 boolean RFTransceiver::getAck() {
@@ -253,6 +258,27 @@ void RFTransceiver::setChannel(uint8_t aChannel) {
 }
 
 
+/**
+ * listen shortly on aChannel, returns true, if the received power detector (RPD)
+ * signals a carrier > -64dBm. The radio stays in standby, see restoreChannel()
+ */
+boolean RFTransceiver::testChannel(uint8_t aChannel) {
+  myRadio->setChannel(aChannel);
+  myRadio->startListening();
+  delayMicroseconds(200); // 130us settling time of the receiver + min. 40us for the RPD
+  myRadio->stopListening();
+  return myRadio->testRPD();
+}
+
+/**
+ * switch back to the working channel after testChannel() and continue to receive
+ */
+void RFTransceiver::restoreChannel(uint8_t aChannel) {
+  myRadio->setChannel(aChannel);
+  myRadio->flush_rx();
+  myRadio->startListening();
+}
+
 uint8_t RFTransceiver::getPower() {
   return myRadio->getPALevel();
 }
@@ -280,8 +306,21 @@ void RFTransceiver::setPower(uint8_t aPower) {
 }
 
 boolean RFTransceiver::transmit(String aData, uint8_t aRetrans) {
-  byte len = aData.length();
-  memcpy(mySendBuffer, aData.c_str(), sizeof(char) * len+1);
+  return transmit((const uint8_t*) aData.c_str(), aData.length(), aRetrans);
+}
+
+boolean RFTransceiver::transmit(const F3XRemoteFrame* aFrame, uint8_t aRetrans) {
+  return transmit((const uint8_t*) aFrame, sizeof(F3XRemoteFrame), aRetrans);
+}
+
+boolean RFTransceiver::transmit(const uint8_t* aData, uint8_t aLen, uint8_t aRetrans) {
+  if (myIsTransmitting) {
+    logMsg(LOG_MOD_RADIO, ERROR, F("RFTransceiver::transmit : asynchronous transmission in progress"));
+    return false;
+  }
+  byte len = aLen < 32 ? aLen : 32;
+  memcpy(mySendBuffer, aData, len);
+  mySendBuffer[len] = 0;
   myRadio->stopListening();
   unsigned long start = millis();
   // aRetrans=0;
@@ -303,12 +342,57 @@ boolean RFTransceiver::transmit(String aData, uint8_t aRetrans) {
     yield();
   }
   if ( (millis() - start) > 10) {
-    Logger::getInstance().log(LOG_MOD_RADIO, INFO, String("RFTransceiver::transmit :") + String(writeRet) + F("in ") + String(millis() - start) + F("ms"));
+    logMsg(LOG_MOD_RADIO, INFO, String("RFTransceiver::transmit :") + String(writeRet) + F("in ") + String(millis() - start) + F("ms"));
   }
   myRadio->startListening();
   return writeRet;
 }
 
+/**
+ * start an asynchronous transmission (including the auto retransmissions of the nRF24L01),
+ * the result has to be polled by pollTransmit()
+ */
+void RFTransceiver::startTransmit(const uint8_t* aData, uint8_t aLen) {
+  byte len = aLen < 32 ? aLen : 32;
+  memcpy(mySendBuffer, aData, len);
+  myRadio->stopListening();
+  bool txOk, txFail, rxReady;
+  myRadio->whatHappened(txOk, txFail, rxReady); // clear old TX_DS / MAX_RT flags
+  myRadio->startWrite(mySendBuffer, len, false);
+  myTransmitStart = micros();
+  myIsTransmitting = true;
+}
+
+/**
+ * poll the state of an asynchronous transmission, 
+ * returns 0 while pending, 1 if acknowledged, -1 if failed (all retries done or timeout).
+ * If finished, the radio is switched back to receive and getRetransmissionCount() is valid.
+ */
+int8_t RFTransceiver::pollTransmit() {
+  if (!myIsTransmitting) {
+    return -1;
+  }
+  bool txOk = false, txFail = false, rxReady = false;
+  myRadio->whatHappened(txOk, txFail, rxReady);
+  if (!txOk && !txFail) {
+    if ((micros() - myTransmitStart) < RF24_TX_TIMEOUT_US) {
+      return 0;
+    }
+    txFail = true;
+  }
+  myRetransmitCnt = myRadio->getARC();
+  if (!txOk) {
+    myRadio->flush_tx();
+  }
+  myIsTransmitting = false;
+  myRadio->startListening();
+  return txOk ? 1 : -1;
+}
+
+boolean RFTransceiver::isTransmitting() {
+  return myIsTransmitting;
+}
+
 boolean RFTransceiver::available() {
   boolean retVal=false;
   uint8_t pipe;
@@ -319,18 +403,62 @@ boolean RFTransceiver::available() {
   return retVal;
 }
 
+/**
+ * read the next payload together with its reading pipe and reception time,
+ * returns false, if no payload is available
+ */
+boolean RFTransceiver::receive(RxPacket* aPacket) {
+  uint8_t pipe;
+  if (!myRadio->available(&pipe)) {
+    return false;
+  }
+  aPacket->timestampUs = micros();
+  aPacket->data = read();
+  aPacket->len = myRecvLen;
+  aPacket->pipe = pipe;
+
+  if (pipe < RF24_STATS_PIPES) {
+    PipeStats* stats = &myPipeStats[pipe];
+    if (stats->packets > 0) {
+      uint32_t interval = aPacket->timestampUs - stats->lastUs;
+      if (stats->packets > 1) {
+        float d = (float) interval - (float) stats->lastInterval;
+        stats->jitter += ((d < 0 ? -d : d) - stats->jitter) / 16.0f;
+      }
+      stats->lastInterval = interval;
+    }
+    stats->lastUs = aPacket->timestampUs;
+    stats->packets++;
+    stats->bytes += myRecvLen;
+  }
+  return true;
+}
+
+RFTransceiver::PipeStats* RFTransceiver::getPipeStats(uint8_t aPipe) {
+  return aPipe < RF24_STATS_PIPES ? &myPipeStats[aPipe] : nullptr;
+}
+
+uint8_t RFTransceiver::getReadLength() {
+  return myRecvLen;
+}
+
 uint8_t RFTransceiver::getRetransmissionCount() {
   return myRetransmitCnt;
 }
 
+/**
+ * read the next payload, binary payloads may contain 0 bytes, so use getReadLength()
+ */
 char* RFTransceiver::read() {
   byte len = myRadio->getDynamicPayloadSize();
   if (len < 33) {
   myRadio->read(myRecvBuffer, len);
   myRecvBuffer[len] = 0;
+  myRecvLen = len;
   } else {
-    Logger::getInstance().log(ERROR, "RFTransceiver cannot read large payload");
+    logMsg(ERROR, "RFTransceiver cannot read large payload");
     myRecvBuffer[0] = 0;
+    myRecvLen = 0;
   }
   // #ifdef USE_RXTX_AS_GPIO
   // Serial.print(myName);
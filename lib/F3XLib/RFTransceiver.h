@@ -2,8 +2,11 @@
 #define RFTransceiver_h
 
 #include <RF24.h>
+#include "F3XRemoteCommand.h"
 
 #define RF24_1MHZ_CHANNEL_NUM 126  // channels 0 - 125 MHz
+#define RF24_TX_TIMEOUT_US  60000  // an asynchronous transmission (15 retries) is finished before
+#define RF24_STATS_PIPES        4  // reading pipes with receive statistics
 
 class RFTransceiver
 {
@@ -13,36 +16,68 @@ public:
     F3XALineController,
     F3XBLineController,
     F3XRemoteBuzzer,
+    F3XBLineController2,  // B-Line of the second course
   } F3XDeviceType;
 
+  typedef struct {
+    uint8_t pipe;          // reading pipe the payload was received on
+    uint8_t len;
+    uint32_t timestampUs;  // micros() of the reception
+    char* data;            // valid until the next read
+  } RxPacket;
+
+  typedef struct {
+    uint32_t packets;
+    uint32_t bytes;
+    uint32_t lastUs;       // micros() of the last packet
+    uint32_t lastInterval; // us
+    float jitter;          // mean deviation of the inter arrival time (RFC 3550) in us
+  } PipeStats;
+
   RFTransceiver(const char*, uint8_t, uint8_t);
   // void begin(uint8_t aNodeNum);
   void begin(F3XDeviceType aType);
   void setWritingPipe(uint8_t aPipeNumber);
+  uint8_t getWritingPipe();
   void setAck(boolean);
   boolean getAck();
   void setDataRate(uint8_t);
   uint8_t getDataRate();
   void setChannel(uint8_t);
   uint8_t getChannel();
+  boolean testChannel(uint8_t aChannel);
+  void restoreChannel(uint8_t aChannel);
   void setPower(uint8_t);
   uint8_t getPower();
   String getPowerStr();
   void setDefaults(); // all settings to default
+  void setRxIrqOnly(); // IRQ pin signals received data only
   boolean transmit(String, uint8_t aRetrans=0);
+  boolean transmit(const uint8_t* aData, uint8_t aLen, uint8_t aRetrans=0);
+  boolean transmit(const F3XRemoteFrame* aFrame, uint8_t aRetrans=0);
+  void startTransmit(const uint8_t* aData, uint8_t aLen);
+  int8_t pollTransmit();
+  boolean isTransmitting();
   boolean available(void);
   // boolean write(const char*);
   char* read();
+  boolean receive(RxPacket* aPacket);
+  PipeStats* getPipeStats(uint8_t aPipe);
+  uint8_t getReadLength();
   uint8_t getRetransmissionCount();
-  uint8_t  getSignalStrength();
 protected:
   RF24 *myRadio;
   byte myAddress[5][6];
   char mySendBuffer[33];
   char myRecvBuffer[33];
+  uint8_t myRecvLen;
+  PipeStats myPipeStats[RF24_STATS_PIPES];
   char myName[7];
   boolean myAck;
   int8_t myRetransmitCnt;
+  uint8_t myWritingPipe;
+  boolean myIsTransmitting;
+  uint32_t myTransmitStart;
   String myStrBuffer;
 };
 
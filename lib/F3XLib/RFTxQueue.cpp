@@ -0,0 +1,194 @@
+#include <Arduino.h>
+#include "Logger.h"
+#include "RFTxQueue.h"
+
+RFTxQueue::RFTxQueue(RFTransceiver* aRadio) {
+  myRadio = aRadio;
+  myActive = nullptr;
+  myOrder = 0;
+  myActiveStartMs = 0;
+  for (uint8_t i=0; i<RF_TXQ_SIZE; i++) {
+    myEntries[i].used = false;
+  }
+  for (uint8_t i=0; i<PrioNum; i++) {
+    myStats[i].sent = 0;
+    myStats[i].failed = 0;
+    myStats[i].retransCnt = 0;
+    myStats[i].dropped = 0;
+  }
+}
+
+/**
+ * queue a copy of aFrame for the writing pipe aPipe, aRetrans is the retransmission budget
+ * (like RFTransceiver::transmit()), at least one attempt is done.
+ * If the queue is full, a queued entry of lower priority is dropped, otherwise false is returned.
+ */
+boolean RFTxQueue::send(const F3XRemoteFrame* aFrame, uint8_t aPipe, Priority aPrio, uint8_t aRetrans, Callback aCallback) {
+  Entry* entry = nullptr;
+  Entry* victim = nullptr;
+  for (uint8_t i=0; i<RF_TXQ_SIZE; i++) {
+    Entry* e = &myEntries[i];
+    if (!e->used) {
+      entry = e;
+      break;
+    }
+    if (e != myActive && e->prio > aPrio && (victim == nullptr || e->prio > victim->prio
+        || (e->prio == victim->prio && (int16_t) (e->order - victim->order) > 0))) {
+      victim = e;
+    }
+  }
+  if (entry == nullptr) {
+    if (victim == nullptr) {
+      myStats[aPrio].dropped++;
+      logMsg(LOG_MOD_RADIO, ERROR, String(F("RFTxQueue full, frame dropped, type: ")) + String(aFrame->type));
+      return false;
+    }
+    logMsg(LOG_MOD_RADIO, WARNING, String(F("RFTxQueue full, preempted frame dropped, type: ")) + String(victim->frame.type));
+    myStats[victim->prio].dropped++;
+    finish(victim, false, true);
+    // the callback of the dropped entry might have queued a new frame already
+    for (uint8_t i=0; i<RF_TXQ_SIZE && entry == nullptr; i++) {
+      if (!myEntries[i].used) {
+        entry = &myEntries[i];
+      }
+    }
+    if (entry == nullptr) {
+      myStats[aPrio].dropped++;
+      return false;
+    }
+  }
+  memcpy(&entry->frame, aFrame, sizeof(F3XRemoteFrame));
+  entry->used = true;
+  entry->order = myOrder++;
+  entry->pipe = aPipe;
+  entry->prio = aPrio;
+  entry->retransBudget = aRetrans;
+  entry->retransCnt = 0;
+  entry->queuedUs = micros();
+  entry->callback = aCallback;
+  return true;
+}
+
+RFTxQueue::Entry* RFTxQueue::selectNext() {
+  Entry* next = nullptr;
+  for (uint8_t i=0; i<RF_TXQ_SIZE; i++) {
+    Entry* e = &myEntries[i];
+    if (e->used && (next == nullptr || e->prio < next->prio
+        || (e->prio == next->prio && (int16_t) (e->order - next->order) < 0))) {
+      next = e;
+    }
+  }
+  return next;
+}
+
+/**
+ * release aEntry and call its callback, a dropped entry is neither counted as failed nor part of
+ * the latency
+ */
+void RFTxQueue::finish(Entry* aEntry, boolean aSuccess, boolean aDropped) {
+  Result result;
+  result.type = (F3XRemoteCommandType) aEntry->frame.type;
+  result.seq = aEntry->frame.seq;
+  result.pipe = aEntry->pipe;
+  result.prio = aEntry->prio;
+  result.success = aSuccess;
+  result.dropped = aDropped;
+  result.retransCnt = aEntry->retransCnt;
+  result.latencyUs = micros() - aEntry->queuedUs;
+  result.txStartMs = myActiveStartMs;
+  aEntry->used = false;
+
+  Stats* stats = &myStats[aEntry->prio];
+  stats->retransCnt += aEntry->retransCnt;
+  if (!aDropped) {
+    if (aSuccess) {
+      stats->sent++;
+    } else {
+      stats->failed++;
+    }
+    stats->latency.record(result.latencyUs);
+  }
+
+  if (aEntry->callback != nullptr) {
+    aEntry->callback(&result);
+  }
+}
+
+/**
+ * state machine of the queue, has to be called frequently from the loop
+ */
+void RFTxQueue::update() {
+  if (myActive != nullptr) {
+    int8_t state = myRadio->pollTransmit();
+    if (state == 0) {
+      return;
+    }
+    Entry* entry = myActive;
+    myActive = nullptr;
+    uint8_t retrans = myRadio->getRetransmissionCount();
+    if (state < 0 && retrans == 0) {
+      retrans = 1; // e.g. timeout, ensure the budget is consumed
+    }
+    entry->retransCnt = entry->retransCnt + retrans > UINT8_MAX ? UINT8_MAX : entry->retransCnt + retrans;
+    if (entry->pipe < RF24_STATS_PIPES) {
+      myLinkQuality[entry->pipe].record(state > 0, myRadio->getRetransmissionCount(), micros() - entry->queuedUs);
+    }
+    if (state > 0 || entry->retransCnt >= entry->retransBudget) {
+      finish(entry, state > 0);
+    }
+    // radio is listening again, the next attempt is started with the next update
+    return;
+  }
+
+  Entry* next = selectNext();
+  if (next == nullptr) {
+    return;
+  }
+  if (next->pipe != myRadio->getWritingPipe()) {
+    myRadio->setWritingPipe(next->pipe);
+  }
+  myActive = next;
+  myActiveStartMs = millis();
+  myRadio->startTransmit((const uint8_t*) &next->frame, sizeof(F3XRemoteFrame));
+}
+
+/**
+ * transmit all queued frames synchronously, e.g. before a restart, when the loop does not call
+ * update() anymore. Returns false, if frames are still queued after aTimeoutMs.
+ */
+boolean RFTxQueue::flush(uint16_t aTimeoutMs) {
+  unsigned long start = millis();
+  while (!isIdle()) {
+    if (millis() - start >= aTimeoutMs) {
+      return false;
+    }
+    update();
+    delay(1); // feeds the watchdog of the ESP8266
+  }
+  return true;
+}
+
+boolean RFTxQueue::isIdle() {
+  return myActive == nullptr && selectNext() == nullptr;
+}
+
+uint8_t RFTxQueue::getQueued() {
+  uint8_t cnt = 0;
+  for (uint8_t i=0; i<RF_TXQ_SIZE; i++) {
+    if (myEntries[i].used) {
+      cnt++;
+    }
+  }
+  return cnt;
+}
+
+RFTxQueue::Stats* RFTxQueue::getStats(Priority aPrio) {
+  return &myStats[aPrio];
+}
+
+/**
+ * link quality of the peer of the writing pipe aPipe, nullptr for an invalid pipe
+ */
+F3XLinkQuality* RFTxQueue::getLinkQuality(uint8_t aPipe) {
+  return aPipe < RF24_STATS_PIPES ? &myLinkQuality[aPipe] : nullptr;
+}
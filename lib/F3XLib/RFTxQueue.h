@@ -0,0 +1,84 @@
+#ifndef RFTxQueue_h
+#define RFTxQueue_h
+
+#include <Arduino.h>
+#include "RFTransceiver.h"
+#include "F3XRemoteCommand.h"
+#include "LatencyHistogram.h"
+#include "F3XLinkQuality.h"
+
+#define RF_TXQ_SIZE 6
+
+/**
+ * asynchronous prioritized transmit queue for F3XRemoteFrame, driven by update() from the loop.
+ * Only one transmission attempt (incl. the auto retransmissions of the nRF24L01) is active at a
+ * time. Between two attempts the radio is listening again and the entry with the highest priority
+ * is selected next, so signals preempt housekeeping traffic at attempt granularity.
+ * Each attempt is a sample of the link quality of the peer of its writing pipe.
+ */
+class RFTxQueue {
+  public:
+    typedef enum Priority {
+      PrioSignal = 0,    // signals and buzzer commands
+      PrioCommand,       // radio settings, restart
+      PrioHousekeeping,  // state requests, round trip measurements
+      PrioNum,
+    } Priority;
+
+    typedef struct {
+      F3XRemoteCommandType type;
+      uint8_t seq;
+      uint8_t pipe;
+      Priority prio;
+      boolean success;
+      boolean dropped;         // preempted by a frame of higher priority before it was sent
+      uint8_t retransCnt;      // sum of retransmissions of all attempts
+      uint32_t latencyUs;      // queued -> finished
+      unsigned long txStartMs; // millis() of the start of the last attempt
+    } Result;
+
+    typedef void (*Callback)(const Result* aResult);
+
+    typedef struct {
+      uint32_t sent;
+      uint32_t failed;
+      uint32_t retransCnt;
+      uint16_t dropped;        // queue full or preempted
+      LatencyHistogram latency; // of the sent and failed frames
+    } Stats;
+
+    RFTxQueue(RFTransceiver* aRadio);
+    boolean send(const F3XRemoteFrame* aFrame, uint8_t aPipe, Priority aPrio, uint8_t aRetrans, Callback aCallback=nullptr);
+    void update();
+    boolean flush(uint16_t aTimeoutMs);
+    boolean isIdle();
+    uint8_t getQueued();
+    Stats* getStats(Priority aPrio);
+    F3XLinkQuality* getLinkQuality(uint8_t aPipe);
+
+  private:
+    typedef struct {
+      boolean used;
+      uint16_t order;
+      F3XRemoteFrame frame;
+      uint8_t pipe;
+      Priority prio;
+      uint8_t retransBudget;
+      uint8_t retransCnt;
+      uint32_t queuedUs;
+      Callback callback;
+    } Entry;
+
+    void finish(Entry* aEntry, boolean aSuccess, boolean aDropped=false);
+    Entry* selectNext();
+
+    RFTransceiver* myRadio;
+    Entry myEntries[RF_TXQ_SIZE];
+    Entry* myActive;
+    uint16_t myOrder;
+    unsigned long myActiveStartMs;
+    Stats myStats[PrioNum];
+    F3XLinkQuality myLinkQuality[RF24_STATS_PIPES];
+};
+
+#endif
@@ -0,0 +1,143 @@
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "F3XSimTest.h"
+
+/**
+ * latency of the B-Line signal path: press at the LineController -> SignalB transmitted ->
+ * updateRadio() of the BaseManager -> task signalled -> RemoteSignalBuzz -> buzzer on at the
+ * RemoteBuzzer. F3B speed runs are flown on the simulated setup, the radio loses each packet and
+ * acknowledgement with the given probability.
+ *
+ *   F3XSignalPipelineBench [presses=100] [loss=0.0] [retransmit delay us=0: ARD of the radios]
+ */
+#define LEG_US 3000000
+
+typedef struct {
+  const char* name;
+  std::vector<double> values;   // ms
+} Stage;
+
+static void printStage(Stage& aStage) {
+  std::vector<double>& v = aStage.values;
+  if (v.empty()) {
+    printf("%-22s      -\n", aStage.name);
+    return;
+  }
+  std::sort(v.begin(), v.end());
+  double p50 = v[(v.size() - 1) * 50 / 100];
+  double p99 = v[(v.size() - 1) * 99 / 100];
+  printf("%-22s %8.2f %8.2f %8.2f\n", aStage.name, p50, p99, v.back());
+}
+
+static uint16_t countPulses(F3XSimDevice& aDevice, uint8_t aPin) {
+  uint16_t count = 0;
+  for (const F3XSimDevice::Edge& edge : aDevice.getEdges(aPin)) {
+    count += edge.level == HIGH;
+  }
+  return count;
+}
+
+int main(int argc, char** argv) {
+  uint32_t presses = argc > 1 ? atoi(argv[1]) : 100;
+  double loss = argc > 2 ? atof(argv[2]) : 0.0;
+  uint32_t retryDelayUs = argc > 3 ? atoi(argv[3]) : 0;
+
+  F3XSimCompetition sim;
+  F3XSimAir& air = F3XSimAir::getInstance();
+  uint64_t firstTxUs = 0;       // first transmission of the SignalB of the current press
+  uint64_t deliveredUs = 0;
+  air.setObserver([&](const F3XSimAir::Transmission& aTx) {
+    if (strcmp(aTx.sender, "LineController") != 0 || aTx.len < 2 || aTx.data[0] != F3X_RC_FRAME_MAGIC
+        || aTx.data[1] != (uint8_t) base::F3XRemoteCommandType::SignalB) {
+      return;
+    }
+    if (firstTxUs == 0) {
+      firstTxUs = aTx.startUs;
+    }
+    if (deliveredUs == 0 && aTx.deliveredUs != 0) {
+      deliveredUs = aTx.deliveredUs;
+    }
+  });
+  sim.start();
+  air.setLoss(loss);
+  air.setRetryDelayUs(retryDelayUs);
+
+  Stage pressToAir = {"press -> on air", {}};
+  Stage airToRx = {"on air -> delivered", {}};
+  Stage rxToSignal = {"delivered -> signalled", {}};
+  Stage signalToBuzz = {"signalled -> buzzer", {}};
+  Stage total = {"press -> buzzer", {}};
+  uint32_t lost = 0;
+  uint32_t notBuzzed = 0;
+
+  uint32_t done = 0;
+  sim.startF3BSpeedTask();
+  base::F3XFixedDistanceTask* task = base::ourCourses[0].getActiveTask();
+  while (done < presses) {
+    uint64_t t = sim.getRunner().getTimeUs() + 500000;
+    // A - B - A - B - A, the B presses are measured
+    for (uint8_t leg=0; leg<=4; leg++) {
+      uint64_t pressUs = t + leg*LEG_US;
+      if (leg%2 == 0) {
+        sim.getBase().press(SIM_PIN_SIGNAL_A, pressUs, SIM_BUTTON_US);
+        sim.getRunner().runUntil(pressUs + 1000000);
+        continue;
+      }
+      sim.getRunner().runUntil(pressUs);
+      int8_t legs = task->getSignalledLegCount();
+      uint16_t pulses = countPulses(sim.getBuzzer(), SIM_PIN_REMOTE_BUZZER);
+      firstTxUs = 0;
+      deliveredUs = 0;
+      sim.getLineB().press(SIM_PIN_SIGNAL_B, pressUs, SIM_BUTTON_US);
+      if (!sim.getRunner().runUntil([&]{ return task->getSignalledLegCount() != legs; }, pressUs + 2000000)) {
+        lost++;
+        continue;
+      }
+      uint64_t signalledUs = sim.getBase().getTimeUs();
+      if (!sim.getRunner().runUntil([&]{ return countPulses(sim.getBuzzer(), SIM_PIN_REMOTE_BUZZER) != pulses; },
+          pressUs + 2000000)) {
+        notBuzzed++;
+        continue;
+      }
+      uint64_t buzzUs = sim.getBuzzer().getEdges(SIM_PIN_REMOTE_BUZZER).back().timeUs;
+      // a blocking transmission buzzes within the loop, which signalled the task
+      signalledUs = std::min(signalledUs, buzzUs);
+      pressToAir.values.push_back((firstTxUs - pressUs) / 1000.0);
+      airToRx.values.push_back((deliveredUs - firstTxUs) / 1000.0);
+      rxToSignal.values.push_back((signalledUs - deliveredUs) / 1000.0);
+      signalToBuzz.values.push_back((buzzUs - signalledUs) / 1000.0);
+      total.values.push_back((buzzUs - pressUs) / 1000.0);
+      done++;
+    }
+    // a press resets the finished (or with a lost signal still running) task, the next one
+    // starts it again
+    uint64_t resetUs = sim.getRunner().getTimeUs() + 1500000;
+    if (task->getTaskState() == base::F3XFixedDistanceTask::TaskRunning) {
+      task->stop();
+      task->start();
+      continue;
+    }
+    sim.getBase().press(SIM_PIN_SIGNAL_A, resetUs, SIM_BUTTON_US);
+    sim.getBase().press(SIM_PIN_SIGNAL_A, resetUs + 1500000, SIM_BUTTON_US);
+    sim.getRunner().runUntil(resetUs + 2500000);
+  }
+
+  printf("B-Line signal pipeline: %u presses, loss %.2f, retransmit delay %s\n", presses, loss,
+    retryDelayUs == 0 ? "ARD of the radios" : (std::to_string(retryDelayUs) + "us").c_str());
+  printf("%-22s %8s %8s %8s\n", "stage [ms]", "p50", "p99", "max");
+  printStage(pressToAir);
+  printStage(airToRx);
+  printStage(rxToSignal);
+  printStage(signalToBuzz);
+  printStage(total);
+  printf("signals lost: %u, not buzzed: %u\n", lost, notBuzzed);
+  printf("air: %u transmissions, %u attempts, %u lost packets, %u failed\n", air.getTransmissionCount(),
+    air.getAttemptCount(), air.getLostCount(), air.getFailedCount());
+  {
+    F3XSimDevice::Scope scope(&sim.getBase());
+    printf("BaseManager: %s\n", base::getSignalLatencyInfo().c_str());
+  }
+  return 0;
+}
@@ -0,0 +1,23 @@
+#ifndef BaseManagerFirmware_h
+#define BaseManagerFirmware_h
+
+/**
+ * the BaseManager sketch with its part of the F3XLib in the namespace base. A test includes it
+ * directly to get access to the globals of the sketch, so only one test source of an executable
+ * may include it. The sketch runs on a device by
+ *   F3XSimDevice baseManager("BaseManager", base::setup, base::loop);
+ */
+#ifndef ESP8266
+#define ESP8266
+#endif
+#include "F3XSimPlatform.h"
+
+namespace base {
+#include "BaseManager.ino.cpp"
+#include "F3XFixedDistanceTask.cpp"
+#include "F3XRemoteCommand.cpp"
+#include "RFTransceiver.cpp"
+#include "RFTxQueue.cpp"
+}
+
+#endif
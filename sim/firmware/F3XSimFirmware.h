@@ -0,0 +1,29 @@
+#ifndef F3XSimFirmware_h
+#define F3XSimFirmware_h
+
+/**
+ * the entry points of the sketches of the Arduino Nano, each compiled in its own namespace, so
+ * they can run together with the BaseManager (see BaseManagerFirmware.h) in one executable.
+ * resetFunc of a sketch points to address 0 on the AVR, a simulation sets it to a function,
+ * which restarts the device (F3XSimDevice::restart()).
+ */
+namespace linectl {
+void setup();
+void loop();
+extern void (*resetFunc)(void);
+}
+
+// LineController of the second course (USE_SECOND_COURSE)
+namespace linectl2 {
+void setup();
+void loop();
+extern void (*resetFunc)(void);
+}
+
+namespace buzzer {
+void setup();
+void loop();
+extern void (*resetFunc)(void);
+}
+
+#endif
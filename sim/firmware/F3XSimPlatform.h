@@ -0,0 +1,22 @@
+#ifndef F3XSimPlatform_h
+#define F3XSimPlatform_h
+
+/**
+ * all headers of the shim, included at global scope before a sketch is included into its
+ * namespace, so the include guards keep them out of the namespace
+ */
+#include <Arduino.h>
+#include <ArduinoOTA.h>
+#include <Bounce2.h>
+#include <EEPROM.h>
+#include <Encoder.h>
+#include <ESP8266WiFi.h>
+#include <ESP8266WebServer.h>
+#include <ESP8266httpUpdate.h>
+#include <ESP8266mDNS.h>
+#include <LittleFS.h>
+#include <RF24.h>
+#include <U8g2lib.h>
+#include <WiFiUdp.h>
+
+#endif
@@ -0,0 +1,16 @@
+/**
+ * the LineController sketch with its part of the F3XLib in the namespace linectl, compiled with
+ * USE_SECOND_COURSE in the namespace linectl2 (see F3XSimFirmware.h)
+ */
+#include "F3XSimPlatform.h"
+#include "F3XSimFirmware.h"
+
+#ifdef USE_SECOND_COURSE
+namespace linectl2 {
+#else
+namespace linectl {
+#endif
+#include "LineController.ino.cpp"
+#include "F3XRemoteCommand.cpp"
+#include "RFTransceiver.cpp"
+}
@@ -0,0 +1,12 @@
+/**
+ * the RemoteBuzzer sketch with its part of the F3XLib in the namespace buzzer (see
+ * F3XSimFirmware.h)
+ */
+#include "F3XSimPlatform.h"
+#include "F3XSimFirmware.h"
+
+namespace buzzer {
+#include "RemoteBuzzer.ino.cpp"
+#include "F3XRemoteCommand.cpp"
+#include "RFTransceiver.cpp"
+}
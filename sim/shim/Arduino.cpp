@@ -0,0 +1,125 @@
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "F3XSimDevice.h"
+
+#define F3X_SIM_CPU_MHZ 80
+
+HardwareSerial Serial;
+EspClass ESP;
+EEPROMClass EEPROM;
+
+unsigned long millis() {
+  return F3XSimDevice::current()->getMillis();
+}
+
+unsigned long micros() {
+  return F3XSimDevice::current()->getMicros();
+}
+
+void delay(unsigned long aMs) {
+  F3XSimDevice::current()->advance((uint64_t) aMs * 1000);
+}
+
+void delayMicroseconds(unsigned int aUs) {
+  F3XSimDevice::current()->advance(aUs);
+}
+
+void yield() {
+}
+
+void pinMode(uint8_t aPin, uint8_t aMode) {
+  F3XSimDevice::current()->setPinMode(aPin, aMode);
+}
+
+void digitalWrite(uint8_t aPin, uint8_t aLevel) {
+  F3XSimDevice::current()->writePin(aPin, aLevel);
+}
+
+int digitalRead(uint8_t aPin) {
+  return F3XSimDevice::current()->readPin(aPin);
+}
+
+int analogRead(uint8_t aPin) {
+  return F3XSimDevice::current()->getAnalog(aPin);
+}
+
+void analogReference(uint8_t aMode) {
+}
+
+int digitalPinToInterrupt(int aPin) {
+  return aPin;
+}
+
+void attachInterrupt(int aInterrupt, void (*aIsr)(void), int aMode) {
+  F3XSimDevice::current()->attachInterrupt(aInterrupt, aIsr, aMode);
+}
+
+void detachInterrupt(int aInterrupt) {
+  F3XSimDevice::current()->detachInterrupt(aInterrupt);
+}
+
+void noInterrupts() {
+  F3XSimDevice::current()->setInterruptsEnabled(false);
+}
+
+void interrupts() {
+  F3XSimDevice::current()->setInterruptsEnabled(true);
+}
+
+void HardwareSerial::begin(unsigned long aBaud) {
+}
+
+size_t HardwareSerial::write(uint8_t aChar) {
+  F3XSimDevice::current()->writeSerial(aChar);
+  return 1;
+}
+
+void EspClass::restart() {
+  F3XSimDevice::current()->restart();
+}
+
+uint32_t EspClass::getCycleCount() {
+  return (uint32_t) (F3XSimDevice::current()->getTimeUs() * F3X_SIM_CPU_MHZ);
+}
+
+uint32_t EspClass::getFreeHeap() {
+  return 40000;
+}
+
+uint32_t EspClass::getCpuFreqMHz() {
+  return F3X_SIM_CPU_MHZ;
+}
+
+uint16_t EspClass::getMaxFreeBlockSize() {
+  return 30000;
+}
+
+bool EspClass::rtcUserMemoryRead(uint32_t aOffset, uint32_t* aData, size_t aSize) {
+  if (aOffset * 4 + aSize > F3X_SIM_RTC_WORDS * 4) {
+    return false;
+  }
+  memcpy(aData, F3XSimDevice::current()->getRtcMemory() + aOffset, aSize);
+  return true;
+}
+
+bool EspClass::rtcUserMemoryWrite(uint32_t aOffset, uint32_t* aData, size_t aSize) {
+  if (aOffset * 4 + aSize > F3X_SIM_RTC_WORDS * 4) {
+    return false;
+  }
+  memcpy(F3XSimDevice::current()->getRtcMemory() + aOffset, aData, aSize);
+  return true;
+}
+
+uint8_t* EEPROMClass::getData() {
+  return F3XSimDevice::current()->getEeprom();
+}
+
+void EEPROMClass::begin(size_t aSize) {
+}
+
+bool EEPROMClass::commit() {
+  return true;
+}
+
+void EEPROMClass::end() {
+}
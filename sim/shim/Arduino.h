@@ -0,0 +1,124 @@
+#ifndef Arduino_h
+#define Arduino_h
+
+/**
+ * host shim of the Arduino core for the simulation of the firmware (see "Host Simulation" in the
+ * README). Only the API used by the sketches and the F3XLib is provided, the functions act on the
+ * simulated device, whose code is running (F3XSimDevice::current()).
+ * All system headers of the firmware are included here, so a sketch can be compiled within a
+ * namespace (see the firmware units in sim/).
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <math.h>
+#include <limits.h>
+#include <functional>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW  0
+
+#define INPUT        0
+#define OUTPUT       1
+#define INPUT_PULLUP 2
+#define FUNCTION_3   3
+
+#define RISING  1
+#define FALLING 2
+#define CHANGE  3
+
+#define DEFAULT 0
+
+#define IRAM_ATTR
+#define ICACHE_RAM_ATTR
+#define PROGMEM
+#define PSTR(s) (s)
+
+// ESP8266 (NodeMCU) pin names
+#define D0 16
+#define D1  5
+#define D2  4
+#define D3  0
+#define D4  2
+#define D5 14
+#define D6 12
+#define D7 13
+#define D8 15
+#define D9  3
+#define D10 1
+#define A0 17
+#define A7 21
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(PSTR(s)))
+#define FPSTR(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define memcpy_P memcpy
+#define snprintf_P snprintf
+#define sprintf_P sprintf
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define pgm_read_word(p) (*(const uint16_t*)(p))
+#define pgm_read_dword(p) (*(const uint32_t*)(p))
+#define pgm_read_ptr(p) (*(void* const*)(p))
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long aMs);
+void delayMicroseconds(unsigned int aUs);
+void yield();
+
+void pinMode(uint8_t aPin, uint8_t aMode);
+void digitalWrite(uint8_t aPin, uint8_t aLevel);
+int digitalRead(uint8_t aPin);
+int analogRead(uint8_t aPin);
+void analogReference(uint8_t aMode);
+int digitalPinToInterrupt(int aPin);
+void attachInterrupt(int aInterrupt, void (*aIsr)(void), int aMode);
+void detachInterrupt(int aInterrupt);
+void noInterrupts();
+void interrupts();
+
+template<class T> T max(T a, T b) { return a > b ? a : b; }
+template<class T> T min(T a, T b) { return a < b ? a : b; }
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+
+class HardwareSerial : public Stream {
+  public:
+    void begin(unsigned long aBaud);
+    size_t write(uint8_t aChar) override;
+    using Print::write;
+    operator bool() {
+      return true;
+    }
+};
+
+extern HardwareSerial Serial;
+
+class EspClass {
+  public:
+    void restart();
+    uint32_t getCycleCount();
+    uint32_t getFreeHeap();
+    uint32_t getCpuFreqMHz();
+    uint16_t getMaxFreeBlockSize();
+    bool rtcUserMemoryRead(uint32_t aOffset, uint32_t* aData, size_t aSize);
+    bool rtcUserMemoryWrite(uint32_t aOffset, uint32_t* aData, size_t aSize);
+};
+
+extern EspClass ESP;
+
+#endif
@@ -0,0 +1,33 @@
+#include <ArduinoOTA.h>
+
+#define F3X_SIM_OTA_RATE 50  // bytes per ms of the upload
+
+ArduinoOTAClass ArduinoOTA;
+
+void ArduinoOTAClass::simulateUpdate(uint32_t aSize, int aCommand) {
+  myPendingSize = aSize;
+  myCommand = aCommand;
+}
+
+void ArduinoOTAClass::handle() {
+  if (!myBegun || myPendingSize == 0) {
+    return;
+  }
+  uint32_t size = myPendingSize;
+  myPendingSize = 0;
+  if (myOnStart) {
+    myOnStart();
+  }
+  for (uint32_t done = 0; done < size; ) {
+    uint32_t n = size - done < 1460 ? size - done : 1460;
+    delay(n / F3X_SIM_OTA_RATE + 1);
+    done += n;
+    if (myOnProgress) {
+      myOnProgress(done, size);
+    }
+  }
+  if (myOnEnd) {
+    myOnEnd();
+  }
+  ESP.restart();
+}
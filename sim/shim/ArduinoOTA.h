@@ -0,0 +1,62 @@
+#ifndef ArduinoOTA_h
+#define ArduinoOTA_h
+
+#include <Arduino.h>
+#include <functional>
+
+typedef enum {
+  OTA_AUTH_ERROR,
+  OTA_BEGIN_ERROR,
+  OTA_CONNECT_ERROR,
+  OTA_RECEIVE_ERROR,
+  OTA_END_ERROR
+} ota_error_t;
+
+#define U_FLASH 0
+#define U_FS    100
+
+/**
+ * OTA update of the ESP8266 core. An update requested by simulateUpdate() is received by the next
+ * handle(): the callbacks are called like by the core and the device is restarted.
+ */
+class ArduinoOTAClass {
+  public:
+    typedef std::function<void(void)> THandlerFunction;
+
+    void setPassword(const char* aPassword) {}
+    void setHostname(const char* aHostname) {}
+    void onStart(THandlerFunction aHandler) {
+      myOnStart = aHandler;
+    }
+    void onEnd(THandlerFunction aHandler) {
+      myOnEnd = aHandler;
+    }
+    void onProgress(std::function<void(unsigned int, unsigned int)> aHandler) {
+      myOnProgress = aHandler;
+    }
+    void onError(std::function<void(ota_error_t)> aHandler) {
+      myOnError = aHandler;
+    }
+    void begin() {
+      myBegun = true;
+    }
+    void handle();
+    int getCommand() {
+      return myCommand;
+    }
+
+    void simulateUpdate(uint32_t aSize, int aCommand=U_FLASH);
+
+  private:
+    THandlerFunction myOnStart;
+    THandlerFunction myOnEnd;
+    std::function<void(unsigned int, unsigned int)> myOnProgress;
+    std::function<void(ota_error_t)> myOnError;
+    bool myBegun = false;
+    int myCommand = U_FLASH;
+    uint32_t myPendingSize = 0;
+};
+
+extern ArduinoOTAClass ArduinoOTA;
+
+#endif
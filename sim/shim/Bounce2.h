@@ -0,0 +1,68 @@
+#ifndef Bounce2_h
+#define Bounce2_h
+
+#include <Arduino.h>
+
+namespace Bounce2 {
+
+/**
+ * debounced button like Bounce2 with its default algorithm: the state changes, after the input
+ * was stable for the interval
+ */
+class Button {
+  public:
+    void attach(int aPin, int aMode) {
+      myPin = aPin;
+      pinMode(aPin, aMode);
+      myUnstable = digitalRead(aPin);
+      myState = myUnstable;
+      myLastMs = millis();
+    }
+    void interval(uint16_t aMs) {
+      myInterval = aMs;
+    }
+    void setPressedState(bool aState) {
+      myPressedState = aState;
+    }
+    bool update() {
+      myChanged = false;
+      bool current = digitalRead(myPin);
+      if (current != myUnstable) {
+        myLastMs = millis();
+        myUnstable = current;
+      } else if (millis() - myLastMs >= myInterval && current != myState) {
+        myLastMs = millis();
+        myState = current;
+        myChanged = true;
+      }
+      return myChanged;
+    }
+    bool read() {
+      return myState;
+    }
+    bool changed() {
+      return myChanged;
+    }
+    bool isPressed() {
+      return myState == myPressedState;
+    }
+    bool pressed() {
+      return myChanged && isPressed();
+    }
+    bool released() {
+      return myChanged && !isPressed();
+    }
+
+  private:
+    int myPin = 0;
+    uint16_t myInterval = 10;
+    bool myPressedState = LOW;
+    bool myUnstable = HIGH;
+    bool myState = HIGH;
+    bool myChanged = false;
+    unsigned long myLastMs = 0;
+};
+
+}
+
+#endif
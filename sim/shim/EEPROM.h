@@ -0,0 +1,43 @@
+#ifndef EEPROM_h
+#define EEPROM_h
+
+#include <Arduino.h>
+
+/**
+ * EEPROM of the ESP8266 (emulated in flash) and the AVR, the bytes are kept by the simulated
+ * device (F3XSimDevice::getEeprom())
+ */
+class EEPROMClass {
+  public:
+    void begin(size_t aSize);
+    bool commit();
+    void end();
+    uint16_t length() {
+      return F3X_EEPROM_SIZE;
+    }
+    uint8_t read(int aAddress) {
+      return getData()[aAddress];
+    }
+    void write(int aAddress, uint8_t aValue) {
+      getData()[aAddress] = aValue;
+    }
+    void update(int aAddress, uint8_t aValue) {
+      write(aAddress, aValue);
+    }
+    template<class T> T& get(int aAddress, T& aValue) {
+      memcpy((void*) &aValue, getData() + aAddress, sizeof(T));
+      return aValue;
+    }
+    template<class T> const T& put(int aAddress, const T& aValue) {
+      memcpy(getData() + aAddress, (const void*) &aValue, sizeof(T));
+      return aValue;
+    }
+
+  private:
+    static const uint16_t F3X_EEPROM_SIZE = 4096;
+    uint8_t* getData();
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,222 @@
+#include <strings.h>
+#include <ESP8266WebServer.h>
+#include "F3XSimDevice.h"
+#include "F3XSimNetwork.h"
+
+static const char* getStatusText(int aCode) {
+  switch (aCode) {
+    case 200: return "OK";
+    case 204: return "No Content";
+    case 206: return "Partial Content";
+    case 304: return "Not Modified";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    case 409: return "Conflict";
+    case 416: return "Range Not Satisfiable";
+    case 500: return "Internal Server Error";
+    case 503: return "Service Unavailable";
+  }
+  return "";
+}
+
+void ESP8266WebServer::handleClient() {
+  F3XSimDevice* device = F3XSimDevice::current();
+  F3XSimNetwork& network = device->getNetwork();
+  if (!network.hasRequest()) {
+    return;
+  }
+  F3XSimNetwork::Request request = network.popRequest();
+  request.response->handled = true;
+  request.response->handledUs = device->getTimeUs();
+  myUri = request.path.c_str();
+  myMethod = request.method == "POST" ? HTTP_POST : HTTP_GET;
+  myArgs = request.args;
+  myHeaders = request.headers;
+  myResponseHeaders = String();
+  myContentLength = CONTENT_LENGTH_NOT_SET;
+  myChunked = false;
+  myClient = WiFiClient(std::make_shared<F3XSimConnection>(device, request.response));
+
+  THandlerFunction handler = myNotFound;
+  for (auto& entry : myHandlers) {
+    if (entry.first == myUri) {
+      handler = entry.second;
+      break;
+    }
+  }
+  if (handler) {
+    handler();
+  } else {
+    send(404, "text/plain", String("Not found: ") + myUri);
+  }
+  // like the core, a chunked body is terminated after the handler
+  if (myChunked) {
+    write("", 0);
+  }
+  // the connection is released, if the handler did not keep a copy of the client
+  myClient = WiFiClient();
+}
+
+void ESP8266WebServer::on(const String& aUri, THandlerFunction aHandler) {
+  myHandlers.push_back({aUri, aHandler});
+}
+
+void ESP8266WebServer::on(const String& aUri, HTTPMethod aMethod, THandlerFunction aHandler) {
+  on(aUri, aHandler);
+}
+
+void ESP8266WebServer::onNotFound(THandlerFunction aHandler) {
+  myNotFound = aHandler;
+}
+
+String ESP8266WebServer::uri() {
+  return myUri;
+}
+
+HTTPMethod ESP8266WebServer::method() {
+  return myMethod;
+}
+
+String ESP8266WebServer::arg(const String& aName) {
+  for (auto& arg : myArgs) {
+    if (aName == arg.first.c_str()) {
+      return String(arg.second);
+    }
+  }
+  return String();
+}
+
+String ESP8266WebServer::arg(int aIdx) {
+  return aIdx >= 0 && aIdx < (int) myArgs.size() ? String(myArgs[aIdx].second) : String();
+}
+
+String ESP8266WebServer::argName(int aIdx) {
+  return aIdx >= 0 && aIdx < (int) myArgs.size() ? String(myArgs[aIdx].first) : String();
+}
+
+int ESP8266WebServer::args() {
+  return myArgs.size();
+}
+
+bool ESP8266WebServer::hasArg(const String& aName) {
+  for (auto& arg : myArgs) {
+    if (aName == arg.first.c_str()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+String ESP8266WebServer::header(const String& aName) {
+  for (auto& header : myHeaders) {
+    if (strcasecmp(header.first.c_str(), aName.c_str()) == 0) {
+      return String(header.second);
+    }
+  }
+  return String();
+}
+
+bool ESP8266WebServer::hasHeader(const String& aName) {
+  for (auto& header : myHeaders) {
+    if (strcasecmp(header.first.c_str(), aName.c_str()) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+WiFiClient& ESP8266WebServer::client() {
+  return myClient;
+}
+
+void ESP8266WebServer::sendHeader(const String& aName, const String& aValue, bool aFirst) {
+  String line = aName + ": " + aValue + "\r\n";
+  myResponseHeaders = aFirst ? line + myResponseHeaders : myResponseHeaders + line;
+}
+
+void ESP8266WebServer::setContentLength(size_t aLength) {
+  myContentLength = aLength;
+}
+
+void ESP8266WebServer::sendHead(int aCode, const char* aType) {
+  String head = String("HTTP/1.1 ") + aCode + " " + getStatusText(aCode) + "\r\n";
+  if (aType != nullptr && aType[0] != '\0') {
+    head += String("Content-Type: ") + aType + "\r\n";
+  }
+  if (myContentLength == CONTENT_LENGTH_UNKNOWN) {
+    myChunked = true;
+    head += "Transfer-Encoding: chunked\r\n";
+  } else if (myContentLength != CONTENT_LENGTH_NOT_SET) {
+    head += String("Content-Length: ") + (unsigned long) myContentLength + "\r\n";
+  }
+  head += myResponseHeaders;
+  head += "Connection: close\r\n\r\n";
+  myResponseHeaders = String();
+  myClient.write((const uint8_t*) head.c_str(), head.length());
+}
+
+void ESP8266WebServer::write(const char* aData, size_t aSize) {
+  if (!myChunked) {
+    myClient.write((const uint8_t*) aData, aSize);
+    return;
+  }
+  // the chunks are written as one segment like the core does it
+  char size[12];
+  snprintf(size, sizeof(size), "%zx\r\n", aSize);
+  std::string chunk = size;
+  chunk.append(aData, aSize);
+  chunk += "\r\n";
+  if (aSize == 0) {
+    myChunked = false;
+  }
+  myClient.write((const uint8_t*) chunk.data(), chunk.size());
+}
+
+void ESP8266WebServer::send(int aCode, const char* aType, const String& aContent) {
+  if (myContentLength == CONTENT_LENGTH_NOT_SET) {
+    myContentLength = aContent.length();
+  }
+  sendHead(aCode, aType);
+  if (aContent.length() > 0) {
+    write(aContent.c_str(), aContent.length());
+  }
+}
+
+void ESP8266WebServer::send(int aCode, const String& aType, const String& aContent) {
+  send(aCode, aType.c_str(), aContent);
+}
+
+void ESP8266WebServer::send(int aCode, const __FlashStringHelper* aType, const String& aContent) {
+  send(aCode, (const char*) aType, aContent);
+}
+
+void ESP8266WebServer::send(int aCode, const char* aType, const char* aContent) {
+  send(aCode, aType, String(aContent));
+}
+
+void ESP8266WebServer::send(int aCode, const __FlashStringHelper* aType, const char* aContent) {
+  send(aCode, (const char*) aType, String(aContent));
+}
+
+void ESP8266WebServer::send(int aCode, const __FlashStringHelper* aType, const __FlashStringHelper* aContent) {
+  send(aCode, (const char*) aType, String(aContent));
+}
+
+void ESP8266WebServer::send_P(int aCode, const char* aType, const char* aContent) {
+  send(aCode, aType, String(aContent));
+}
+
+void ESP8266WebServer::sendContent(const String& aContent) {
+  sendContent(aContent.c_str(), aContent.length());
+}
+
+void ESP8266WebServer::sendContent(const char* aContent, size_t aSize) {
+  if (aSize == 0 && !myChunked) {
+    return;
+  }
+  write(aContent, aSize);
+}
+
+void ESP8266WebServer::sendContent_P(const char* aContent) {
+  sendContent(aContent, strlen(aContent));
+}
@@ -0,0 +1,92 @@
+#ifndef ESP8266WebServer_h
+#define ESP8266WebServer_h
+
+#include <ESP8266WiFi.h>
+#include <LittleFS.h>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+enum HTTPMethod {
+  HTTP_ANY,
+  HTTP_GET,
+  HTTP_HEAD,
+  HTTP_POST,
+  HTTP_PUT,
+  HTTP_PATCH,
+  HTTP_DELETE,
+  HTTP_OPTIONS
+};
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t) -1)
+#define CONTENT_LENGTH_NOT_SET ((size_t) -2)
+
+/**
+ * web server of the ESP8266 core, handleClient() dispatches the next request queued by the test
+ * (F3XSimNetwork::request()) to its handler. The response is written through the connection of
+ * the request, like the core it uses the chunked transfer encoding for CONTENT_LENGTH_UNKNOWN.
+ */
+class ESP8266WebServer {
+  public:
+    typedef std::function<void(void)> THandlerFunction;
+
+    ESP8266WebServer(int aPort=80) {}
+
+    void begin() {}
+    void close() {}
+    void handleClient();
+    void on(const String& aUri, THandlerFunction aHandler);
+    void on(const String& aUri, HTTPMethod aMethod, THandlerFunction aHandler);
+    void onNotFound(THandlerFunction aHandler);
+    void collectHeaders(const char* aHeaderKeys[], const size_t aHeaderKeysCount) {}
+
+    String uri();
+    HTTPMethod method();
+    String arg(const String& aName);
+    String arg(int aIdx);
+    String argName(int aIdx);
+    int args();
+    bool hasArg(const String& aName);
+    String header(const String& aName);
+    bool hasHeader(const String& aName);
+    WiFiClient& client();
+
+    void sendHeader(const String& aName, const String& aValue, bool aFirst=false);
+    void setContentLength(size_t aLength);
+    void send(int aCode, const char* aType=nullptr, const String& aContent=String());
+    void send(int aCode, const String& aType, const String& aContent=String());
+    void send(int aCode, const __FlashStringHelper* aType, const String& aContent=String());
+    void send(int aCode, const char* aType, const char* aContent);
+    void send(int aCode, const __FlashStringHelper* aType, const char* aContent);
+    void send(int aCode, const __FlashStringHelper* aType, const __FlashStringHelper* aContent);
+    void send_P(int aCode, const char* aType, const char* aContent);
+    void sendContent(const String& aContent);
+    void sendContent(const char* aContent, size_t aSize);
+    void sendContent_P(const char* aContent);
+    template<class T> size_t streamFile(T& aFile, const String& aType, HTTPMethod aMethod=HTTP_GET) {
+      if (myContentLength == CONTENT_LENGTH_NOT_SET) {
+        myContentLength = aFile.size();
+      }
+      sendHead(200, aType.c_str());
+      return aMethod == HTTP_HEAD ? 0 : myClient.write(aFile);
+    }
+
+  private:
+    void sendHead(int aCode, const char* aType);
+    void write(const char* aData, size_t aSize);
+
+    std::vector<std::pair<String, THandlerFunction>> myHandlers;
+    THandlerFunction myNotFound;
+    String myUri;
+    HTTPMethod myMethod = HTTP_GET;
+    std::vector<std::pair<std::string, std::string>> myArgs;
+    std::map<std::string, std::string> myHeaders;
+    WiFiClient myClient;
+    String myResponseHeaders;
+    size_t myContentLength = CONTENT_LENGTH_NOT_SET;
+    bool myChunked = false;
+};
+
+#endif
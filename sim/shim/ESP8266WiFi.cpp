@@ -0,0 +1,102 @@
+#include <ESP8266WiFi.h>
+#include <ESP8266mDNS.h>
+#include <ESP8266httpUpdate.h>
+#include "F3XSimDevice.h"
+#include "F3XSimNetwork.h"
+
+WiFiClass WiFi;
+MDNSResponder MDNS;
+ESP8266HTTPUpdate ESPhttpUpdate;
+
+static F3XSimNetwork& getNetwork() {
+  return F3XSimDevice::current()->getNetwork();
+}
+
+String IPAddress::toString() const {
+  char buf[16];
+  snprintf(buf, sizeof(buf), "%u.%u.%u.%u", myBytes[0], myBytes[1], myBytes[2], myBytes[3]);
+  return String(buf);
+}
+
+wl_status_t WiFiClass::status() {
+  return getNetwork().isConnected() ? WL_CONNECTED : WL_DISCONNECTED;
+}
+
+bool WiFiClass::mode(WiFiMode_t aMode) {
+  if (aMode == WIFI_OFF || aMode == WIFI_AP) {
+    getNetwork().setConnected(false);
+  }
+  return true;
+}
+
+wl_status_t WiFiClass::begin(const char* aSsid, const char* aPassword) {
+  getNetwork().setConnected(aSsid != nullptr && aSsid[0] != '\0' && getNetwork().isStationAvailable());
+  return status();
+}
+
+bool WiFiClass::softAPConfig(IPAddress aIp, IPAddress aGateway, IPAddress aMask) {
+  return true;
+}
+
+bool WiFiClass::softAP(const char* aSsid, const char* aPassword, int aChannel, int aHidden, int aMaxConnection) {
+  return true;
+}
+
+IPAddress WiFiClass::localIP() {
+  return getNetwork().isConnected() ? IPAddress(192, 168, 1, 42) : IPAddress();
+}
+
+IPAddress WiFiClass::softAPIP() {
+  return IPAddress(192, 168, 4, 1);
+}
+
+int32_t WiFiClass::RSSI() {
+  return getNetwork().isConnected() ? -60 : 0;
+}
+
+String WiFiClass::macAddress() {
+  return String("5C:CF:7F:00:00:01");
+}
+
+size_t WiFiClient::write(uint8_t aChar) {
+  return write(&aChar, 1);
+}
+
+size_t WiFiClient::write(const uint8_t* aBuffer, size_t aSize) {
+  return myConnection ? myConnection->write(aBuffer, aSize) : 0;
+}
+
+size_t WiFiClient::write(Stream& aStream) {
+  uint8_t buffer[1460];
+  size_t total = 0;
+  while (aStream.available() > 0) {
+    size_t n = aStream.readBytes(buffer, sizeof(buffer) < (size_t) aStream.available() ? sizeof(buffer) : aStream.available());
+    if (n == 0 || write(buffer, n) != n) {
+      break;
+    }
+    total += n;
+  }
+  return total;
+}
+
+int WiFiClient::availableForWrite() {
+  return myConnection ? myConnection->availableForWrite() : 0;
+}
+
+uint8_t WiFiClient::connected() {
+  return myConnection && myConnection->connected();
+}
+
+void WiFiClient::stop() {
+  if (myConnection) {
+    myConnection->stop();
+  }
+}
+
+IPAddress WiFiClient::remoteIP() {
+  return myConnection ? IPAddress(192, 168, 1, 10) : IPAddress();
+}
+
+WiFiClient::operator bool() {
+  return connected();
+}
@@ -0,0 +1,92 @@
+#ifndef ESP8266WiFi_h
+#define ESP8266WiFi_h
+
+#include <Arduino.h>
+#include <memory>
+
+class F3XSimConnection;
+
+class IPAddress {
+  public:
+    IPAddress() : IPAddress(0, 0, 0, 0) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+      myBytes[0] = a;
+      myBytes[1] = b;
+      myBytes[2] = c;
+      myBytes[3] = d;
+    }
+    String toString() const;
+    uint8_t operator[](int aIdx) const {
+      return myBytes[aIdx];
+    }
+  private:
+    uint8_t myBytes[4];
+};
+
+typedef enum {
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum {
+  WIFI_OFF = 0,
+  WIFI_STA = 1,
+  WIFI_AP = 2,
+  WIFI_AP_STA = 3
+} WiFiMode_t;
+
+/**
+ * WiFi of the simulated device, the station connects at once, if the access point is available
+ * (F3XSimNetwork::setStationAvailable())
+ */
+class WiFiClass {
+  public:
+    wl_status_t status();
+    bool mode(WiFiMode_t aMode);
+    void persistent(bool aPersistent) {}
+    wl_status_t begin(const char* aSsid, const char* aPassword=nullptr);
+    bool softAPConfig(IPAddress aIp, IPAddress aGateway, IPAddress aMask);
+    bool softAP(const char* aSsid, const char* aPassword=nullptr, int aChannel=1, int aHidden=0, int aMaxConnection=4);
+    IPAddress localIP();
+    IPAddress softAPIP();
+    int32_t RSSI();
+    String macAddress();
+};
+
+extern WiFiClass WiFi;
+
+/**
+ * TCP client of a web request (see ESP8266WebServer::client()), copies share the connection
+ */
+class WiFiClient : public Stream {
+  public:
+    WiFiClient() {}
+    WiFiClient(std::shared_ptr<F3XSimConnection> aConnection) : myConnection(aConnection) {}
+
+    size_t write(uint8_t aChar) override;
+    size_t write(const uint8_t* aBuffer, size_t aSize) override;
+    size_t write(Stream& aStream);
+    using Print::write;
+    int availableForWrite() override;
+    int available() override {
+      return 0;
+    }
+    int read() override {
+      return -1;
+    }
+    uint8_t connected();
+    void stop();
+    void flush() override {}
+    void setNoDelay(bool aNoDelay) {}
+    void setSync(bool aSync) {}
+    IPAddress remoteIP();
+    operator bool();
+
+  private:
+    std::shared_ptr<F3XSimConnection> myConnection;
+};
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef ESP8266httpUpdate_h
+#define ESP8266httpUpdate_h
+
+#include <ESP8266WiFi.h>
+
+typedef enum {
+  HTTP_UPDATE_FAILED,
+  HTTP_UPDATE_NO_UPDATES,
+  HTTP_UPDATE_OK
+} t_httpUpdate_return;
+
+/**
+ * HTTP update of the ESP8266 core, there is no update server in the simulation
+ */
+class ESP8266HTTPUpdate {
+  public:
+    t_httpUpdate_return update(WiFiClient& aClient, const String& aUrl, const String& aVersion="") {
+      return HTTP_UPDATE_FAILED;
+    }
+    t_httpUpdate_return updateFS(WiFiClient& aClient, const String& aUrl, const String& aVersion="") {
+      return HTTP_UPDATE_FAILED;
+    }
+    String getLastErrorString() {
+      return String("no update server in the simulation");
+    }
+    int getLastError() {
+      return -1;
+    }
+};
+
+extern ESP8266HTTPUpdate ESPhttpUpdate;
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef ESP8266mDNS_h
+#define ESP8266mDNS_h
+
+#include <ESP8266WiFi.h>
+
+class MDNSResponder {
+  public:
+    bool begin(const char* aHostname, IPAddress aIp=IPAddress()) {
+      return true;
+    }
+    void addService(const char* aService, const char* aProto, uint16_t aPort) {}
+    void update() {}
+};
+
+extern MDNSResponder MDNS;
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef Encoder_h
+#define Encoder_h
+
+#include <Arduino.h>
+
+/**
+ * rotary encoder, the position only changes by write() in the simulation
+ */
+class Encoder {
+  public:
+    Encoder(uint8_t aPin1, uint8_t aPin2) {}
+    long read() {
+      return myPosition;
+    }
+    void write(long aPosition) {
+      myPosition = aPosition;
+    }
+  private:
+    long myPosition = 0;
+};
+
+#endif
@@ -0,0 +1,149 @@
+#include <algorithm>
+#include "F3XSimAir.h"
+#include "F3XSimDevice.h"
+
+F3XSimAir::F3XSimAir() {
+  reset();
+}
+
+F3XSimAir& F3XSimAir::getInstance() {
+  static F3XSimAir instance;
+  return instance;
+}
+
+void F3XSimAir::reset() {
+  myLoss = 0;
+  myChannelLoss.clear();
+  myCarrier.clear();
+  myRetryDelayUs = 0;
+  myRandom.seed(1);
+  myTransmissions = 0;
+  myAttempts = 0;
+  myLost = 0;
+  myFailed = 0;
+}
+
+void F3XSimAir::add(RF24* aRadio) {
+  if (std::find(myRadios.begin(), myRadios.end(), aRadio) == myRadios.end()) {
+    myRadios.push_back(aRadio);
+  }
+}
+
+void F3XSimAir::remove(RF24* aRadio) {
+  myRadios.erase(std::remove(myRadios.begin(), myRadios.end(), aRadio), myRadios.end());
+}
+
+void F3XSimAir::setLoss(double aProbability) {
+  myLoss = aProbability;
+}
+
+void F3XSimAir::setChannelLoss(uint8_t aChannel, double aProbability) {
+  myChannelLoss[aChannel] = aProbability;
+}
+
+void F3XSimAir::setCarrier(uint8_t aChannel, bool aCarrier) {
+  myCarrier[aChannel] = aCarrier;
+}
+
+bool F3XSimAir::hasCarrier(uint8_t aChannel) {
+  auto it = myCarrier.find(aChannel);
+  return it != myCarrier.end() && it->second;
+}
+
+void F3XSimAir::setRetryDelayUs(uint32_t aUs) {
+  myRetryDelayUs = aUs;
+}
+
+void F3XSimAir::setSeed(uint32_t aSeed) {
+  myRandom.seed(aSeed);
+}
+
+void F3XSimAir::setObserver(std::function<void(const Transmission&)> aObserver) {
+  myObserver = aObserver;
+}
+
+bool F3XSimAir::isLost(uint8_t aChannel) {
+  double loss = myLoss;
+  auto it = myChannelLoss.find(aChannel);
+  if (it != myChannelLoss.end()) {
+    loss = 1 - (1 - loss) * (1 - it->second);
+  }
+  if (loss <= 0) {
+    return false;
+  }
+  bool lost = std::uniform_real_distribution<double>(0, 1)(myRandom) < loss;
+  if (lost) {
+    myLost++;
+  }
+  return lost;
+}
+
+uint32_t F3XSimAir::getAirtimeUs(uint8_t aLen, rf24_datarate_e aRate) {
+  // preamble, address, packet control field (9 bits), payload, CRC (2 bytes)
+  uint32_t bits = (1 + 5 + aLen + 2) * 8 + 9;
+  switch (aRate) {
+    case RF24_2MBPS:
+      return (bits + 1) / 2;
+    case RF24_1MBPS:
+      return bits;
+    default:
+      return bits * 4;
+  }
+}
+
+F3XSimAir::Transmission F3XSimAir::transmit(RF24* aSender, const uint8_t* aData, uint8_t aLen, bool aAck, uint64_t aStartUs) {
+  Transmission tx;
+  memset(&tx, 0, sizeof(tx));
+  tx.sender = aSender->getDevice() != nullptr ? aSender->getDevice()->getName() : "";
+  tx.startUs = aStartUs;
+  tx.channel = aSender->getChannel();
+  tx.len = aLen < 32 ? aLen : 32;
+  memcpy(tx.data, aData, tx.len);
+  myTransmissions++;
+  uint8_t packetId = aSender->nextPid();
+
+  rf24_datarate_e rate = aSender->getDataRate();
+  uint64_t t = aStartUs + F3X_SIM_RF24_SETTLE_US;
+  uint32_t retryDelay = myRetryDelayUs != 0 ? myRetryDelayUs : aSender->getRetryDelayUs();
+  while (true) {
+    myAttempts++;
+    t += getAirtimeUs(tx.len, rate);
+    bool received = false;
+    for (RF24* radio : myRadios) {
+      if (radio == aSender || !radio->isListening() || radio->getChannel() != tx.channel || radio->getDataRate() != rate) {
+        continue;
+      }
+      int8_t pipe = radio->matchPipe(aSender->getWritingAddress());
+      if (pipe < 0 || isLost(tx.channel)) {
+        continue;
+      }
+      if (radio->receive(pipe, tx.data, tx.len, t, aSender->getId(), packetId)) {
+        received = true;
+        if (tx.deliveredUs == 0) {
+          tx.deliveredUs = t;
+        }
+      }
+    }
+    if (!aAck) {
+      tx.ok = true;
+      break;
+    }
+    if (received && !isLost(tx.channel)) {
+      t += F3X_SIM_RF24_SETTLE_US + getAirtimeUs(0, rate);
+      tx.ok = true;
+      break;
+    }
+    // no acknowledgement within the retransmit delay
+    t += retryDelay;
+    if (tx.arc >= aSender->getRetryCount()) {
+      myFailed++;
+      break;
+    }
+    tx.arc++;
+  }
+  tx.endUs = t;
+  if (myObserver) {
+    myObserver(tx);
+  }
+  return tx;
+}
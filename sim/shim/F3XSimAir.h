@@ -0,0 +1,87 @@
+#ifndef F3XSimAir_h
+#define F3XSimAir_h
+
+#include <stdint.h>
+#include <functional>
+#include <map>
+#include <random>
+#include <vector>
+#include <RF24.h>
+
+#define F3X_SIM_RF24_SETTLE_US 130   // TX/RX settling time of the nRF24L01
+#define F3X_SIM_RF24_FIFO        3   // RX FIFO entries
+
+/**
+ * the 2.4GHz air between the simulated nRF24L01 radios. A transmission is received by all
+ * listening radios on the same channel and data rate with a reading pipe of the written address.
+ * Each packet and each acknowledgement is lost with the configured probability, a lost one is
+ * retransmitted after the retransmit delay until the retry count of the sender is reached. A
+ * receiver drops a retransmitted packet, which it got already (lost acknowledgement), like the
+ * PID check of the nRF24L01, and does not acknowledge a packet, if its RX FIFO is full.
+ * The random numbers are seeded, so each run of a test is the same.
+ */
+class F3XSimAir {
+  public:
+    typedef struct {
+      const char* sender;     // name of the sending device
+      uint64_t startUs;       // simulation time of the start, the end and the first reception
+      uint64_t endUs;
+      uint64_t deliveredUs;   // 0: not delivered
+      uint8_t channel;
+      uint8_t len;
+      uint8_t data[32];
+      uint8_t arc;            // retransmissions
+      bool ok;                // acknowledged (always, if sent without acknowledgement)
+    } Transmission;
+
+    static F3XSimAir& getInstance();
+
+    /**
+     * remove the loss and carrier settings, reset the statistics and the random numbers
+     */
+    void reset();
+    void add(RF24* aRadio);
+    void remove(RF24* aRadio);
+
+    void setLoss(double aProbability);
+    void setChannelLoss(uint8_t aChannel, double aProbability);
+    void setCarrier(uint8_t aChannel, bool aCarrier);
+    bool hasCarrier(uint8_t aChannel);
+    void setRetryDelayUs(uint32_t aUs);   // instead of the ARD of the radios, 0: ARD of the radio
+    void setSeed(uint32_t aSeed);
+    void setObserver(std::function<void(const Transmission&)> aObserver);
+
+    Transmission transmit(RF24* aSender, const uint8_t* aData, uint8_t aLen, bool aAck, uint64_t aStartUs);
+    static uint32_t getAirtimeUs(uint8_t aLen, rf24_datarate_e aRate);
+
+    uint32_t getTransmissionCount() {
+      return myTransmissions;
+    }
+    uint32_t getAttemptCount() {
+      return myAttempts;
+    }
+    uint32_t getLostCount() {
+      return myLost;
+    }
+    uint32_t getFailedCount() {
+      return myFailed;
+    }
+
+  private:
+    F3XSimAir();
+    bool isLost(uint8_t aChannel);
+
+    std::vector<RF24*> myRadios;
+    double myLoss;
+    std::map<uint8_t, double> myChannelLoss;
+    std::map<uint8_t, bool> myCarrier;
+    uint32_t myRetryDelayUs;
+    std::mt19937 myRandom;
+    std::function<void(const Transmission&)> myObserver;
+    uint32_t myTransmissions;
+    uint32_t myAttempts;
+    uint32_t myLost;
+    uint32_t myFailed;
+};
+
+#endif
@@ -0,0 +1,300 @@
+#include <Arduino.h>
+#include <stdio.h>
+#include <algorithm>
+#include "F3XSimDevice.h"
+#include "F3XSimNetwork.h"
+
+#define F3X_SIM_SERIAL_MAX 65536  // kept tail of the serial output
+
+F3XSimDevice* F3XSimDevice::ourCurrent = nullptr;
+
+F3XSimDevice::F3XSimDevice(const char* aName, Function aSetup, Function aLoop) {
+  myName = aName;
+  mySetup = aSetup;
+  myLoop = aLoop;
+  myStarted = false;
+  myLoopCount = 0;
+  myTimeUs = 0;
+  myClockOffset = 0;
+  myClockDrift = 0;
+  myLoopCost = 100;
+  for (uint8_t i=0; i<F3X_SIM_PINS; i++) {
+    myModes[i] = INPUT;
+    myOutputs[i] = LOW;
+    myInputs[i] = HIGH;
+    myAnalog[i] = 900;
+    myIsr[i] = nullptr;
+    myIsrMode[i] = 0;
+  }
+  myInterruptsEnabled = true;
+  myPendingIsr = 0;
+  memset(myEeprom, 0xff, sizeof(myEeprom));
+  memset(myRtc, 0, sizeof(myRtc));
+  myFileCostNs = 0;
+  myRestarts = 0;
+  myNetwork.reset(new F3XSimNetwork(this));
+}
+
+F3XSimDevice::~F3XSimDevice() {
+  if (ourCurrent == this) {
+    ourCurrent = nullptr;
+  }
+}
+
+F3XSimDevice* F3XSimDevice::current() {
+  static F3XSimDevice defaultDevice("default");
+  return ourCurrent != nullptr ? ourCurrent : &defaultDevice;
+}
+
+F3XSimDevice::Scope::Scope(F3XSimDevice* aDevice) {
+  myPrevious = ourCurrent;
+  ourCurrent = aDevice;
+}
+
+F3XSimDevice::Scope::~Scope() {
+  ourCurrent = myPrevious;
+}
+
+const char* F3XSimDevice::getName() {
+  return myName.c_str();
+}
+
+uint64_t F3XSimDevice::getTimeUs() {
+  return myTimeUs;
+}
+
+uint32_t F3XSimDevice::getMicros() {
+  int64_t local = (int64_t) myTimeUs + myClockOffset + (int64_t) myTimeUs * myClockDrift / 1000000;
+  return (uint32_t) local;
+}
+
+uint32_t F3XSimDevice::getMillis() {
+  int64_t local = (int64_t) myTimeUs + myClockOffset + (int64_t) myTimeUs * myClockDrift / 1000000;
+  return (uint32_t) (local / 1000);
+}
+
+void F3XSimDevice::advance(uint64_t aUs) {
+  advanceTo(myTimeUs + aUs);
+}
+
+void F3XSimDevice::advanceTo(uint64_t aTimeUs) {
+  Scope scope(this);
+  while (!myEvents.empty() && myEvents.front().timeUs <= aTimeUs) {
+    InputEvent event = myEvents.front();
+    myEvents.erase(myEvents.begin());
+    if (event.timeUs > myTimeUs) {
+      myTimeUs = event.timeUs;
+    }
+    applyInput(event.pin, event.level);
+  }
+  if (aTimeUs > myTimeUs) {
+    myTimeUs = aTimeUs;
+  }
+}
+
+void F3XSimDevice::setClockOffset(int64_t aUs) {
+  myClockOffset = aUs;
+}
+
+void F3XSimDevice::setClockDrift(int32_t aPpm) {
+  myClockDrift = aPpm;
+}
+
+void F3XSimDevice::setLoopCost(uint32_t aUs) {
+  myLoopCost = aUs;
+}
+
+uint32_t F3XSimDevice::getLoopCost() {
+  return myLoopCost;
+}
+
+void F3XSimDevice::step() {
+  Scope scope(this);
+  advanceTo(myTimeUs);
+  if (!myStarted) {
+    myStarted = true;
+    if (mySetup) {
+      mySetup();
+    }
+  } else {
+    if (myLoop) {
+      myLoop();
+    }
+    myLoopCount++;
+  }
+  advance(myLoopCost);
+}
+
+bool F3XSimDevice::isStarted() {
+  return myStarted;
+}
+
+uint32_t F3XSimDevice::getLoopCount() {
+  return myLoopCount;
+}
+
+void F3XSimDevice::setPinMode(uint8_t aPin, uint8_t aMode) {
+  if (aPin < F3X_SIM_PINS) {
+    myModes[aPin] = aMode;
+  }
+}
+
+uint8_t F3XSimDevice::getPinMode(uint8_t aPin) {
+  return aPin < F3X_SIM_PINS ? myModes[aPin] : INPUT;
+}
+
+void F3XSimDevice::writePin(uint8_t aPin, uint8_t aLevel) {
+  if (aPin >= F3X_SIM_PINS) {
+    return;
+  }
+  aLevel = aLevel ? HIGH : LOW;
+  if (myOutputs[aPin] != aLevel) {
+    myEdges[aPin].push_back({myTimeUs, aLevel});
+  }
+  myOutputs[aPin] = aLevel;
+}
+
+uint8_t F3XSimDevice::getOutput(uint8_t aPin) {
+  return aPin < F3X_SIM_PINS ? myOutputs[aPin] : LOW;
+}
+
+int F3XSimDevice::readPin(uint8_t aPin) {
+  if (aPin >= F3X_SIM_PINS) {
+    return LOW;
+  }
+  return myModes[aPin] == OUTPUT ? myOutputs[aPin] : myInputs[aPin];
+}
+
+void F3XSimDevice::setInput(uint8_t aPin, uint8_t aLevel) {
+  Scope scope(this);
+  applyInput(aPin, aLevel);
+}
+
+void F3XSimDevice::scheduleInput(uint64_t aTimeUs, uint8_t aPin, uint8_t aLevel) {
+  InputEvent event = {aTimeUs, aPin, aLevel};
+  auto pos = std::upper_bound(myEvents.begin(), myEvents.end(), event,
+    [](const InputEvent& a, const InputEvent& b) { return a.timeUs < b.timeUs; });
+  myEvents.insert(pos, event);
+}
+
+void F3XSimDevice::press(uint8_t aPin, uint64_t aTimeUs, uint32_t aDurationUs, uint8_t aActiveLevel) {
+  scheduleInput(aTimeUs, aPin, aActiveLevel);
+  scheduleInput(aTimeUs + aDurationUs, aPin, aActiveLevel ? LOW : HIGH);
+}
+
+void F3XSimDevice::setAnalog(uint8_t aPin, int aValue) {
+  if (aPin < F3X_SIM_PINS) {
+    myAnalog[aPin] = aValue;
+  }
+}
+
+int F3XSimDevice::getAnalog(uint8_t aPin) {
+  return aPin < F3X_SIM_PINS ? myAnalog[aPin] : 0;
+}
+
+const std::vector<F3XSimDevice::Edge>& F3XSimDevice::getEdges(uint8_t aPin) {
+  return myEdges[aPin < F3X_SIM_PINS ? aPin : 0];
+}
+
+void F3XSimDevice::clearEdges() {
+  for (uint8_t i=0; i<F3X_SIM_PINS; i++) {
+    myEdges[i].clear();
+  }
+}
+
+void F3XSimDevice::attachInterrupt(uint8_t aPin, void (*aIsr)(void), int aMode) {
+  if (aPin < F3X_SIM_PINS) {
+    myIsr[aPin] = aIsr;
+    myIsrMode[aPin] = aMode;
+  }
+}
+
+void F3XSimDevice::detachInterrupt(uint8_t aPin) {
+  if (aPin < F3X_SIM_PINS) {
+    myIsr[aPin] = nullptr;
+  }
+}
+
+void F3XSimDevice::setInterruptsEnabled(bool aEnabled) {
+  myInterruptsEnabled = aEnabled;
+  if (aEnabled && myPendingIsr != 0) {
+    // the edges latched while the interrupts were disabled
+    for (uint8_t i=0; i<F3X_SIM_PINS; i++) {
+      if ((myPendingIsr & (1UL << i)) && myIsr[i] != nullptr) {
+        myPendingIsr &= ~(1UL << i);
+        myIsr[i]();
+      }
+    }
+    myPendingIsr = 0;
+  }
+}
+
+void F3XSimDevice::applyInput(uint8_t aPin, uint8_t aLevel) {
+  if (aPin >= F3X_SIM_PINS) {
+    return;
+  }
+  aLevel = aLevel ? HIGH : LOW;
+  uint8_t old = myInputs[aPin];
+  myInputs[aPin] = aLevel;
+  if (old == aLevel || myIsr[aPin] == nullptr || myModes[aPin] == OUTPUT) {
+    return;
+  }
+  int mode = myIsrMode[aPin];
+  if (mode == CHANGE || (mode == FALLING && aLevel == LOW) || (mode == RISING && aLevel == HIGH)) {
+    if (myInterruptsEnabled) {
+      myIsr[aPin]();
+    } else {
+      myPendingIsr |= (1UL << aPin);
+    }
+  }
+}
+
+uint8_t* F3XSimDevice::getEeprom() {
+  return myEeprom;
+}
+
+uint32_t* F3XSimDevice::getRtcMemory() {
+  return myRtc;
+}
+
+std::map<std::string, std::string>& F3XSimDevice::getFiles() {
+  return myFiles;
+}
+
+uint32_t F3XSimDevice::getFileCostNs() {
+  return myFileCostNs;
+}
+
+void F3XSimDevice::setFileCostNs(uint32_t aNs) {
+  myFileCostNs = aNs;
+}
+
+void F3XSimDevice::writeSerial(uint8_t aChar) {
+  static const bool verbose = getenv("F3X_SIM_VERBOSE") != nullptr;
+  if (verbose) {
+    if (mySerial.empty() || mySerial.back() == '\n') {
+      printf("%10.3f %s| ", myTimeUs / 1000.0, myName.c_str());
+    }
+    putchar(aChar);
+  }
+  mySerial.push_back((char) aChar);
+  if (mySerial.size() > F3X_SIM_SERIAL_MAX) {
+    mySerial.erase(0, mySerial.size() - F3X_SIM_SERIAL_MAX / 2);
+  }
+}
+
+std::string& F3XSimDevice::getSerial() {
+  return mySerial;
+}
+
+void F3XSimDevice::restart() {
+  myRestarts++;
+}
+
+uint16_t F3XSimDevice::getRestartCount() {
+  return myRestarts;
+}
+
+F3XSimNetwork& F3XSimDevice::getNetwork() {
+  return *myNetwork;
+}
@@ -0,0 +1,152 @@
+#ifndef F3XSimDevice_h
+#define F3XSimDevice_h
+
+#include <stdint.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define F3X_SIM_PINS          32  // D0..D10 of the ESP8266 and A0..A7 of the AVR fit
+#define F3X_SIM_EEPROM_SIZE 4096
+#define F3X_SIM_RTC_WORDS    128  // 512 bytes RTC user memory of the ESP8266
+
+class F3XSimNetwork;
+
+/**
+ * one simulated microcontroller: its clock, pins, interrupts, EEPROM, RTC memory, flash file
+ * system, serial output and the pending web requests. The Arduino functions of the shim
+ * (millis(), digitalRead(), LittleFS, Serial, ...) act on the device, whose code is running, see
+ * current(). The firmware of a device is called by step(), setup() once, then loop().
+ * The time of a device only passes by its own code: delay(), blocking I/O (radio, I2C, network)
+ * and the cost of each loop() (setLoopCost()). Scheduled pin changes fire their interrupt at the
+ * exact time while the time passes, also in the middle of a delay().
+ */
+class F3XSimDevice {
+  public:
+    typedef std::function<void(void)> Function;
+
+    typedef struct {
+      uint64_t timeUs;  // simulation time of the change
+      uint8_t level;
+    } Edge;
+
+    F3XSimDevice(const char* aName, Function aSetup=nullptr, Function aLoop=nullptr);
+    ~F3XSimDevice();
+    F3XSimDevice(const F3XSimDevice&) = delete;
+    F3XSimDevice& operator=(const F3XSimDevice&) = delete;
+
+    /**
+     * the device, whose code is running, a default device (e.g. for the static initialization of
+     * the firmware) if no device is active
+     */
+    static F3XSimDevice* current();
+
+    /**
+     * makes aDevice the current device for the lifetime of the scope, e.g. to inspect its file
+     * system from a test
+     */
+    class Scope {
+      public:
+        Scope(F3XSimDevice* aDevice);
+        ~Scope();
+      private:
+        F3XSimDevice* myPrevious;
+    };
+
+    const char* getName();
+
+    // time
+    uint64_t getTimeUs();               // simulation time of the device
+    uint32_t getMicros();               // micros() of the device, including the clock offset/drift
+    uint32_t getMillis();
+    void advance(uint64_t aUs);         // time passes on the device, due pin changes are applied
+    void advanceTo(uint64_t aTimeUs);
+    void setClockOffset(int64_t aUs);   // micros() = time + offset + drift
+    void setClockDrift(int32_t aPpm);
+    void setLoopCost(uint32_t aUs);     // time of one loop(), without delay() and blocking I/O
+    uint32_t getLoopCost();
+
+    // firmware
+    void step();                        // setup() at the first call, afterwards one loop()
+    bool isStarted();
+    uint32_t getLoopCount();
+
+    // pins
+    void setPinMode(uint8_t aPin, uint8_t aMode);
+    uint8_t getPinMode(uint8_t aPin);
+    void writePin(uint8_t aPin, uint8_t aLevel);      // output of the firmware
+    uint8_t getOutput(uint8_t aPin);
+    int readPin(uint8_t aPin);                         // input of the firmware
+    void setInput(uint8_t aPin, uint8_t aLevel);       // external level of a pin, now
+    void scheduleInput(uint64_t aTimeUs, uint8_t aPin, uint8_t aLevel);
+    void press(uint8_t aPin, uint64_t aTimeUs, uint32_t aDurationUs, uint8_t aActiveLevel=0);
+    void setAnalog(uint8_t aPin, int aValue);
+    int getAnalog(uint8_t aPin);
+    const std::vector<Edge>& getEdges(uint8_t aPin);   // output level changes of a pin
+    void clearEdges();
+    void attachInterrupt(uint8_t aPin, void (*aIsr)(void), int aMode);
+    void detachInterrupt(uint8_t aPin);
+    void setInterruptsEnabled(bool aEnabled);
+
+    // memories
+    uint8_t* getEeprom();
+    uint32_t* getRtcMemory();
+    std::map<std::string, std::string>& getFiles();    // flash file system, path -> content
+    uint32_t getFileCostNs();                          // time per byte of a file access
+    void setFileCostNs(uint32_t aNs);
+
+    // serial
+    void writeSerial(uint8_t aChar);
+    std::string& getSerial();
+
+    // restarts (ESP.restart(), reset function of the AVR)
+    void restart();
+    uint16_t getRestartCount();
+
+    // WiFi and web requests
+    F3XSimNetwork& getNetwork();
+
+  private:
+    typedef struct {
+      uint64_t timeUs;
+      uint8_t pin;
+      uint8_t level;
+    } InputEvent;
+
+    void applyInput(uint8_t aPin, uint8_t aLevel);
+
+    std::string myName;
+    Function mySetup;
+    Function myLoop;
+    bool myStarted;
+    uint32_t myLoopCount;
+    uint64_t myTimeUs;
+    int64_t myClockOffset;
+    int32_t myClockDrift;
+    uint32_t myLoopCost;
+
+    uint8_t myModes[F3X_SIM_PINS];
+    uint8_t myOutputs[F3X_SIM_PINS];
+    uint8_t myInputs[F3X_SIM_PINS];
+    int myAnalog[F3X_SIM_PINS];
+    std::vector<Edge> myEdges[F3X_SIM_PINS];
+    void (*myIsr[F3X_SIM_PINS])(void);
+    int myIsrMode[F3X_SIM_PINS];
+    bool myInterruptsEnabled;
+    uint32_t myPendingIsr;              // edges while the interrupts are disabled
+    std::vector<InputEvent> myEvents;   // sorted by time
+
+    uint8_t myEeprom[F3X_SIM_EEPROM_SIZE];
+    uint32_t myRtc[F3X_SIM_RTC_WORDS];
+    std::map<std::string, std::string> myFiles;
+    uint32_t myFileCostNs;
+    std::string mySerial;
+    uint16_t myRestarts;
+    std::unique_ptr<F3XSimNetwork> myNetwork;
+
+    static F3XSimDevice* ourCurrent;
+};
+
+#endif
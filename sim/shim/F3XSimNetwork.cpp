@@ -0,0 +1,239 @@
+#include <stdlib.h>
+#include <strings.h>
+#include "F3XSimDevice.h"
+#include "F3XSimNetwork.h"
+
+#define F3X_SIM_TCP_WINDOW 2920  // two TCP segments of lwIP on the ESP8266
+#define F3X_SIM_NET_RATE    200  // bytes per ms, a loaded 2.4GHz WLAN
+
+int F3XSimHttpResponse::getStatus() const {
+  size_t space = wire.find(' ');
+  return space == std::string::npos ? 0 : atoi(wire.c_str() + space + 1);
+}
+
+std::string F3XSimHttpResponse::getHeader(const std::string& aName) const {
+  size_t end = wire.find("\r\n\r\n");
+  size_t pos = wire.find("\r\n");
+  while (pos != std::string::npos && pos < end) {
+    size_t next = wire.find("\r\n", pos + 2);
+    std::string line = wire.substr(pos + 2, next - pos - 2);
+    size_t colon = line.find(':');
+    if (colon != std::string::npos && strcasecmp(line.substr(0, colon).c_str(), aName.c_str()) == 0) {
+      size_t start = line.find_first_not_of(' ', colon + 1);
+      return start == std::string::npos ? "" : line.substr(start);
+    }
+    pos = next;
+  }
+  return "";
+}
+
+std::string F3XSimHttpResponse::getBody() const {
+  size_t end = wire.find("\r\n\r\n");
+  if (end == std::string::npos) {
+    return "";
+  }
+  std::string body = wire.substr(end + 4);
+  if (getHeader("Transfer-Encoding") != "chunked") {
+    return body;
+  }
+  std::string decoded;
+  size_t pos = 0;
+  while (pos < body.size()) {
+    size_t eol = body.find("\r\n", pos);
+    if (eol == std::string::npos) {
+      break;
+    }
+    size_t len = strtoul(body.substr(pos, eol - pos).c_str(), nullptr, 16);
+    if (len == 0) {
+      break;
+    }
+    decoded += body.substr(eol + 2, len);
+    pos = eol + 2 + len + 2;
+  }
+  return decoded;
+}
+
+F3XSimConnection::F3XSimConnection(F3XSimDevice* aDevice, F3XSimHttpResponsePtr aResponse) {
+  myDevice = aDevice;
+  myResponse = aResponse;
+  myQueued = 0;
+  myDrainUs = aDevice->getTimeUs();
+  myStopped = false;
+}
+
+F3XSimConnection::~F3XSimConnection() {
+  finish();
+}
+
+void F3XSimConnection::drain() {
+  uint64_t now = myDevice->getTimeUs();
+  uint64_t drained = (now - myDrainUs) * myDevice->getNetwork().getRate() / 1000;
+  if (drained > 0) {
+    myQueued = drained >= myQueued ? 0 : myQueued - drained;
+    myDrainUs = now;
+  }
+}
+
+size_t F3XSimConnection::write(const uint8_t* aBuffer, size_t aSize) {
+  if (!connected()) {
+    return 0;
+  }
+  F3XSimNetwork& network = myDevice->getNetwork();
+  size_t done = 0;
+  while (done < aSize) {
+    drain();
+    uint32_t space = network.getWindow() - myQueued;
+    if (space == 0) {
+      // blocked until the next segment is acknowledged
+      uint32_t segment = network.getWindow() / 2;
+      myDevice->advance((uint64_t) segment * 1000 / network.getRate() + 1);
+      continue;
+    }
+    size_t n = aSize - done < space ? aSize - done : space;
+    if (myResponse->wire.empty()) {
+      myResponse->firstByteUs = myDevice->getTimeUs();
+    }
+    myResponse->wire.append((const char*) aBuffer + done, n);
+    myQueued += n;
+    done += n;
+  }
+  myResponse->writes++;
+  return done;
+}
+
+int F3XSimConnection::availableForWrite() {
+  if (!connected()) {
+    return 0;
+  }
+  drain();
+  return myDevice->getNetwork().getWindow() - myQueued;
+}
+
+bool F3XSimConnection::connected() {
+  return !myStopped && !myResponse->disconnected;
+}
+
+void F3XSimConnection::stop() {
+  finish();
+  myStopped = true;
+}
+
+F3XSimHttpResponsePtr F3XSimConnection::getResponse() {
+  return myResponse;
+}
+
+void F3XSimConnection::finish() {
+  if (myStopped || myResponse->complete) {
+    return;
+  }
+  // the response is received, when the send window is drained
+  drain();
+  myResponse->complete = true;
+  myResponse->completeUs = myDevice->getTimeUs() + (uint64_t) myQueued * 1000 / myDevice->getNetwork().getRate();
+}
+
+F3XSimNetwork::F3XSimNetwork(F3XSimDevice* aDevice) {
+  myDevice = aDevice;
+  myStationAvailable = true;
+  myConnected = false;
+  myWindow = F3X_SIM_TCP_WINDOW;
+  myRate = F3X_SIM_NET_RATE;
+}
+
+F3XSimHttpResponsePtr F3XSimNetwork::request(const char* aMethod, const std::string& aUri, const std::string& aBody,
+    const std::map<std::string, std::string>& aHeaders) {
+  Request request;
+  request.method = aMethod;
+  size_t query = aUri.find('?');
+  request.path = aUri.substr(0, query);
+  if (query != std::string::npos) {
+    parseArgs(aUri.substr(query + 1), &request.args);
+  }
+  request.headers = aHeaders;
+  request.body = aBody;
+  if (!aBody.empty()) {
+    auto type = aHeaders.find("Content-Type");
+    if (type != aHeaders.end() && type->second == "application/x-www-form-urlencoded") {
+      parseArgs(aBody, &request.args);
+    } else {
+      request.args.push_back({"plain", aBody});
+    }
+  }
+  request.response = std::make_shared<F3XSimHttpResponse>();
+  request.response->requestUs = myDevice->getTimeUs();
+  myRequests.push_back(request);
+  return request.response;
+}
+
+bool F3XSimNetwork::hasRequest() {
+  return !myRequests.empty();
+}
+
+F3XSimNetwork::Request F3XSimNetwork::popRequest() {
+  Request request = myRequests.front();
+  myRequests.pop_front();
+  return request;
+}
+
+void F3XSimNetwork::setStationAvailable(bool aAvailable) {
+  myStationAvailable = aAvailable;
+}
+
+bool F3XSimNetwork::isStationAvailable() {
+  return myStationAvailable;
+}
+
+void F3XSimNetwork::setConnected(bool aConnected) {
+  myConnected = aConnected;
+}
+
+bool F3XSimNetwork::isConnected() {
+  return myConnected;
+}
+
+void F3XSimNetwork::setWindow(uint32_t aBytes) {
+  myWindow = aBytes;
+}
+
+uint32_t F3XSimNetwork::getWindow() {
+  return myWindow;
+}
+
+void F3XSimNetwork::setRate(uint32_t aBytesPerMs) {
+  myRate = aBytesPerMs > 0 ? aBytesPerMs : 1;
+}
+
+uint32_t F3XSimNetwork::getRate() {
+  return myRate;
+}
+
+std::string F3XSimNetwork::urlDecode(const std::string& aStr) {
+  std::string result;
+  for (size_t i=0; i<aStr.size(); i++) {
+    if (aStr[i] == '+') {
+      result += ' ';
+    } else if (aStr[i] == '%' && i + 2 < aStr.size()) {
+      result += (char) strtol(aStr.substr(i + 1, 2).c_str(), nullptr, 16);
+      i += 2;
+    } else {
+      result += aStr[i];
+    }
+  }
+  return result;
+}
+
+void F3XSimNetwork::parseArgs(const std::string& aQuery, std::vector<std::pair<std::string, std::string>>* aArgs) {
+  size_t pos = 0;
+  while (pos <= aQuery.size()) {
+    size_t amp = aQuery.find('&', pos);
+    std::string arg = aQuery.substr(pos, amp == std::string::npos ? std::string::npos : amp - pos);
+    if (!arg.empty()) {
+      size_t eq = arg.find('=');
+      aArgs->push_back({urlDecode(arg.substr(0, eq)), eq == std::string::npos ? "" : urlDecode(arg.substr(eq + 1))});
+    }
+    if (amp == std::string::npos) {
+      break;
+    }
+    pos = amp + 1;
+  }
+}
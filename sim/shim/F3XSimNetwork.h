@@ -0,0 +1,115 @@
+#ifndef F3XSimNetwork_h
+#define F3XSimNetwork_h
+
+#include <stdint.h>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+class F3XSimDevice;
+
+/**
+ * the bytes a web request got from the server, filled while the firmware writes them
+ */
+class F3XSimHttpResponse {
+  public:
+    std::string wire;         // status line, headers and body as sent
+    bool handled = false;     // the request was dispatched by handleClient()
+    bool complete = false;    // the server closed or released the connection
+    bool disconnected = false;// the client closed the connection (e.g. an event stream)
+    uint64_t requestUs = 0;   // device time of the request, its dispatch, the first byte and the end
+    uint64_t handledUs = 0;
+    uint64_t firstByteUs = 0;
+    uint64_t completeUs = 0;
+    uint32_t writes = 0;      // calls of write(), each a segment on the network
+
+    int getStatus() const;
+    std::string getHeader(const std::string& aName) const;
+    std::string getBody() const;      // without headers, a chunked body is decoded
+    void disconnect() {
+      disconnected = true;
+    }
+};
+
+typedef std::shared_ptr<F3XSimHttpResponse> F3XSimHttpResponsePtr;
+
+/**
+ * the server side of a TCP connection of a web request. A write blocks the device, while the send
+ * window is full, the window drains with the rate of the network. The response is complete, when
+ * the last WiFiClient of the connection is released or stopped.
+ */
+class F3XSimConnection {
+  public:
+    F3XSimConnection(F3XSimDevice* aDevice, F3XSimHttpResponsePtr aResponse);
+    ~F3XSimConnection();
+    size_t write(const uint8_t* aBuffer, size_t aSize);
+    int availableForWrite();
+    bool connected();
+    void stop();
+    F3XSimHttpResponsePtr getResponse();
+
+  private:
+    void drain();
+    void finish();
+
+    F3XSimDevice* myDevice;
+    F3XSimHttpResponsePtr myResponse;
+    uint32_t myQueued;        // bytes in the send window
+    uint64_t myDrainUs;       // device time of the last drain
+    bool myStopped;
+};
+
+/**
+ * WiFi and web clients of a simulated device: the station is connected at WiFi.begin(), if the
+ * access point is available. Web requests are queued by the test and dispatched one per
+ * handleClient() by the ESP8266WebServer of the firmware.
+ */
+class F3XSimNetwork {
+  public:
+    typedef struct {
+      std::string method;     // "GET" or "POST"
+      std::string path;
+      std::vector<std::pair<std::string, std::string>> args;
+      std::map<std::string, std::string> headers;
+      std::string body;
+      F3XSimHttpResponsePtr response;
+    } Request;
+
+    F3XSimNetwork(F3XSimDevice* aDevice);
+
+    /**
+     * queue a request, aUri may contain a query, a POST body of type
+     * application/x-www-form-urlencoded is decoded into the arguments, other bodies are the
+     * argument "plain"
+     */
+    F3XSimHttpResponsePtr request(const char* aMethod, const std::string& aUri, const std::string& aBody="",
+      const std::map<std::string, std::string>& aHeaders={});
+    bool hasRequest();
+    Request popRequest();
+
+    void setStationAvailable(bool aAvailable);
+    bool isStationAvailable();
+    void setConnected(bool aConnected);
+    bool isConnected();
+    void setWindow(uint32_t aBytes);
+    uint32_t getWindow();
+    void setRate(uint32_t aBytesPerMs);
+    uint32_t getRate();
+
+    static std::string urlDecode(const std::string& aStr);
+
+  private:
+    static void parseArgs(const std::string& aQuery, std::vector<std::pair<std::string, std::string>>* aArgs);
+
+    F3XSimDevice* myDevice;
+    std::deque<Request> myRequests;
+    bool myStationAvailable;
+    bool myConnected;
+    uint32_t myWindow;
+    uint32_t myRate;
+};
+
+#endif
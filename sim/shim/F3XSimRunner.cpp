@@ -0,0 +1,43 @@
+#include "F3XSimRunner.h"
+
+void F3XSimRunner::add(F3XSimDevice* aDevice) {
+  myDevices.push_back(aDevice);
+}
+
+F3XSimDevice* F3XSimRunner::next() {
+  F3XSimDevice* next = nullptr;
+  for (F3XSimDevice* device : myDevices) {
+    if (next == nullptr || device->getTimeUs() < next->getTimeUs()) {
+      next = device;
+    }
+  }
+  return next;
+}
+
+uint64_t F3XSimRunner::getTimeUs() {
+  F3XSimDevice* device = next();
+  return device == nullptr ? 0 : device->getTimeUs();
+}
+
+void F3XSimRunner::runUntil(uint64_t aTimeUs) {
+  F3XSimDevice* device;
+  while ((device = next()) != nullptr && device->getTimeUs() < aTimeUs) {
+    device->step();
+  }
+}
+
+void F3XSimRunner::runFor(uint64_t aUs) {
+  runUntil(getTimeUs() + aUs);
+}
+
+bool F3XSimRunner::runUntil(std::function<bool(void)> aCondition, uint64_t aTimeoutUs) {
+  F3XSimDevice* device;
+  while (!aCondition()) {
+    device = next();
+    if (device == nullptr || device->getTimeUs() >= aTimeoutUs) {
+      return false;
+    }
+    device->step();
+  }
+  return true;
+}
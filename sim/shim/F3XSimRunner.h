@@ -0,0 +1,41 @@
+#ifndef F3XSimRunner_h
+#define F3XSimRunner_h
+
+#include <stdint.h>
+#include <functional>
+#include <vector>
+#include "F3XSimDevice.h"
+
+/**
+ * runs the firmware of several simulated devices in the order of their time: the device with the
+ * smallest time runs its next loop(), so the devices see the radio frames of each other in the
+ * right order, as far as a loop() is not longer than the time between two frames.
+ */
+class F3XSimRunner {
+  public:
+    void add(F3XSimDevice* aDevice);
+
+    /**
+     * the time of the device, which is behind the others
+     */
+    uint64_t getTimeUs();
+
+    /**
+     * run all devices until each reached aTimeUs
+     */
+    void runUntil(uint64_t aTimeUs);
+    void runFor(uint64_t aUs);
+
+    /**
+     * run until aCondition is true (checked after each loop()), at most until aTimeoutUs,
+     * returns true, if the condition was met
+     */
+    bool runUntil(std::function<bool(void)> aCondition, uint64_t aTimeoutUs);
+
+  private:
+    F3XSimDevice* next();
+
+    std::vector<F3XSimDevice*> myDevices;
+};
+
+#endif
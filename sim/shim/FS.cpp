@@ -0,0 +1,180 @@
+#include "FS.h"
+#include "F3XSimDevice.h"
+
+FS LittleFS;
+
+File::File(F3XSimDevice* aDevice, const char* aPath, bool aWrite, bool aAppend, size_t aPosition) {
+  myHandle = std::make_shared<Handle>(Handle{aDevice, aPath, aWrite, aAppend, true, aPosition, 0});
+}
+
+std::string* File::getContent() const {
+  if (!myHandle || !myHandle->open) {
+    return nullptr;
+  }
+  auto& files = myHandle->device->getFiles();
+  auto it = files.find(myHandle->path);
+  return it == files.end() ? nullptr : &it->second;
+}
+
+void File::charge(size_t aBytes) {
+  myHandle->costNs += aBytes * myHandle->device->getFileCostNs();
+  if (myHandle->costNs >= 1000) {
+    myHandle->device->advance(myHandle->costNs / 1000);
+    myHandle->costNs %= 1000;
+  }
+}
+
+size_t File::write(uint8_t aChar) {
+  return write(&aChar, 1);
+}
+
+size_t File::write(const uint8_t* aBuffer, size_t aSize) {
+  std::string* content = getContent();
+  if (content == nullptr || !myHandle->write) {
+    return 0;
+  }
+  if (myHandle->append) {
+    myHandle->pos = content->size();
+  }
+  if (myHandle->pos > content->size()) {
+    content->resize(myHandle->pos);
+  }
+  content->replace(myHandle->pos, aSize < content->size() - myHandle->pos ? aSize : content->size() - myHandle->pos,
+    (const char*) aBuffer, aSize);
+  myHandle->pos += aSize;
+  charge(aSize);
+  return aSize;
+}
+
+int File::available() {
+  std::string* content = getContent();
+  if (content == nullptr || myHandle->pos >= content->size()) {
+    return 0;
+  }
+  return content->size() - myHandle->pos;
+}
+
+int File::read() {
+  uint8_t c;
+  return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::peek() {
+  std::string* content = getContent();
+  if (content == nullptr || myHandle->pos >= content->size()) {
+    return -1;
+  }
+  return (uint8_t) (*content)[myHandle->pos];
+}
+
+size_t File::read(uint8_t* aBuffer, size_t aSize) {
+  size_t n = available();
+  n = n < aSize ? n : aSize;
+  if (n > 0) {
+    memcpy(aBuffer, getContent()->data() + myHandle->pos, n);
+    myHandle->pos += n;
+    charge(n);
+  }
+  return n;
+}
+
+bool File::seek(uint32_t aPos, SeekMode aMode) {
+  std::string* content = getContent();
+  if (content == nullptr) {
+    return false;
+  }
+  size_t pos = aMode == SeekSet ? aPos : aMode == SeekCur ? myHandle->pos + aPos : content->size() + aPos;
+  if (pos > content->size()) {
+    return false;
+  }
+  myHandle->pos = pos;
+  return true;
+}
+
+size_t File::position() const {
+  return myHandle ? myHandle->pos : 0;
+}
+
+size_t File::size() const {
+  std::string* content = getContent();
+  return content == nullptr ? 0 : content->size();
+}
+
+bool File::truncate(uint32_t aSize) {
+  std::string* content = getContent();
+  if (content == nullptr || !myHandle->write || aSize > content->size()) {
+    return false;
+  }
+  content->resize(aSize);
+  if (myHandle->pos > aSize) {
+    myHandle->pos = aSize;
+  }
+  return true;
+}
+
+const char* File::name() const {
+  if (!myHandle) {
+    return "";
+  }
+  size_t slash = myHandle->path.rfind('/');
+  return myHandle->path.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+}
+
+void File::close() {
+  if (myHandle) {
+    myHandle->open = false;
+  }
+}
+
+File::operator bool() const {
+  return getContent() != nullptr;
+}
+
+bool FS::begin() {
+  return true;
+}
+
+bool FS::format() {
+  F3XSimDevice::current()->getFiles().clear();
+  return true;
+}
+
+File FS::open(const char* aPath, const char* aMode) {
+  F3XSimDevice* device = F3XSimDevice::current();
+  auto& files = device->getFiles();
+  bool exists = files.count(aPath) != 0;
+  bool plus = strchr(aMode, '+') != nullptr;
+  switch (aMode[0]) {
+    case 'r':
+      if (!exists) {
+        return File();
+      }
+      return File(device, aPath, plus, false, 0);
+    case 'w':
+      files[aPath].clear();
+      return File(device, aPath, true, false, 0);
+    case 'a':
+      return File(device, aPath, true, true, files[aPath].size());
+  }
+  return File();
+}
+
+bool FS::exists(const char* aPath) {
+  return F3XSimDevice::current()->getFiles().count(aPath) != 0;
+}
+
+bool FS::remove(const char* aPath) {
+  return F3XSimDevice::current()->getFiles().erase(aPath) != 0;
+}
+
+bool FS::rename(const char* aFrom, const char* aTo) {
+  auto& files = F3XSimDevice::current()->getFiles();
+  auto it = files.find(aFrom);
+  if (it == files.end()) {
+    return false;
+  }
+  std::string content = it->second;
+  files.erase(it);
+  files[aTo] = content;
+  return true;
+}
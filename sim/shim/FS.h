@@ -0,0 +1,79 @@
+#ifndef FS_h
+#define FS_h
+
+#include <Arduino.h>
+#include <memory>
+
+class F3XSimDevice;
+
+enum SeekMode {
+  SeekSet = 0,
+  SeekCur = 1,
+  SeekEnd = 2
+};
+
+/**
+ * an open file of the in-memory file system of the simulated device. Copies share the position
+ * like the handles of the ESP8266 core. Each transferred byte costs F3XSimDevice::getFileCostNs()
+ * of device time.
+ */
+class File : public Stream {
+  public:
+    File() {}
+    File(F3XSimDevice* aDevice, const char* aPath, bool aWrite, bool aAppend, size_t aPosition);
+
+    size_t write(uint8_t aChar) override;
+    size_t write(const uint8_t* aBuffer, size_t aSize) override;
+    using Print::write;
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t read(uint8_t* aBuffer, size_t aSize);
+    bool seek(uint32_t aPos, SeekMode aMode=SeekSet);
+    size_t position() const;
+    size_t size() const;
+    bool truncate(uint32_t aSize);
+    const char* name() const;
+    void close();
+    operator bool() const;
+
+  private:
+    struct Handle {
+      F3XSimDevice* device;
+      std::string path;
+      bool write;
+      bool append;
+      bool open;
+      size_t pos;
+      uint32_t costNs;    // not yet charged device time
+    };
+    std::string* getContent() const;
+    void charge(size_t aBytes);
+
+    std::shared_ptr<Handle> myHandle;
+};
+
+class FS {
+  public:
+    bool begin();
+    void end() {}
+    bool format();
+    File open(const char* aPath, const char* aMode);
+    File open(const String& aPath, const char* aMode) {
+      return open(aPath.c_str(), aMode);
+    }
+    bool exists(const char* aPath);
+    bool exists(const String& aPath) {
+      return exists(aPath.c_str());
+    }
+    bool remove(const char* aPath);
+    bool remove(const String& aPath) {
+      return remove(aPath.c_str());
+    }
+    bool rename(const char* aFrom, const char* aTo);
+    bool rename(const String& aFrom, const String& aTo) {
+      return rename(aFrom.c_str(), aTo.c_str());
+    }
+};
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef LittleFS_h
+#define LittleFS_h
+
+#include "FS.h"
+
+extern FS LittleFS;
+
+#endif
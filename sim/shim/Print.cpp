@@ -0,0 +1,124 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include "Print.h"
+#include "Stream.h"
+
+size_t Print::write(const uint8_t* aBuffer, size_t aSize) {
+  size_t n = 0;
+  while (n < aSize && write(aBuffer[n])) {
+    n++;
+  }
+  return n;
+}
+
+size_t Print::write(const char* aStr) {
+  return aStr == nullptr ? 0 : write((const uint8_t*) aStr, strlen(aStr));
+}
+
+size_t Print::print(const __FlashStringHelper* aStr) {
+  return write((const char*) aStr);
+}
+
+size_t Print::print(const String& aStr) {
+  return write((const uint8_t*) aStr.c_str(), aStr.length());
+}
+
+size_t Print::print(const char* aStr) {
+  return write(aStr);
+}
+
+size_t Print::print(char aChar) {
+  return write((uint8_t) aChar);
+}
+
+size_t Print::print(unsigned char aValue, int aBase) {
+  return print(String(aValue, (unsigned char) aBase));
+}
+
+size_t Print::print(int aValue, int aBase) {
+  return print(String(aValue, (unsigned char) aBase));
+}
+
+size_t Print::print(unsigned int aValue, int aBase) {
+  return print(String(aValue, (unsigned char) aBase));
+}
+
+size_t Print::print(long aValue, int aBase) {
+  return print(String(aValue, (unsigned char) aBase));
+}
+
+size_t Print::print(unsigned long aValue, int aBase) {
+  return print(String(aValue, (unsigned char) aBase));
+}
+
+size_t Print::print(long long aValue, int aBase) {
+  return print(String(aValue, (unsigned char) aBase));
+}
+
+size_t Print::print(unsigned long long aValue, int aBase) {
+  return print(String(aValue, (unsigned char) aBase));
+}
+
+size_t Print::print(double aValue, int aDecimals) {
+  return print(String(aValue, (unsigned char) aDecimals));
+}
+
+size_t Print::println() {
+  return write((const uint8_t*) "\r\n", 2);
+}
+
+static size_t printVa(Print* aOut, const char* aFormat, va_list aArgs) {
+  char buf[256];
+  int len = vsnprintf(buf, sizeof(buf), aFormat, aArgs);
+  if (len < 0) {
+    return 0;
+  }
+  return aOut->write((const uint8_t*) buf, (size_t) len < sizeof(buf) ? len : sizeof(buf) - 1);
+}
+
+size_t Print::printf(const char* aFormat, ...) {
+  va_list args;
+  va_start(args, aFormat);
+  size_t n = printVa(this, aFormat, args);
+  va_end(args);
+  return n;
+}
+
+size_t Print::printf_P(const char* aFormat, ...) {
+  va_list args;
+  va_start(args, aFormat);
+  size_t n = printVa(this, aFormat, args);
+  va_end(args);
+  return n;
+}
+
+size_t Stream::readBytes(char* aBuffer, size_t aSize) {
+  size_t n = 0;
+  while (n < aSize) {
+    int c = read();
+    if (c < 0) {
+      break;
+    }
+    aBuffer[n++] = (char) c;
+  }
+  return n;
+}
+
+String Stream::readString() {
+  String result;
+  int c;
+  while ((c = read()) >= 0) {
+    result.concat((char) c);
+  }
+  return result;
+}
+
+String Stream::readStringUntil(char aTerminator) {
+  String result;
+  int c;
+  while ((c = read()) >= 0 && c != aTerminator) {
+    result.concat((char) c);
+  }
+  return result;
+}
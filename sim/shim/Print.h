@@ -0,0 +1,56 @@
+#ifndef Print_h
+#define Print_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include "WString.h"
+
+#define DEC 10
+#define HEX 16
+#define BIN  2
+
+/**
+ * formatted output of the Arduino core, a subclass writes the single bytes
+ */
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t aChar) = 0;
+    virtual size_t write(const uint8_t* aBuffer, size_t aSize);
+    size_t write(const char* aStr);
+    size_t write(const char* aBuffer, size_t aSize) {
+      return write((const uint8_t*) aBuffer, aSize);
+    }
+    virtual int availableForWrite() {
+      return 0;
+    }
+
+    size_t print(const __FlashStringHelper* aStr);
+    size_t print(const String& aStr);
+    size_t print(const char* aStr);
+    size_t print(char aChar);
+    size_t print(unsigned char aValue, int aBase=DEC);
+    size_t print(int aValue, int aBase=DEC);
+    size_t print(unsigned int aValue, int aBase=DEC);
+    size_t print(long aValue, int aBase=DEC);
+    size_t print(unsigned long aValue, int aBase=DEC);
+    size_t print(long long aValue, int aBase=DEC);
+    size_t print(unsigned long long aValue, int aBase=DEC);
+    size_t print(double aValue, int aDecimals=2);
+
+    size_t println();
+    template<class T> size_t println(T aValue) {
+      size_t n = print(aValue);
+      return n + println();
+    }
+    template<class T> size_t println(T aValue, int aFormat) {
+      size_t n = print(aValue, aFormat);
+      return n + println();
+    }
+
+    size_t printf(const char* aFormat, ...) __attribute__((format(printf, 2, 3)));
+    size_t printf_P(const char* aFormat, ...) __attribute__((format(printf, 2, 3)));
+    virtual void flush() {}
+};
+
+#endif
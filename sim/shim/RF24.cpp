@@ -0,0 +1,187 @@
+#include <RF24.h>
+#include "F3XSimAir.h"
+#include "F3XSimDevice.h"
+
+static uint32_t ourNextId = 1;
+
+RF24::RF24(uint16_t aCePin, uint16_t aCsnPin) {
+  myDevice = nullptr;
+  myId = ourNextId++;
+  myChannel = 76;
+  myRate = RF24_1MBPS;
+  myPaLevel = RF24_PA_MAX;
+  myAutoAck = true;
+  myRetryCount = 15;
+  myRetryDelayUs = 1500;
+  myAddressWidth = 5;
+  memset(myReadingAddress, 0, sizeof(myReadingAddress));
+  myReadingPipes = 0;
+  memset(myWritingAddress, 0, sizeof(myWritingAddress));
+  myListening = false;
+  myArc = 0;
+  myPid = 0;
+  memset(myLastSender, 0, sizeof(myLastSender));
+  memset(myLastPid, 0, sizeof(myLastPid));
+  memset(myLastLen, 0, sizeof(myLastLen));
+  myTxPending = false;
+  myTxOk = false;
+  myTxEndUs = 0;
+}
+
+RF24::~RF24() {
+  F3XSimAir::getInstance().remove(this);
+}
+
+bool RF24::begin() {
+  // the radio belongs to the device, which initializes it
+  myDevice = F3XSimDevice::current();
+  F3XSimAir::getInstance().add(this);
+  return true;
+}
+
+bool RF24::setDataRate(rf24_datarate_e aRate) {
+  myRate = aRate;
+  return true;
+}
+
+void RF24::setPALevel(uint8_t aLevel, bool aLnaEnable) {
+  myPaLevel = aLevel > (uint8_t) RF24_PA_MAX ? (uint8_t) RF24_PA_MAX : aLevel;
+}
+
+void RF24::setChannel(uint8_t aChannel) {
+  myChannel = aChannel > 125 ? 125 : aChannel;
+}
+
+void RF24::setRetries(uint8_t aDelay, uint8_t aCount) {
+  myRetryDelayUs = 250 + (aDelay & 0x0f) * 250;
+  myRetryCount = aCount & 0x0f;
+}
+
+void RF24::openReadingPipe(uint8_t aPipe, const uint8_t* aAddress) {
+  if (aPipe < 6) {
+    memcpy(myReadingAddress[aPipe], aAddress, 5);
+    myReadingPipes |= (1 << aPipe);
+  }
+}
+
+void RF24::openWritingPipe(const uint8_t* aAddress) {
+  memcpy(myWritingAddress, aAddress, 5);
+}
+
+void RF24::startListening() {
+  myListening = true;
+}
+
+void RF24::stopListening() {
+  myListening = false;
+}
+
+int8_t RF24::matchPipe(const uint8_t* aAddress) {
+  for (uint8_t pipe=0; pipe<6; pipe++) {
+    if ((myReadingPipes & (1 << pipe)) && memcmp(myReadingAddress[pipe], aAddress, myAddressWidth) == 0) {
+      return pipe;
+    }
+  }
+  return -1;
+}
+
+bool RF24::receive(uint8_t aPipe, const uint8_t* aData, uint8_t aLen, uint64_t aArrivalUs, uint32_t aSenderId, uint8_t aPid) {
+  if (myLastSender[aPipe] == aSenderId && myLastPid[aPipe] == aPid && myLastLen[aPipe] == aLen
+      && memcmp(myLastData[aPipe], aData, aLen) == 0) {
+    // retransmission of a received packet, whose acknowledgement was lost
+    return true;
+  }
+  if (myRxFifo.size() >= F3X_SIM_RF24_FIFO) {
+    return false;
+  }
+  Payload payload;
+  payload.pipe = aPipe;
+  payload.len = aLen;
+  memcpy(payload.data, aData, aLen);
+  payload.arrivalUs = aArrivalUs;
+  myRxFifo.push_back(payload);
+  myLastSender[aPipe] = aSenderId;
+  myLastPid[aPipe] = aPid;
+  myLastLen[aPipe] = aLen;
+  memcpy(myLastData[aPipe], aData, aLen);
+  return true;
+}
+
+bool RF24::transmit(const void* aBuffer, uint8_t aLen, bool aMulticast, uint64_t* aEndUs) {
+  if (myDevice == nullptr) {
+    return false;
+  }
+  F3XSimAir::Transmission tx = F3XSimAir::getInstance().transmit(this, (const uint8_t*) aBuffer, aLen,
+    myAutoAck && !aMulticast, myDevice->getTimeUs());
+  myArc = tx.arc;
+  *aEndUs = tx.endUs;
+  return tx.ok;
+}
+
+bool RF24::write(const void* aBuffer, uint8_t aLen) {
+  return write(aBuffer, aLen, false);
+}
+
+bool RF24::write(const void* aBuffer, uint8_t aLen, bool aMulticast) {
+  uint64_t end;
+  bool ok = transmit(aBuffer, aLen, aMulticast, &end);
+  if (myDevice != nullptr) {
+    myDevice->advanceTo(end);
+  }
+  return ok;
+}
+
+void RF24::startWrite(const void* aBuffer, uint8_t aLen, const bool aMulticast) {
+  myTxOk = transmit(aBuffer, aLen, aMulticast, &myTxEndUs);
+  myTxPending = true;
+}
+
+void RF24::whatHappened(bool& aTxOk, bool& aTxFail, bool& aRxReady) {
+  aTxOk = false;
+  aTxFail = false;
+  if (myTxPending && myDevice != nullptr && myDevice->getTimeUs() >= myTxEndUs) {
+    aTxOk = myTxOk;
+    aTxFail = !myTxOk;
+    myTxPending = false;
+  }
+  aRxReady = available();
+}
+
+void RF24::flush_tx() {
+  myTxPending = false;
+}
+
+void RF24::flush_rx() {
+  myRxFifo.clear();
+}
+
+bool RF24::available() {
+  return available(nullptr);
+}
+
+bool RF24::available(uint8_t* aPipe) {
+  if (myRxFifo.empty() || myDevice == nullptr || myRxFifo.front().arrivalUs > myDevice->getTimeUs()) {
+    return false;
+  }
+  if (aPipe != nullptr) {
+    *aPipe = myRxFifo.front().pipe;
+  }
+  return true;
+}
+
+uint8_t RF24::getDynamicPayloadSize() {
+  return myRxFifo.empty() ? 0 : myRxFifo.front().len;
+}
+
+void RF24::read(void* aBuffer, uint8_t aLen) {
+  if (myRxFifo.empty()) {
+    return;
+  }
+  Payload& payload = myRxFifo.front();
+  memcpy(aBuffer, payload.data, aLen < payload.len ? aLen : payload.len);
+  myRxFifo.pop_front();
+}
+
+bool RF24::testRPD() {
+  return F3XSimAir::getInstance().hasCarrier(myChannel);
+}
@@ -0,0 +1,157 @@
+#ifndef RF24_h
+#define RF24_h
+
+#include <Arduino.h>
+#include <deque>
+
+class F3XSimDevice;
+
+typedef enum {
+  RF24_PA_MIN = 0,
+  RF24_PA_LOW,
+  RF24_PA_HIGH,
+  RF24_PA_MAX,
+  RF24_PA_ERROR
+} rf24_pa_dbm_e;
+
+typedef enum {
+  RF24_1MBPS = 0,
+  RF24_2MBPS,
+  RF24_250KBPS
+} rf24_datarate_e;
+
+/**
+ * nRF24L01 driver of the RF24 library, the radio is a node of the simulated air (F3XSimAir),
+ * bound to the device, which calls begin(). Transmissions take the time of the air, the auto
+ * acknowledgement and the auto retransmissions: write() blocks the device for this time,
+ * startWrite() signals the result by whatHappened(), when the device time reached its end.
+ */
+class RF24 {
+  public:
+    typedef struct {
+      uint8_t pipe;
+      uint8_t len;
+      uint8_t data[32];
+      uint64_t arrivalUs;   // simulation time of the end of the reception
+    } Payload;
+
+    RF24(uint16_t aCePin, uint16_t aCsnPin);
+    ~RF24();
+
+    bool begin();
+    bool isPVariant() {
+      return true;
+    }
+    bool isChipConnected() {
+      return true;
+    }
+    void powerUp() {}
+    void powerDown() {}
+    bool setDataRate(rf24_datarate_e aRate);
+    rf24_datarate_e getDataRate() {
+      return myRate;
+    }
+    void setPALevel(uint8_t aLevel, bool aLnaEnable=true);
+    uint8_t getPALevel() {
+      return myPaLevel;
+    }
+    void setChannel(uint8_t aChannel);
+    uint8_t getChannel() {
+      return myChannel;
+    }
+    void setRetries(uint8_t aDelay, uint8_t aCount);
+    void setAutoAck(bool aEnable) {
+      myAutoAck = aEnable;
+    }
+    void enableDynamicPayloads() {}
+    void enableDynamicAck() {}
+    void setPayloadSize(uint8_t aSize) {}
+    void setAddressWidth(uint8_t aWidth) {
+      myAddressWidth = aWidth;
+    }
+    void openReadingPipe(uint8_t aPipe, const uint8_t* aAddress);
+    void openWritingPipe(const uint8_t* aAddress);
+    void startListening();
+    void stopListening();
+    void maskIRQ(bool aTxOk, bool aTxFail, bool aRxReady) {}
+
+    bool write(const void* aBuffer, uint8_t aLen);
+    bool write(const void* aBuffer, uint8_t aLen, bool aMulticast);
+    void startWrite(const void* aBuffer, uint8_t aLen, const bool aMulticast);
+    bool txStandBy() {
+      return true;
+    }
+    void whatHappened(bool& aTxOk, bool& aTxFail, bool& aRxReady);
+    uint8_t getARC() {
+      return myArc;
+    }
+    void flush_tx();
+    void flush_rx();
+
+    bool available();
+    bool available(uint8_t* aPipe);
+    uint8_t getDynamicPayloadSize();
+    void read(void* aBuffer, uint8_t aLen);
+    bool testRPD();
+    bool testCarrier() {
+      return testRPD();
+    }
+
+    // simulation
+    F3XSimDevice* getDevice() {
+      return myDevice;
+    }
+    bool isListening() {
+      return myListening;
+    }
+    int8_t matchPipe(const uint8_t* aAddress);
+    bool receive(uint8_t aPipe, const uint8_t* aData, uint8_t aLen, uint64_t aArrivalUs, uint32_t aSenderId, uint8_t aPid);
+    uint32_t getId() {
+      return myId;
+    }
+    uint8_t nextPid() {
+      myPid = (myPid + 1) & 0x03;
+      return myPid;
+    }
+    uint8_t getRetryCount() {
+      return myRetryCount;
+    }
+    uint32_t getRetryDelayUs() {
+      return myRetryDelayUs;
+    }
+    bool isAutoAck() {
+      return myAutoAck;
+    }
+    const uint8_t* getWritingAddress() {
+      return myWritingAddress;
+    }
+
+  private:
+    bool transmit(const void* aBuffer, uint8_t aLen, bool aMulticast, uint64_t* aEndUs);
+
+    F3XSimDevice* myDevice;
+    uint32_t myId;
+    uint8_t myChannel;
+    rf24_datarate_e myRate;
+    uint8_t myPaLevel;
+    bool myAutoAck;
+    uint8_t myRetryCount;
+    uint32_t myRetryDelayUs;
+    uint8_t myAddressWidth;
+    uint8_t myReadingAddress[6][5];
+    uint8_t myReadingPipes;          // bit mask of the open reading pipes
+    uint8_t myWritingAddress[5];
+    bool myListening;
+    uint8_t myArc;
+    uint8_t myPid;
+    std::deque<Payload> myRxFifo;
+    uint32_t myLastSender[6];        // duplicate detection (PID and payload) per pipe
+    uint8_t myLastPid[6];
+    uint8_t myLastData[6][32];
+    uint8_t myLastLen[6];
+    bool myTxPending;                // asynchronous transmission, result valid at myTxEndUs
+    bool myTxOk;
+    uint64_t myTxEndUs;
+};
+
+#endif
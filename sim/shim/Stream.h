@@ -0,0 +1,34 @@
+#ifndef Stream_h
+#define Stream_h
+
+#include "Print.h"
+
+/**
+ * byte input of the Arduino core, the reading functions do not wait for data in the simulation
+ */
+class Stream : public Print {
+  public:
+    virtual int available() {
+      return 0;
+    }
+    virtual int read() {
+      return -1;
+    }
+    virtual int peek() {
+      return -1;
+    }
+    void setTimeout(unsigned long aTimeout) {
+      myTimeout = aTimeout;
+    }
+    size_t readBytes(char* aBuffer, size_t aSize);
+    size_t readBytes(uint8_t* aBuffer, size_t aSize) {
+      return readBytes((char*) aBuffer, aSize);
+    }
+    String readString();
+    String readStringUntil(char aTerminator);
+
+  protected:
+    unsigned long myTimeout = 1000;
+};
+
+#endif
@@ -0,0 +1,135 @@
+#include <U8g2lib.h>
+#include "F3XSimDevice.h"
+
+#define F3X_SIM_I2C_OVERHEAD 7  // bytes of a transfer: address, commands (page, columns), data control byte
+
+static const u8g2_cb_t ourRotation0 = {0};
+const u8g2_cb_t* U8G2_R0 = &ourRotation0;
+
+// height, advance
+const uint8_t u8g2_font_helvR12_tr[] = {12, 8};
+const uint8_t u8g2_font_helvR10_tr[] = {10, 7};
+const uint8_t u8g2_font_helvR08_tr[] = {8, 5};
+const uint8_t u8g2_font_5x7_tr[] = {7, 5};
+const uint8_t u8g2_font_4x6_tr[] = {6, 4};
+
+U8G2::U8G2() {
+  memset(myBuffer, 0, sizeof(myBuffer));
+  memset(myPanel, 0, sizeof(myPanel));
+  myBusClock = 100000;
+  myFlipped = 0;
+  myColor = 1;
+  myFontHeight = 8;
+  myFontWidth = 5;
+  myCursorX = 0;
+  myCursorY = 0;
+}
+
+bool U8G2::begin() {
+  clearBuffer();
+  sendBuffer();
+  return true;
+}
+
+void U8G2::setFont(const uint8_t* aFont) {
+  myFontHeight = aFont[0];
+  myFontWidth = aFont[1];
+}
+
+void U8G2::drawPixel(int aX, int aY) {
+  if (aX < 0 || aX >= 128 || aY < 0 || aY >= 64) {
+    return;
+  }
+  uint8_t* b = &myBuffer[(aY / 8) * 128 + aX];
+  uint8_t mask = 1 << (aY % 8);
+  switch (myColor) {
+    case 0:
+      *b &= ~mask;
+      break;
+    case 1:
+      *b |= mask;
+      break;
+    default:
+      *b ^= mask;
+  }
+}
+
+size_t U8G2::write(uint8_t aChar) {
+  // a pattern of the glyph box, which is different for each char
+  for (uint8_t col=0; col+1<myFontWidth; col++) {
+    uint16_t bits = (uint16_t) (aChar * 37 + col * 11) * 0x9e37;
+    for (uint8_t row=0; row<myFontHeight; row++) {
+      if ((bits >> (row % 16)) & 1) {
+        drawPixel(myCursorX + col, myCursorY - myFontHeight + 1 + row);
+      }
+    }
+  }
+  myCursorX += myFontWidth;
+  return 1;
+}
+
+void U8G2::drawStr(int aX, int aY, const char* aStr) {
+  setCursor(aX, aY);
+  print(aStr);
+}
+
+void U8G2::drawBox(int aX, int aY, int aW, int aH) {
+  for (int y=aY; y<aY+aH; y++) {
+    for (int x=aX; x<aX+aW; x++) {
+      drawPixel(x, y);
+    }
+  }
+}
+
+void U8G2::clearBuffer() {
+  memset(myBuffer, 0, sizeof(myBuffer));
+}
+
+void U8G2::transfer(uint16_t aBytes) {
+  F3XSimDevice* device = F3XSimDevice::current();
+  myTransfers.push_back({device->getTimeUs(), aBytes});
+  // 9 clocks per byte incl. the acknowledge bit
+  device->advance((uint64_t) (aBytes + F3X_SIM_I2C_OVERHEAD) * 9 * 1000000 / myBusClock);
+}
+
+void U8G2::sendBuffer() {
+  memcpy(myPanel, myBuffer, sizeof(myBuffer));
+  transfer(sizeof(myBuffer));
+}
+
+void U8G2::updateDisplayArea(uint8_t aTx, uint8_t aTy, uint8_t aTw, uint8_t aTh) {
+  uint16_t bytes = 0;
+  for (uint8_t ty=aTy; ty<aTy+aTh && ty<8; ty++) {
+    for (uint8_t tx=aTx; tx<aTx+aTw && tx<16; tx++) {
+      memcpy(myPanel + ty * 128 + tx * 8, myBuffer + ty * 128 + tx * 8, 8);
+      bytes += 8;
+    }
+  }
+  transfer(bytes);
+}
+
+void U8G2::firstPage() {
+  clearBuffer();
+}
+
+uint8_t U8G2::nextPage() {
+  sendBuffer();
+  return 0;
+}
+
+void U8G2::writeBufferXBM(Print& aOut) {
+  aOut.print("#define xbm_width 128\n#define xbm_height 64\nstatic unsigned char xbm_bits[] = {\n");
+  for (int y=0; y<64; y++) {
+    for (int x=0; x<128; x+=8) {
+      uint8_t v = 0;
+      for (int b=0; b<8; b++) {
+        if (myBuffer[(y / 8) * 128 + x + b] & (1 << (y % 8))) {
+          v |= 1 << b;
+        }
+      }
+      aOut.printf("0x%02x,", v);
+    }
+    aOut.print("\n");
+  }
+  aOut.print("};\n");
+}
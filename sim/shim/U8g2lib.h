@@ -0,0 +1,123 @@
+#ifndef U8g2lib_h
+#define U8g2lib_h
+
+#include <Arduino.h>
+#include <vector>
+
+#define U8X8_PIN_NONE 255
+
+typedef struct {
+  uint8_t rotation;
+} u8g2_cb_t;
+
+extern const u8g2_cb_t* U8G2_R0;
+
+// the fonts of the simulation only define the height and the advance of their glyphs
+extern const uint8_t u8g2_font_helvR12_tr[];
+extern const uint8_t u8g2_font_helvR10_tr[];
+extern const uint8_t u8g2_font_helvR08_tr[];
+extern const uint8_t u8g2_font_5x7_tr[];
+extern const uint8_t u8g2_font_4x6_tr[];
+
+/**
+ * monochrome display of U8g2 with a full frame buffer (128x64, 8x8 pixel tiles). Glyphs are drawn
+ * as a pattern derived from the char, so a changed text changes the buffer like the real fonts.
+ * The transfers to the display copy the buffer into the panel (getPanel()) and block the device
+ * for the time of the I2C transfer at the bus clock, each transfer is recorded.
+ */
+class U8G2 : public Print {
+  public:
+    typedef struct {
+      uint64_t timeUs;     // simulation time of the start
+      uint16_t bytes;
+    } Transfer;
+
+    U8G2();
+
+    bool begin();
+    void setBusClock(uint32_t aHz) {
+      myBusClock = aHz;
+    }
+    void setFlipMode(uint8_t aFlipped) {
+      myFlipped = aFlipped;
+    }
+    int getDisplayWidth() {
+      return 128;
+    }
+    int getDisplayHeight() {
+      return 64;
+    }
+    uint8_t getBufferTileWidth() {
+      return 16;
+    }
+    uint8_t getBufferTileHeight() {
+      return 8;
+    }
+    uint8_t* getBufferPtr() {
+      return myBuffer;
+    }
+
+    void setFont(const uint8_t* aFont);
+    void setFontMode(uint8_t aMode) {}
+    void setDrawColor(uint8_t aColor) {
+      myColor = aColor;
+    }
+    void setCursor(int aX, int aY) {
+      myCursorX = aX;
+      myCursorY = aY;
+    }
+    size_t write(uint8_t aChar) override;
+    using Print::write;
+    void drawStr(int aX, int aY, const char* aStr);
+    void drawBox(int aX, int aY, int aW, int aH);
+    void drawPixel(int aX, int aY);
+
+    void clearBuffer();
+    void sendBuffer();
+    void updateDisplayArea(uint8_t aTx, uint8_t aTy, uint8_t aTw, uint8_t aTh);
+    void updateDisplay() {
+      sendBuffer();
+    }
+    void firstPage();
+    uint8_t nextPage();
+    void writeBufferXBM(Print& aOut);
+
+    // simulation
+    const uint8_t* getPanel() {
+      return myPanel;
+    }
+    const std::vector<Transfer>& getTransfers() {
+      return myTransfers;
+    }
+    void clearTransfers() {
+      myTransfers.clear();
+    }
+
+  private:
+    void transfer(uint16_t aBytes);
+
+    uint8_t myBuffer[1024];
+    uint8_t myPanel[1024];
+    uint32_t myBusClock;
+    uint8_t myFlipped;
+    uint8_t myColor;
+    uint8_t myFontHeight;
+    uint8_t myFontWidth;
+    int myCursorX;
+    int myCursorY;
+    std::vector<Transfer> myTransfers;
+};
+
+class U8G2_SSD1306_128X64_NONAME_F_HW_I2C : public U8G2 {
+  public:
+    U8G2_SSD1306_128X64_NONAME_F_HW_I2C(const u8g2_cb_t* aRotation, uint8_t aReset=U8X8_PIN_NONE,
+      uint8_t aClock=U8X8_PIN_NONE, uint8_t aData=U8X8_PIN_NONE) {}
+};
+
+class U8G2_SSD1306_128X64_NONAME_1_HW_I2C : public U8G2 {
+  public:
+    U8G2_SSD1306_128X64_NONAME_1_HW_I2C(const u8g2_cb_t* aRotation, uint8_t aReset=U8X8_PIN_NONE,
+      uint8_t aClock=U8X8_PIN_NONE, uint8_t aData=U8X8_PIN_NONE) {}
+};
+
+#endif
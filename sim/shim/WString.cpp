@@ -0,0 +1,289 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "WString.h"
+
+static std::string toBase(unsigned long long aValue, unsigned char aBase, bool aNegative) {
+  if (aBase < 2 || aBase > 36) {
+    aBase = 10;
+  }
+  std::string digits;
+  do {
+    uint8_t d = aValue % aBase;
+    digits.insert(digits.begin(), (char) (d < 10 ? '0' + d : 'a' + d - 10));
+    aValue /= aBase;
+  } while (aValue != 0);
+  if (aNegative) {
+    digits.insert(digits.begin(), '-');
+  }
+  return digits;
+}
+
+static std::string toSigned(long long aValue, unsigned char aBase) {
+  if (aBase == 10) {
+    return toBase(aValue < 0 ? -(unsigned long long) aValue : aValue, 10, aValue < 0);
+  }
+  // the cores print negative numbers of other bases as unsigned of the type
+  return toBase((unsigned long) aValue, aBase, false);
+}
+
+static std::string toFixed(double aValue, unsigned char aDecimals) {
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%.*f", aDecimals, aValue);
+  return buf;
+}
+
+String::String(const char* aStr) {
+  if (aStr != nullptr) {
+    myStr = aStr;
+  }
+}
+
+String::String(const __FlashStringHelper* aStr) : String((const char*) aStr) {
+}
+
+String::String(char aChar) : myStr(1, aChar) {
+}
+
+String::String(unsigned char aValue, unsigned char aBase) : myStr(toBase(aValue, aBase, false)) {
+}
+
+String::String(int aValue, unsigned char aBase) : myStr(aBase == 10 ? toSigned(aValue, 10) : toBase((unsigned int) aValue, aBase, false)) {
+}
+
+String::String(unsigned int aValue, unsigned char aBase) : myStr(toBase(aValue, aBase, false)) {
+}
+
+String::String(long aValue, unsigned char aBase) : myStr(toSigned(aValue, aBase)) {
+}
+
+String::String(unsigned long aValue, unsigned char aBase) : myStr(toBase(aValue, aBase, false)) {
+}
+
+String::String(long long aValue, unsigned char aBase) : myStr(toSigned(aValue, aBase)) {
+}
+
+String::String(unsigned long long aValue, unsigned char aBase) : myStr(toBase(aValue, aBase, false)) {
+}
+
+String::String(float aValue, unsigned char aDecimals) : myStr(toFixed(aValue, aDecimals)) {
+}
+
+String::String(double aValue, unsigned char aDecimals) : myStr(toFixed(aValue, aDecimals)) {
+}
+
+String& String::operator=(const char* aStr) {
+  myStr = aStr != nullptr ? aStr : "";
+  return *this;
+}
+
+String& String::operator=(const __FlashStringHelper* aStr) {
+  return *this = (const char*) aStr;
+}
+
+bool String::concat(const String& aStr) {
+  myStr += aStr.myStr;
+  return true;
+}
+
+bool String::concat(const char* aStr) {
+  if (aStr == nullptr) {
+    return false;
+  }
+  myStr += aStr;
+  return true;
+}
+
+bool String::concat(const char* aStr, unsigned int aLen) {
+  if (aStr == nullptr) {
+    return false;
+  }
+  myStr.append(aStr, aLen);
+  return true;
+}
+
+bool String::concat(const __FlashStringHelper* aStr) {
+  return concat((const char*) aStr);
+}
+
+bool String::concat(char aChar) {
+  myStr += aChar;
+  return true;
+}
+
+bool String::concat(unsigned char aValue) {
+  return concat(String(aValue));
+}
+
+bool String::concat(int aValue) {
+  return concat(String(aValue));
+}
+
+bool String::concat(unsigned int aValue) {
+  return concat(String(aValue));
+}
+
+bool String::concat(long aValue) {
+  return concat(String(aValue));
+}
+
+bool String::concat(unsigned long aValue) {
+  return concat(String(aValue));
+}
+
+bool String::concat(long long aValue) {
+  return concat(String(aValue));
+}
+
+bool String::concat(unsigned long long aValue) {
+  return concat(String(aValue));
+}
+
+bool String::concat(float aValue) {
+  return concat(String(aValue));
+}
+
+bool String::concat(double aValue) {
+  return concat(String(aValue));
+}
+
+bool String::equalsIgnoreCase(const String& aStr) const {
+  if (length() != aStr.length()) {
+    return false;
+  }
+  for (unsigned int i=0; i<length(); i++) {
+    if (tolower((unsigned char) myStr[i]) != tolower((unsigned char) aStr.myStr[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool String::startsWith(const String& aPrefix) const {
+  return startsWith(aPrefix, 0);
+}
+
+bool String::startsWith(const String& aPrefix, unsigned int aOffset) const {
+  return aOffset + aPrefix.length() <= length() && myStr.compare(aOffset, aPrefix.length(), aPrefix.myStr) == 0;
+}
+
+bool String::endsWith(const String& aSuffix) const {
+  return aSuffix.length() <= length() && myStr.compare(length() - aSuffix.length(), aSuffix.length(), aSuffix.myStr) == 0;
+}
+
+void String::getBytes(unsigned char* aBuf, unsigned int aSize, unsigned int aIdx) const {
+  if (aSize == 0 || aBuf == nullptr) {
+    return;
+  }
+  unsigned int n = 0;
+  if (aIdx < length()) {
+    n = length() - aIdx;
+    n = n < aSize - 1 ? n : aSize - 1;
+    memcpy(aBuf, myStr.data() + aIdx, n);
+  }
+  aBuf[n] = 0;
+}
+
+int String::indexOf(char aChar, unsigned int aFrom) const {
+  size_t pos = myStr.find(aChar, aFrom);
+  return pos == std::string::npos ? -1 : (int) pos;
+}
+
+int String::indexOf(const String& aStr, unsigned int aFrom) const {
+  size_t pos = myStr.find(aStr.myStr, aFrom);
+  return pos == std::string::npos ? -1 : (int) pos;
+}
+
+int String::lastIndexOf(char aChar) const {
+  size_t pos = myStr.rfind(aChar);
+  return pos == std::string::npos ? -1 : (int) pos;
+}
+
+int String::lastIndexOf(const String& aStr) const {
+  size_t pos = myStr.rfind(aStr.myStr);
+  return pos == std::string::npos ? -1 : (int) pos;
+}
+
+String String::substring(unsigned int aFrom) const {
+  return substring(aFrom, length());
+}
+
+String String::substring(unsigned int aFrom, unsigned int aTo) const {
+  if (aFrom > aTo) {
+    unsigned int tmp = aFrom;
+    aFrom = aTo;
+    aTo = tmp;
+  }
+  if (aFrom >= length()) {
+    return String();
+  }
+  aTo = aTo < length() ? aTo : length();
+  return String(myStr.substr(aFrom, aTo - aFrom));
+}
+
+void String::replace(char aFind, char aReplace) {
+  for (char& c : myStr) {
+    if (c == aFind) {
+      c = aReplace;
+    }
+  }
+}
+
+void String::replace(const String& aFind, const String& aReplace) {
+  if (aFind.length() == 0) {
+    return;
+  }
+  size_t pos = 0;
+  while ((pos = myStr.find(aFind.myStr, pos)) != std::string::npos) {
+    myStr.replace(pos, aFind.length(), aReplace.myStr);
+    pos += aReplace.length();
+  }
+}
+
+void String::remove(unsigned int aIdx) {
+  if (aIdx < length()) {
+    myStr.erase(aIdx);
+  }
+}
+
+void String::remove(unsigned int aIdx, unsigned int aCount) {
+  if (aIdx < length()) {
+    myStr.erase(aIdx, aCount);
+  }
+}
+
+void String::toLowerCase() {
+  for (char& c : myStr) {
+    c = tolower((unsigned char) c);
+  }
+}
+
+void String::toUpperCase() {
+  for (char& c : myStr) {
+    c = toupper((unsigned char) c);
+  }
+}
+
+void String::trim() {
+  size_t start = 0;
+  while (start < myStr.size() && isspace((unsigned char) myStr[start])) {
+    start++;
+  }
+  size_t end = myStr.size();
+  while (end > start && isspace((unsigned char) myStr[end - 1])) {
+    end--;
+  }
+  myStr = myStr.substr(start, end - start);
+}
+
+long String::toInt() const {
+  return atol(c_str());
+}
+
+float String::toFloat() const {
+  return atof(c_str());
+}
+
+double String::toDouble() const {
+  return atof(c_str());
+}
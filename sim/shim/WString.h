@@ -0,0 +1,170 @@
+#ifndef WString_h
+#define WString_h
+
+#include <stdint.h>
+#include <string.h>
+#include <string>
+
+class __FlashStringHelper;
+
+/**
+ * String of the Arduino core, backed by a std::string. Numbers are converted like the ESP8266 and
+ * AVR cores do it (e.g. String(1.5f) is "1.50", a byte is appended as number, a char as char).
+ */
+class String {
+  public:
+    String() {}
+    String(const char* aStr);
+    String(const __FlashStringHelper* aStr);
+    String(const std::string& aStr) : myStr(aStr) {}
+    String(const String& aStr) = default;
+    String(String&& aStr) = default;
+    explicit String(char aChar);
+    explicit String(unsigned char aValue, unsigned char aBase=10);
+    explicit String(int aValue, unsigned char aBase=10);
+    explicit String(unsigned int aValue, unsigned char aBase=10);
+    explicit String(long aValue, unsigned char aBase=10);
+    explicit String(unsigned long aValue, unsigned char aBase=10);
+    explicit String(long long aValue, unsigned char aBase=10);
+    explicit String(unsigned long long aValue, unsigned char aBase=10);
+    explicit String(float aValue, unsigned char aDecimals=2);
+    explicit String(double aValue, unsigned char aDecimals=2);
+
+    String& operator=(const String& aStr) = default;
+    String& operator=(String&& aStr) = default;
+    String& operator=(const char* aStr);
+    String& operator=(const __FlashStringHelper* aStr);
+
+    unsigned int length() const {
+      return myStr.size();
+    }
+    bool isEmpty() const {
+      return myStr.empty();
+    }
+    const char* c_str() const {
+      return myStr.c_str();
+    }
+    bool reserve(unsigned int aSize) {
+      myStr.reserve(aSize);
+      return true;
+    }
+
+    bool concat(const String& aStr);
+    bool concat(const char* aStr);
+    bool concat(const char* aStr, unsigned int aLen);
+    bool concat(const __FlashStringHelper* aStr);
+    bool concat(char aChar);
+    bool concat(unsigned char aValue);
+    bool concat(int aValue);
+    bool concat(unsigned int aValue);
+    bool concat(long aValue);
+    bool concat(unsigned long aValue);
+    bool concat(long long aValue);
+    bool concat(unsigned long long aValue);
+    bool concat(float aValue);
+    bool concat(double aValue);
+
+    template<class T> String& operator+=(T aValue) {
+      concat(aValue);
+      return *this;
+    }
+
+    bool equals(const String& aStr) const {
+      return myStr == aStr.myStr;
+    }
+    bool equalsIgnoreCase(const String& aStr) const;
+    int compareTo(const String& aStr) const {
+      return strcmp(c_str(), aStr.c_str());
+    }
+    bool startsWith(const String& aPrefix) const;
+    bool startsWith(const String& aPrefix, unsigned int aOffset) const;
+    bool endsWith(const String& aSuffix) const;
+
+    char charAt(unsigned int aIdx) const {
+      return aIdx < myStr.size() ? myStr[aIdx] : 0;
+    }
+    void setCharAt(unsigned int aIdx, char aChar) {
+      if (aIdx < myStr.size()) {
+        myStr[aIdx] = aChar;
+      }
+    }
+    char operator[](unsigned int aIdx) const {
+      return charAt(aIdx);
+    }
+    char& operator[](unsigned int aIdx) {
+      return myStr[aIdx];
+    }
+    void getBytes(unsigned char* aBuf, unsigned int aSize, unsigned int aIdx=0) const;
+    void toCharArray(char* aBuf, unsigned int aSize, unsigned int aIdx=0) const {
+      getBytes((unsigned char*) aBuf, aSize, aIdx);
+    }
+
+    int indexOf(char aChar, unsigned int aFrom=0) const;
+    int indexOf(const String& aStr, unsigned int aFrom=0) const;
+    int lastIndexOf(char aChar) const;
+    int lastIndexOf(const String& aStr) const;
+    String substring(unsigned int aFrom) const;
+    String substring(unsigned int aFrom, unsigned int aTo) const;
+
+    void replace(char aFind, char aReplace);
+    void replace(const String& aFind, const String& aReplace);
+    void remove(unsigned int aIdx);
+    void remove(unsigned int aIdx, unsigned int aCount);
+    void toLowerCase();
+    void toUpperCase();
+    void trim();
+
+    long toInt() const;
+    float toFloat() const;
+    double toDouble() const;
+
+    bool operator==(const String& aStr) const {
+      return myStr == aStr.myStr;
+    }
+    bool operator==(const char* aStr) const {
+      return myStr == (aStr != nullptr ? aStr : "");
+    }
+    bool operator==(const __FlashStringHelper* aStr) const {
+      return *this == (const char*) aStr;
+    }
+    template<class T> bool operator!=(T aStr) const {
+      return !(*this == aStr);
+    }
+    bool operator<(const String& aStr) const {
+      return myStr < aStr.myStr;
+    }
+    bool operator>(const String& aStr) const {
+      return myStr > aStr.myStr;
+    }
+
+  private:
+    std::string myStr;
+};
+
+inline bool operator==(const char* aLeft, const String& aRight) {
+  return aRight == aLeft;
+}
+
+inline bool operator!=(const char* aLeft, const String& aRight) {
+  return !(aRight == aLeft);
+}
+
+template<class T> String operator+(const String& aLeft, T aRight) {
+  String result(aLeft);
+  result.concat(aRight);
+  return result;
+}
+
+inline String operator+(const char* aLeft, const String& aRight) {
+  String result(aLeft);
+  result.concat(aRight);
+  return result;
+}
+
+inline String operator+(const __FlashStringHelper* aLeft, const String& aRight) {
+  String result(aLeft);
+  result.concat(aRight);
+  return result;
+}
+
+#endif
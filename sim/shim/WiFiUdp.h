@@ -0,0 +1,6 @@
+#ifndef WiFiUdp_h
+#define WiFiUdp_h
+
+#include <ESP8266WiFi.h>
+
+#endif
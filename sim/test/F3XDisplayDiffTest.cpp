@@ -0,0 +1,94 @@
+#include "F3XSimTest.h"
+
+/**
+ * the bytes sent per frame by F3XDisplayDiff to the fake U8G2 of the simulation: a first or
+ * invalidated frame is sent completely, an unchanged one not at all, a change only with its
+ * tiles. After each frame the panel shows the frame buffer.
+ */
+typedef struct {
+  uint32_t bytes;       // sum of the bytes returned by sendRow()
+  uint32_t transfers;   // calls of updateDisplayArea()
+  uint32_t transferred; // bytes of the transfers
+} Frame;
+
+static uint32_t ourTotalBytes = 0;
+
+static Frame sendFrame(U8G2& aDisplay, base::F3XDisplayDiff& aDiff) {
+  Frame frame = {0, 0, 0};
+  aDisplay.clearTransfers();
+  aDiff.requestFrame(&aDisplay);
+  while (aDiff.isPending()) {
+    frame.bytes += aDiff.sendRow(&aDisplay);
+  }
+  for (const U8G2::Transfer& transfer : aDisplay.getTransfers()) {
+    frame.transfers++;
+    frame.transferred += transfer.bytes;
+  }
+  F3X_CHECK_EQ(frame.bytes, frame.transferred);
+  ourTotalBytes += frame.bytes;
+  F3X_CHECK(memcmp(aDisplay.getPanel(), aDisplay.getBufferPtr(), 1024) == 0);
+  return frame;
+}
+
+int main() {
+  U8G2_SSD1306_128X64_NONAME_F_HW_I2C display(U8G2_R0);
+  display.begin();
+  base::F3XDisplayDiff diff;
+
+  // the content of the display is unknown, each row is sent completely
+  display.clearBuffer();
+  display.setFont(u8g2_font_helvR12_tr);
+  display.drawStr(0, 20, "F3B Speed");
+  Frame frame = sendFrame(display, diff);
+  F3X_CHECK_EQ(1024u, frame.bytes);
+  F3X_CHECK_EQ(8u, frame.transfers);
+
+  // nothing changed
+  frame = sendFrame(display, diff);
+  F3X_CHECK_EQ(0u, frame.bytes);
+  F3X_CHECK_EQ(0u, frame.transfers);
+
+  // one tile
+  display.drawPixel(20, 30);
+  frame = sendFrame(display, diff);
+  F3X_CHECK_EQ(8u, frame.bytes);
+  F3X_CHECK_EQ(1u, frame.transfers);
+
+  // tiles 2 and 4 of a row are sent together with the unchanged tile between them
+  display.drawPixel(2*8, 40);
+  display.drawPixel(4*8, 40);
+  frame = sendFrame(display, diff);
+  F3X_CHECK_EQ(24u, frame.bytes);
+  F3X_CHECK_EQ(1u, frame.transfers);
+
+  // tiles 2 and 5 are two transfers
+  display.drawPixel(2*8+1, 40);
+  display.drawPixel(5*8+1, 40);
+  frame = sendFrame(display, diff);
+  F3X_CHECK_EQ(16u, frame.bytes);
+  F3X_CHECK_EQ(2u, frame.transfers);
+
+  // a running time: only the tiles of the last digit of two rows
+  display.clearBuffer();
+  display.drawStr(0, 20, "F3B Speed");
+  display.drawStr(0, 45, "00:12.3");
+  sendFrame(display, diff);
+  display.clearBuffer();
+  display.drawStr(0, 20, "F3B Speed");
+  display.drawStr(0, 45, "00:12.4");
+  frame = sendFrame(display, diff);
+  printf("running time: %u bytes in %u transfers\n", frame.bytes, frame.transfers);
+  F3X_CHECK(frame.bytes > 0);
+  F3X_CHECK(frame.bytes <= 2 * 2*8);
+
+  // e.g. after sendBuffer() of a boot message
+  diff.invalidate();
+  frame = sendFrame(display, diff);
+  F3X_CHECK_EQ(1024u, frame.bytes);
+
+  F3X_CHECK_EQ(8u, diff.getFrameCount());
+  F3X_CHECK_EQ(1024u, diff.getLastBytes());
+  F3X_CHECK_EQ(ourTotalBytes / 8, diff.getAvgBytes());
+
+  return F3X_TEST_RESULT();
+}
@@ -0,0 +1,91 @@
+#include "F3XSimTest.h"
+
+/**
+ * a F3B speed run flown on the simulated competition setup: the task is started with the button
+ * of the A-Line (main menu -> "F3B Speedtask" -> "Start Task"), the A-Line is signalled at the
+ * BaseManager, the B-Line at the LineController over the radio. The course time, the buzzers,
+ * the web API, the run log and the CSV protocol are checked.
+ * A second run of the task with the same number of legs is a reset of the delta protocol of
+ * /api/task, the client gets the complete state.
+ */
+#define LEG_US 5000000  // 150m with 30m/s
+
+static void flyRun(F3XSimCompetition& aSim, uint64_t aStartUs, uint32_t aLegUs) {
+  for (uint8_t leg=0; leg<=4; leg++) {
+    if (leg%2 == 0) {
+      aSim.getBase().press(SIM_PIN_SIGNAL_A, aStartUs + leg*aLegUs, SIM_BUTTON_US);
+    } else {
+      aSim.getLineB().press(SIM_PIN_SIGNAL_B, aStartUs + leg*aLegUs, SIM_BUTTON_US);
+    }
+  }
+}
+
+static uint16_t countPulses(F3XSimDevice& aDevice, uint8_t aPin) {
+  uint16_t count = 0;
+  for (const F3XSimDevice::Edge& edge : aDevice.getEdges(aPin)) {
+    count += edge.level == HIGH;
+  }
+  return count;
+}
+
+int main() {
+  F3XSimCompetition sim;
+  sim.start();
+  F3X_CHECK(sim.getBase().getLoopCount() > 0);
+  F3X_CHECK(sim.getLineB().getLoopCount() > 0);
+
+  sim.startF3BSpeedTask();
+  base::F3XFixedDistanceTask* task = base::ourCourses[0].getActiveTask();
+  F3X_CHECK_EQ(base::F3XFixedDistanceTask::F3BSpeedType, task->getType());
+  F3X_CHECK_EQ(base::F3XFixedDistanceTask::TaskRunning, task->getTaskState());
+  sim.getBase().clearEdges();
+  sim.getBuzzer().clearEdges();
+
+  // A - B - A - B - A
+  uint64_t t = sim.getRunner().getTimeUs() + 1000000;
+  flyRun(sim, t, LEG_US);
+  F3X_CHECK(sim.getRunner().runUntil([&]{ return task->getTaskState() == base::F3XFixedDistanceTask::TaskFinished; },
+    t + 5*LEG_US));
+  F3X_CHECK_EQ(4, task->getSignalledLegCount());
+  // the crossings are taken from the time stamps of the presses, not of the loop handling them
+  long courseTime = task->getCourseTime();
+  printf("course time: %ldms\n", courseTime);
+  F3X_CHECK(labs(courseTime - 4*LEG_US/1000) <= 5);
+
+  F3XSimHttpResponsePtr response = sim.get("/api/task?v=0");
+  F3X_CHECK_EQ(200, response->getStatus());
+  F3X_CHECK(response->getBody().find("\"signalled\":4") != std::string::npos);
+  std::string version = std::to_string(base::ourCourses[0].getStateTracker()->getVersion());
+
+  // each crossing is buzzed by the RemoteBuzzer, the buzzer of the BaseManager is off by default
+  sim.getRunner().runFor(3000000);
+  F3X_CHECK_EQ(5, countPulses(sim.getBuzzer(), SIM_PIN_REMOTE_BUZZER));
+  F3X_CHECK_EQ(0, countPulses(sim.getBase(), SIM_PIN_BUZZER));
+
+  // the run is written to the run log and is part of the CSV protocol
+  response = sim.get("/setDataReq?name=stop_task");
+  F3X_CHECK_EQ(200, response->getStatus());
+  sim.getRunner().runFor(2000000);
+  F3X_CHECK(sim.getBase().getFiles().count("/F3BSpeedData.bin") == 1);
+  response = sim.get("/F3BSpeedData.csv");
+  F3X_CHECK_EQ(200, response->getStatus());
+  std::string csv = response->getBody();
+  printf("%s", csv.c_str());
+  char courseTimeText[16];
+  snprintf(courseTimeText, sizeof(courseTimeText), ";%02ld:%02ld.%02ld;", courseTime/60000, courseTime/1000%60, courseTime%1000/10);
+  F3X_CHECK(csv.find(courseTimeText) != std::string::npos);
+
+  // a second run, the client of the first one gets the complete state with the new leg times
+  response = sim.get("/setDataReq?name=start_task");
+  F3X_CHECK_EQ(200, response->getStatus());
+  t = sim.getRunner().getTimeUs() + 1000000;
+  flyRun(sim, t, LEG_US + 500000);
+  F3X_CHECK(sim.getRunner().runUntil([&]{ return task->getTaskState() == base::F3XFixedDistanceTask::TaskFinished; },
+    t + 5*(LEG_US + 500000)));
+  response = sim.get("/api/task?v=" + version);
+  F3X_CHECK_EQ(200, response->getStatus());
+  F3X_CHECK(response->getBody().find("\"full\":1") != std::string::npos);
+  F3X_CHECK(response->getBody().find("\"signalled\":4") != std::string::npos);
+
+  return F3X_TEST_RESULT();
+}
@@ -0,0 +1,53 @@
+#include "F3XSimTest.h"
+
+/**
+ * the web log keeps the last LOGBUFFSIZE messages of its level, also when more messages are
+ * printed to Serial in the meantime than the ring of Serial takes. The Serial output gets all
+ * messages in their order. The "%s" arguments of logEvent() are printed from their own pointer.
+ */
+static const char ourTestFormat[] PROGMEM = "task %s: %d";
+static const char* const ourTestFormats[] PROGMEM = { ourTestFormat };
+
+int main() {
+  F3XSimDevice device("BaseManager");
+  F3XSimDevice::Scope scope(&device);
+  base::Logger& logger = base::Logger::getInstance();
+  logger.setup("test");
+  logger.setLogLevel(LOG_MOD_SIG, base::DEBUG);
+  logger.setWebLogLevel(base::WARNING);
+
+  for (uint8_t i=0; i<LOGBUFFSIZE+2; i++) {
+    logger.log(LOG_MOD_SIG, base::WARNING, String("web ") + String(i));
+  }
+  // a burst of debug messages, only for Serial
+  for (uint8_t i=0; i<3*LOG_RING_SIZE; i++) {
+    logger.log(LOG_MOD_SIG, base::DEBUG, String("serial ") + String(i));
+  }
+
+  // newest first, the two oldest ones are replaced
+  for (uint8_t i=0; i<LOGBUFFSIZE; i++) {
+    String msg = logger.getInternalMsg(i);
+    std::string expected = "web " + std::to_string(LOGBUFFSIZE+1 - i);
+    F3X_CHECK(std::string(msg.c_str()).find(expected) != std::string::npos);
+  }
+  F3X_CHECK_EQ(0u, logger.getInternalMsg(LOGBUFFSIZE).length());
+
+  logger.setFormats(ourTestFormats, 1);
+  logger.event(LOG_MOD_SIG, base::DEBUG, 0, "F3BSpeed", -42);
+
+  while (logger.flush() > 0) {
+  }
+  std::string& serial = device.getSerial();
+  size_t pos = 0;
+  for (uint8_t i=0; i<LOGBUFFSIZE+2; i++) {
+    pos = serial.find("web " + std::to_string(i) + "\r\n", pos);
+    F3X_CHECK(pos != std::string::npos);
+  }
+  for (uint8_t i=0; i<3*LOG_RING_SIZE; i++) {
+    pos = serial.find("serial " + std::to_string(i) + "\r\n", pos);
+    F3X_CHECK(pos != std::string::npos);
+  }
+  F3X_CHECK(serial.find("task F3BSpeed: -42\r\n", pos) != std::string::npos);
+
+  return F3X_TEST_RESULT();
+}
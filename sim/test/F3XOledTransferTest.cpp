@@ -0,0 +1,56 @@
+#include "F3XSimTest.h"
+
+/**
+ * the OLED of the BaseManager is updated by updateOLEDTransfer() with at most one tile row
+ * (128 bytes) per loop, while a F3B speed run is flown: the I2C transfer blocks the loop, the
+ * signals are handled between two rows.
+ */
+#define LEG_US       5000000
+#define SIM_ROW_BYTES    128  // one tile row of the 128x64 display
+
+int main() {
+  F3XSimCompetition sim;
+  sim.start();
+  sim.startF3BSpeedTask();
+  base::F3XFixedDistanceTask* task = base::ourCourses[0].getActiveTask();
+  F3X_CHECK_EQ(base::F3XFixedDistanceTask::TaskRunning, task->getTaskState());
+
+  uint64_t t = sim.getRunner().getTimeUs() + 1000000;
+  for (uint8_t leg=0; leg<=4; leg++) {
+    if (leg%2 == 0) {
+      sim.getBase().press(SIM_PIN_SIGNAL_A, t + leg*LEG_US, SIM_BUTTON_US);
+    } else {
+      sim.getLineB().press(SIM_PIN_SIGNAL_B, t + leg*LEG_US, SIM_BUTTON_US);
+    }
+  }
+
+  // the transfers of each loop of the BaseManager
+  base::ourOLED.clearTransfers();
+  uint32_t frames = base::ourDisplayDiff.getFrameCount();
+  uint32_t loops = sim.getBase().getLoopCount();
+  size_t next = 0;
+  uint32_t maxLoopBytes = 0;
+  uint32_t sendingLoops = 0;
+  sim.getRunner().runUntil([&]{
+    if (sim.getBase().getLoopCount() != loops) {
+      loops = sim.getBase().getLoopCount();
+      const std::vector<U8G2::Transfer>& transfers = base::ourOLED.getTransfers();
+      uint32_t bytes = 0;
+      for (; next < transfers.size(); next++) {
+        bytes += transfers[next].bytes;
+      }
+      maxLoopBytes = bytes > maxLoopBytes ? bytes : maxLoopBytes;
+      sendingLoops += bytes > 0;
+    }
+    return false;
+  }, t + 5*LEG_US + 1000000);
+
+  frames = base::ourDisplayDiff.getFrameCount() - frames;
+  printf("%u frames, %u loops with transfers, max %u bytes per loop\n", frames, sendingLoops, maxLoopBytes);
+  F3X_CHECK_EQ(base::F3XFixedDistanceTask::TaskFinished, task->getTaskState());
+  F3X_CHECK(frames > 0);
+  F3X_CHECK(sendingLoops > 0);
+  F3X_CHECK(maxLoopBytes <= SIM_ROW_BYTES);
+
+  return F3X_TEST_RESULT();
+}
@@ -0,0 +1,39 @@
+#include <string.h>
+#include "F3XSimTest.h"
+
+/**
+ * an OTA update restarts the BaseManager without returning to the loop, the CmdRestartMC frames
+ * to the LineControllers of both courses and the RemoteBuzzer have to be sent before
+ */
+int main() {
+  F3XSimCompetition sim;
+  F3XSimDevice lineB2("LineController2", linectl2::setup, linectl2::loop);
+  linectl2::resetFunc = []{ F3XSimDevice::current()->restart(); };
+  sim.getRunner().add(&lineB2);
+  sim.setWlan("F3XSim");
+  uint16_t restartFrames = 0;
+  F3XSimAir::getInstance().setObserver([&](const F3XSimAir::Transmission& aTx) {
+    if (strcmp(aTx.sender, "BaseManager") == 0 && aTx.ok && aTx.len >= 2 && aTx.data[0] == F3X_RC_FRAME_MAGIC
+        && aTx.data[1] == (uint8_t) base::F3XRemoteCommandType::CmdRestartMC
+        && sim.getBase().getRestartCount() == 0) {
+      restartFrames++;
+    }
+  });
+  sim.start();
+  F3X_CHECK(sim.getBase().getNetwork().isConnected());
+
+  {
+    F3XSimDevice::Scope scope(&sim.getBase());
+    ArduinoOTA.simulateUpdate(300000);
+  }
+  F3X_CHECK(sim.getRunner().runUntil([&]{ return sim.getBase().getRestartCount() > 0; },
+    sim.getRunner().getTimeUs() + 20000000));
+  F3X_CHECK_EQ(3, restartFrames);
+
+  // the line controllers and the remote buzzer restart 500ms after the command
+  sim.getRunner().runFor(1000000);
+  F3X_CHECK_EQ(1, sim.getLineB().getRestartCount());
+  F3X_CHECK_EQ(1, lineB2.getRestartCount());
+  F3X_CHECK_EQ(1, sim.getBuzzer().getRestartCount());
+  return F3X_TEST_RESULT();
+}
@@ -0,0 +1,95 @@
+#include "F3XSimTest.h"
+
+/**
+ * the runs refer to their pilot by the index in the roster: a new roster gets the next generation,
+ * the runs of the old roster are not scored for the pilots of the new one, neither after the
+ * POST of the roster nor after the run logs are read again at boot.
+ * A reflight in a previous round replaces the time of the pilot in that round, the round is
+ * not counted twice.
+ */
+static void flyRun(F3XSimCompetition& aSim, uint32_t aLegUs) {
+  uint64_t t = aSim.getRunner().getTimeUs() + 500000;
+  for (uint8_t leg=0; leg<=4; leg++) {
+    if (leg%2 == 0) {
+      aSim.getBase().press(SIM_PIN_SIGNAL_A, t + leg*aLegUs, SIM_BUTTON_US);
+    } else {
+      aSim.getLineB().press(SIM_PIN_SIGNAL_B, t + leg*aLegUs, SIM_BUTTON_US);
+    }
+  }
+  base::F3XFixedDistanceTask* task = base::ourCourses[0].getActiveTask();
+  F3X_CHECK(aSim.getRunner().runUntil([&]{ return task->getTaskState() == base::F3XFixedDistanceTask::TaskFinished; },
+    t + 5*aLegUs));
+  // the finished task is idle, the run is written to the run log
+  aSim.getRunner().runFor(2000000);
+}
+
+static base::F3XRoundScores* getScores() {
+  return base::ourCourses[0].getScores(base::F3XFixedDistanceTask::F3BSpeedType);
+}
+
+int main() {
+  F3XSimCompetition sim;
+  sim.start();
+
+  F3XSimHttpResponsePtr response = sim.request("POST", "/api/pilots", "Anna;1\nBert;1\n");
+  F3X_CHECK_EQ(200, response->getStatus());
+  F3X_CHECK_EQ(1, base::ourPilotRoster.getGeneration());
+  sim.startF3BSpeedTask();
+  flyRun(sim, 4000000);
+  F3X_CHECK(labs((long) getScores()->getBestTime(0) - 16000) <= 5);
+
+  // the run of Anna is not scored for Carl, the first pilot of the new roster
+  response = sim.request("POST", "/api/pilots", "Carl;1\nDora;1\n");
+  F3X_CHECK_EQ(200, response->getStatus());
+  F3X_CHECK_EQ(2, base::ourPilotRoster.getGeneration());
+  F3X_CHECK_EQ(0u, getScores()->getBestTime(0));
+  F3X_CHECK_EQ(0, getScores()->getRoundCount());
+  response = sim.get("/api/results?task=f3b");
+  F3X_CHECK(response->getBody().find("[\"Carl\",1,0,0.00,0.00,0]") != std::string::npos);
+
+  // a press resets the finished task, the next one starts it again
+  sim.startF3BSpeedTask();
+  flyRun(sim, 5000000);
+  F3X_CHECK(labs((long) getScores()->getBestTime(0) - 20000) <= 5);
+
+  // both runs are logged with the generation of their roster
+  const std::string& log = sim.getBase().getFiles()["/F3BSpeedData.bin"];
+  F3X_CHECK_EQ(2 * sizeof(base::F3XRunRecord), log.size());
+  if (log.size() == 2 * sizeof(base::F3XRunRecord)) {
+    const base::F3XRunRecord* records = (const base::F3XRunRecord*) log.data();
+    F3X_CHECK_EQ(1, records[0].roster);
+    F3X_CHECK_EQ(2, records[1].roster);
+  }
+
+  // round 1: Dora 25s, round 2: Carl 22s, then a reflight of Dora in round 1 with 18s
+  sim.startF3BSpeedTask();
+  flyRun(sim, 6250000);
+  sim.startF3BSpeedTask();
+  flyRun(sim, 5500000);
+  F3X_CHECK_EQ(2, getScores()->getRoundCount());
+  sim.get("/setDataReq?name=schedule_previous");
+  sim.get("/setDataReq?name=schedule_previous");
+  F3X_CHECK_EQ(1, base::ourPilotRoster.getRound());
+  F3X_CHECK_EQ(1, base::ourPilotRoster.getCurrentPilot());
+  sim.startF3BSpeedTask();
+  flyRun(sim, 4500000);
+  // round 1: Carl 1000 * 18 / 20, Dora 1000, round 2: Carl 1000
+  F3X_CHECK_EQ(2, getScores()->getRoundCount());
+  F3X_CHECK(fabs(getScores()->getTotalScore(0) - 1900.0f) < 1.0f);
+  F3X_CHECK(fabs(getScores()->getTotalScore(1) - 1000.0f) < 1.0f);
+
+  // boot: the generation is read with the schedule, only the runs of Carl and Dora are scored
+  {
+    F3XSimDevice::Scope scope(&sim.getBase());
+    base::ourPilotRoster = base::F3XPilotRoster();
+    base::ourPilotRoster.load();
+    base::readRunAggregates();
+  }
+  F3X_CHECK_EQ(2, base::ourPilotRoster.getGeneration());
+  F3X_CHECK_EQ(2, getScores()->getRoundCount());
+  F3X_CHECK(labs((long) getScores()->getBestTime(0) - 20000) <= 5);
+  F3X_CHECK(fabs(getScores()->getTotalScore(0) - 1900.0f) < 1.0f);
+  F3X_CHECK(fabs(getScores()->getTotalScore(1) - 1000.0f) < 1.0f);
+
+  return F3X_TEST_RESULT();
+}
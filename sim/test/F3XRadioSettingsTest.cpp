@@ -0,0 +1,42 @@
+#include "F3XSimTest.h"
+
+/**
+ * a changed radio channel is switched on all remote devices, including the LineController of the
+ * second course, before the BaseManager switches. The devices stay on the new channel after their
+ * fallback delay, the B-Line of both courses reaches the BaseManager.
+ */
+#define SIM_CHANNEL 90
+
+int main() {
+  F3XSimCompetition sim;
+  F3XSimDevice lineB2("LineController2", linectl2::setup, linectl2::loop);
+  linectl2::resetFunc = []{ F3XSimDevice::current()->restart(); };
+  sim.getRunner().add(&lineB2);
+
+  // the SignalB of each LineController: channel and acknowledgement
+  std::map<std::string, F3XSimAir::Transmission> signals;
+  F3XSimAir::getInstance().setObserver([&](const F3XSimAir::Transmission& aTx) {
+    if (aTx.len >= 2 && aTx.data[0] == F3X_RC_FRAME_MAGIC && aTx.data[1] == (uint8_t) base::F3XRemoteCommandType::SignalB) {
+      signals[aTx.sender] = aTx;
+    }
+  });
+  sim.start();
+
+  F3X_CHECK_EQ(200, sim.get("/setDataReq?name=radio_channel&value=" + std::to_string(SIM_CHANNEL))->getStatus());
+  // the switch and the fallback delays of the devices
+  sim.getRunner().runFor(30000000);
+
+  uint64_t t = sim.getRunner().getTimeUs() + 100000;
+  sim.getLineB().press(SIM_PIN_SIGNAL_B, t, SIM_BUTTON_US);
+  lineB2.press(SIM_PIN_SIGNAL_B, t + 500000, SIM_BUTTON_US);
+  sim.getRunner().runFor(2000000);
+
+  F3X_CHECK_EQ(1u, signals.count("LineController"));
+  F3X_CHECK_EQ(1u, signals.count("LineController2"));
+  for (auto& signal : signals) {
+    printf("%s: channel %d, ok %d\n", signal.first.c_str(), signal.second.channel, signal.second.ok);
+    F3X_CHECK_EQ(SIM_CHANNEL, signal.second.channel);
+    F3X_CHECK(signal.second.ok);
+  }
+  return F3X_TEST_RESULT();
+}
@@ -0,0 +1,199 @@
+#include "F3XSimTest.h"
+
+/**
+ * recorded signal event streams replayed through the capture path of the A-Line: F3XEventRing,
+ * getCapturedTimestamp(), F3XFixedDistanceTask::signal(Signal, uint32_t) and signalAt(). The
+ * course times have to follow the time of the events, not the time the loop handled them.
+ */
+
+typedef struct {
+  base::F3XFixedDistanceTask::Signal signal;
+  uint64_t eventUs;     // edge at the line input
+  uint64_t handledUs;   // the loop took the event from the ring
+} ReplayEvent;
+
+// a F3B speed run, recorded with a loop latency of up to 45ms (OLED transfer, web request)
+static const ReplayEvent ourRecordedRun[] = {
+  { base::F3XFixedDistanceTask::SignalA, 1000000,  1012400 },
+  { base::F3XFixedDistanceTask::SignalB, 5871300,  5916300 },
+  { base::F3XFixedDistanceTask::SignalA, 10735900, 10736100 },
+  { base::F3XFixedDistanceTask::SignalB, 15620450, 15651000 },
+  { base::F3XFixedDistanceTask::SignalA, 20511870, 20540010 },
+};
+#define RECORDED_RUN_SIZE (sizeof(ourRecordedRun) / sizeof(ourRecordedRun[0]))
+
+// edges of a bouncing contact at the A-Line input (us relative to the first edge, level)
+static const struct {
+  uint32_t offsetUs;
+  uint8_t level;
+} ourBouncingPress[] = {
+  {0, LOW}, {350, HIGH}, {720, LOW}, {1480, HIGH}, {2110, LOW},               // pressed
+  {200000, HIGH}, {200400, LOW}, {200950, HIGH}, {201600, LOW}, {202300, HIGH}, // released
+};
+
+static uint16_t ourSignalACnt = 0;
+static uint16_t ourSignalBCnt = 0;
+
+/**
+ * the ring keeps the order of a stream across the wrap around and drops events, if it is full
+ */
+void testEventRing() {
+  base::F3XEventRing<8> ring;
+  uint32_t stamp;
+  for (uint32_t i=0; i<7; i++) {
+    F3X_CHECK(ring.push(1000 + i));
+  }
+  F3X_CHECK(!ring.push(2000));
+  F3X_CHECK_EQ(1, ring.getOverflowCount());
+  for (uint32_t i=0; i<7; i++) {
+    F3X_CHECK(ring.pop(&stamp));
+    F3X_CHECK_EQ(1000 + i, stamp);
+  }
+  F3X_CHECK(!ring.pop(&stamp));
+
+  // a stream with bursts of three events, consumed after each burst
+  ring.clear();
+  uint32_t next = 0;
+  for (uint32_t burst=0; burst<50; burst++) {
+    for (uint8_t i=0; i<3; i++) {
+      F3X_CHECK(ring.push(burst*3 + i));
+    }
+    while (ring.pop(&stamp)) {
+      F3X_CHECK_EQ(next, stamp);
+      next++;
+    }
+  }
+  F3X_CHECK_EQ(150, next);
+  F3X_CHECK_EQ(0, ring.getOverflowCount());
+}
+
+/**
+ * the newest captured time stamp is used, stale ones are dropped, without one the current time
+ */
+void testCapturedTimestamp() {
+  F3XSimDevice device("replay");
+  F3XSimDevice::Scope scope(&device);
+  device.advanceTo(10000000);
+  uint32_t now = micros();
+  base::F3XEventRing<SIGNAL_RING_SIZE> ring;
+
+  F3X_CHECK_EQ(now, base::getCapturedTimestamp(&ring));
+
+  ring.push(now - SIGNAL_MAX_AGE_US - 1000);
+  ring.push(now - 30000);
+  ring.push(now - 20000);
+  F3X_CHECK_EQ(now - 20000, base::getCapturedTimestamp(&ring));
+  F3X_CHECK(!ring.available());
+
+  ring.push(now - SIGNAL_MAX_AGE_US - 1000);
+  ring.push(now - 30000);
+  ring.push(now - 20000);
+  F3X_CHECK_EQ(now - 30000, base::getCapturedTimestamp(&ring, true));
+  F3X_CHECK(!ring.available());
+
+  ring.push(now - SIGNAL_MAX_AGE_US - 1000);
+  F3X_CHECK_EQ(now, base::getCapturedTimestamp(&ring));
+}
+
+/**
+ * replay the recorded run into a task, the events are stamped by the ISR and signalled late by
+ * the loop. aClockOffsetUs moves micros(), so it wraps during the run.
+ */
+void replayRun(int64_t aClockOffsetUs) {
+  F3XSimDevice device("replay");
+  F3XSimDevice::Scope scope(&device);
+  device.setClockOffset(aClockOffsetUs);
+  base::F3XFixedDistanceTask task(base::F3XFixedDistanceTask::F3BSpeedType);
+  task.addSignalAListener([]{ ourSignalACnt++; });
+  task.addSignalBListener([]{ ourSignalBCnt++; });
+  ourSignalACnt = 0;
+  ourSignalBCnt = 0;
+  device.advanceTo(500000);
+  task.start();
+
+  base::F3XEventRing<SIGNAL_RING_SIZE> ring;
+  for (uint8_t i=0; i<RECORDED_RUN_SIZE; i++) {
+    device.advanceTo(ourRecordedRun[i].eventUs);
+    ring.push(micros());
+    device.advanceTo(ourRecordedRun[i].handledUs);
+    task.signal(ourRecordedRun[i].signal, base::getCapturedTimestamp(&ring));
+  }
+  F3X_CHECK_EQ(base::F3XFixedDistanceTask::TaskFinished, task.getTaskState());
+  F3X_CHECK_EQ(3, ourSignalACnt);
+  F3X_CHECK_EQ(2, ourSignalBCnt);
+  for (uint8_t i=1; i<RECORDED_RUN_SIZE; i++) {
+    long expected = (ourRecordedRun[i].eventUs - ourRecordedRun[0].eventUs) / 1000;
+    // the ms time base of the task rounds each time stamp by up to 1ms
+    F3X_CHECK(labs((long) task.getCourseTime(i) - expected) <= 1);
+  }
+}
+
+/**
+ * a signal with a time before the last crossing (e.g. a B-Line time stamp converted from the
+ * clock of the LineController) must not make the leg time negative
+ */
+void testSignalAtOrder() {
+  F3XSimDevice device("replay");
+  F3XSimDevice::Scope scope(&device);
+  base::F3XFixedDistanceTask task(base::F3XFixedDistanceTask::F3BSpeedType);
+  task.addSignalAListener([]{});
+  task.addSignalBListener([]{});
+  device.advanceTo(1000000);
+  task.start();
+  device.advanceTo(2000000);
+  task.signalAt(base::F3XFixedDistanceTask::SignalA, 1990);
+  task.signalAt(base::F3XFixedDistanceTask::SignalB, 1985);
+  F3X_CHECK_EQ(1, task.getSignalledLegCount());
+  F3X_CHECK_EQ(0, task.getCourseTime(1));
+  task.signalAt(base::F3XFixedDistanceTask::SignalA, 6990);
+  F3X_CHECK_EQ(5000, task.getCourseTime(2));
+}
+
+/**
+ * the bouncing presses of the A-Line replayed into the BaseManager with a slow loop: the ISR
+ * takes the first edge of each press, the loop latency is not part of the course time
+ */
+void testBouncingALine() {
+  F3XSimCompetition sim;
+  sim.start();
+  sim.startF3BSpeedTask();
+  base::F3XFixedDistanceTask* task = base::ourCourses[0].getActiveTask();
+  F3X_CHECK_EQ(base::F3XFixedDistanceTask::TaskRunning, task->getTaskState());
+  sim.getBase().setLoopCost(25000);
+
+  uint64_t t = sim.getRunner().getTimeUs() + 1000000;
+  for (uint8_t i=0; i<RECORDED_RUN_SIZE; i++) {
+    uint64_t eventUs = t + ourRecordedRun[i].eventUs;
+    if (ourRecordedRun[i].signal == base::F3XFixedDistanceTask::SignalA) {
+      for (const auto& edge : ourBouncingPress) {
+        sim.getBase().scheduleInput(eventUs + edge.offsetUs, SIM_PIN_SIGNAL_A, edge.level);
+      }
+    } else {
+      sim.getLineB().press(SIM_PIN_SIGNAL_B, eventUs, SIM_BUTTON_US);
+    }
+  }
+  F3X_CHECK(sim.getRunner().runUntil([&]{ return task->getTaskState() == base::F3XFixedDistanceTask::TaskFinished; },
+    t + ourRecordedRun[RECORDED_RUN_SIZE-1].eventUs + 1000000));
+  long expected = (ourRecordedRun[RECORDED_RUN_SIZE-1].eventUs - ourRecordedRun[0].eventUs) / 1000;
+  printf("course time: %ldms, expected: %ldms\n", (long) task->getCourseTime(), expected);
+  F3X_CHECK(labs((long) task->getCourseTime() - expected) <= 1);
+  expected = (ourRecordedRun[2].eventUs - ourRecordedRun[0].eventUs) / 1000;
+  F3X_CHECK(labs((long) task->getCourseTime(2) - expected) <= 1);
+
+  // the edges of the release bounce are captured too, but no press takes them from the ring,
+  // they must not keep the signal pending and the web server blocked
+  sim.getRunner().runFor(1000000);
+  F3XSimHttpResponsePtr response = sim.get("/api/perf");
+  F3X_CHECK(response->complete);
+  F3X_CHECK_EQ(200, response->getStatus());
+}
+
+int main() {
+  testEventRing();
+  testCapturedTimestamp();
+  replayRun(0);
+  replayRun(0x100000000LL - 8000000);  // micros() wraps between the first B and the second A signal
+  testSignalAtOrder();
+  testBouncingALine();
+  return F3X_TEST_RESULT();
+}
@@ -0,0 +1,120 @@
+#ifndef F3XSimTest_h
+#define F3XSimTest_h
+
+#include <stdio.h>
+#include <string>
+#include "BaseManagerFirmware.h"
+#include "F3XSimAir.h"
+#include "F3XSimFirmware.h"
+#include "F3XSimNetwork.h"
+#include "F3XSimRunner.h"
+
+/**
+ * minimal checks of the simulation tests, a failed check is reported and the test returns 1
+ */
+static int ourSimFailures = 0;
+
+#define F3X_CHECK(aCond) do { \
+    if (!(aCond)) { \
+      printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #aCond); \
+      ourSimFailures++; \
+    } \
+  } while (0)
+
+#define F3X_CHECK_EQ(aExpected, aActual) do { \
+    long long expected = (long long) (aExpected); \
+    long long actual = (long long) (aActual); \
+    if (expected != actual) { \
+      printf("%s:%d: check failed: %s == %s (%lld != %lld)\n", __FILE__, __LINE__, #aExpected, #aActual, expected, actual); \
+      ourSimFailures++; \
+    } \
+  } while (0)
+
+#define F3X_TEST_RESULT() (printf(ourSimFailures == 0 ? "passed\n" : "%d checks failed\n", ourSimFailures), ourSimFailures == 0 ? 0 : 1)
+
+#define SIM_PIN_SIGNAL_A  D4   // BaseManager: A-Line button, active low
+#define SIM_PIN_BUZZER    D8   // BaseManager: buzzer
+#define SIM_PIN_SIGNAL_B   2   // LineController: B-Line button, active low
+#define SIM_PIN_REMOTE_BUZZER 8 // RemoteBuzzer: buzzer
+#define SIM_BUTTON_US  80000   // duration of a button press
+
+/**
+ * the competition setup of the simulation tests: the BaseManager, the LineController of the B-Line
+ * and a RemoteBuzzer on the simulated air, all devices are started by the runner
+ */
+class F3XSimCompetition {
+  public:
+    F3XSimCompetition() :
+        myBase("BaseManager", base::setup, base::loop),
+        myLineB("LineController", linectl::setup, linectl::loop),
+        myBuzzer("RemoteBuzzer", buzzer::setup, buzzer::loop) {
+      F3XSimAir::getInstance().reset();
+      linectl::resetFunc = []{ F3XSimDevice::current()->restart(); };
+      buzzer::resetFunc = []{ F3XSimDevice::current()->restart(); };
+      myRunner.add(&myBase);
+      myRunner.add(&myLineB);
+      myRunner.add(&myBuzzer);
+    }
+
+    /**
+     * configure the WLAN of the BaseManager, must be called before start()
+     */
+    void setWlan(const char* aSsid) {
+      F3XSimDevice::Scope scope(&myBase);
+      base::setDefaultConfig();
+      strncpy(base::ourConfig.wlanSsid, aSsid, sizeof(base::ourConfig.wlanSsid) - 1);
+      base::saveConfig();
+    }
+
+    /**
+     * run the setup() of all devices and the startup phase of the BaseManager
+     */
+    void start() {
+      myRunner.runFor(15000000);
+    }
+
+    /**
+     * start the F3B speed task with the button of the A-Line like the operator: main menu ->
+     * "0:F3B Speedtask" -> "0:Start Task"
+     */
+    void startF3BSpeedTask() {
+      uint64_t t = myRunner.getTimeUs();
+      myBase.press(SIM_PIN_SIGNAL_A, t + 100000, SIM_BUTTON_US);
+      myBase.press(SIM_PIN_SIGNAL_A, t + 1000000, SIM_BUTTON_US);
+      myRunner.runUntil(t + 2000000);
+    }
+
+    /**
+     * a web request to the BaseManager, returns the response after it is complete
+     */
+    F3XSimHttpResponsePtr request(const char* aMethod, const std::string& aUri, const std::string& aBody="") {
+      F3XSimHttpResponsePtr response = myBase.getNetwork().request(aMethod, aUri, aBody);
+      myRunner.runUntil([&]{ return response->complete; }, myRunner.getTimeUs() + 2000000);
+      return response;
+    }
+
+    F3XSimHttpResponsePtr get(const std::string& aUri) {
+      return request("GET", aUri);
+    }
+
+    F3XSimDevice& getBase() {
+      return myBase;
+    }
+    F3XSimDevice& getLineB() {
+      return myLineB;
+    }
+    F3XSimDevice& getBuzzer() {
+      return myBuzzer;
+    }
+    F3XSimRunner& getRunner() {
+      return myRunner;
+    }
+
+  private:
+    F3XSimDevice myBase;
+    F3XSimDevice myLineB;
+    F3XSimDevice myBuzzer;
+    F3XSimRunner myRunner;
+};
+
+#endif
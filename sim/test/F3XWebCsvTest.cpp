@@ -0,0 +1,58 @@
+#include "F3XSimTest.h"
+
+/**
+ * the CSV protocol of a long run log is created page by page by the file streamer: the web server
+ * slice of a loop stays short, while the whole protocol is transferred over the network, and each
+ * run is in the protocol once.
+ */
+#define SIM_RUNS          300
+#define SIM_SLICE_MAX_US 10000  // the budget of the web server slice plus one page
+
+static void writeRunLog(F3XSimDevice& aDevice, uint16_t aRuns) {
+  std::string log;
+  for (uint16_t i=0; i<aRuns; i++) {
+    base::F3XRunRecord record;
+    memset(&record, 0, sizeof(record));
+    record.magic = F3X_RUN_RECORD_MAGIC;
+    record.runNo = i+1;
+    record.type = base::F3XFixedDistanceTask::F3BSpeedType;
+    record.legNumber = 4;
+    record.legLength = 150;
+    for (uint8_t leg=0; leg<4; leg++) {
+      record.courseTime[leg] = (leg+1) * 4000 + i;
+    }
+    record.pilot = F3X_PILOT_NONE;
+    record.crc = base::F3XRemoteCommand::crc8((const uint8_t*) &record, sizeof(record)-1);
+    log.append((const char*) &record, sizeof(record));
+  }
+  aDevice.getFiles()["/F3BSpeedData.bin"] = log;
+}
+
+int main() {
+  F3XSimCompetition sim;
+  writeRunLog(sim.getBase(), SIM_RUNS);
+  sim.getBase().setFileCostNs(50);
+  sim.start();
+
+  base::ourWebSliceLat.reset();
+  F3XSimHttpResponsePtr response = sim.get("/F3BSpeedData.csv");
+  F3X_CHECK_EQ(200, response->getStatus());
+  F3X_CHECK(response->complete);
+  F3X_CHECK(response->getHeader("Transfer-Encoding") == "chunked");
+  std::string csv = response->getBody();
+  uint32_t lines = 0;
+  for (char c : csv) {
+    lines += c == '\n';
+  }
+  // column names and units
+  F3X_CHECK_EQ(2 + SIM_RUNS, lines);
+  F3X_CHECK(response->wire.size() >= 5 && response->wire.compare(response->wire.size() - 5, 5, "0\r\n\r\n") == 0);
+
+  uint32_t sliceMax = base::ourWebSliceLat.getMax();
+  printf("%zu bytes in %.1fms, %u writes, web slice max %.1fms\n", csv.size(),
+    (response->completeUs - response->handledUs) / 1000.0, response->writes, sliceMax / 1000.0);
+  F3X_CHECK(response->writes > 1);
+  F3X_CHECK(sliceMax < SIM_SLICE_MAX_US);
+
+  return F3X_TEST_RESULT();
+}
@@ -0,0 +1,77 @@
+#!/usr/bin/env python3
+"""
+Converts a sketch (.ino) into a C++ source like the Arduino builder does it: the prototypes of
+all functions defined in the sketch are inserted before the first function definition, so a
+function can be called before it is defined. Default arguments are moved from the definition
+into the prototype. #line directives keep the line numbers of the sketch in the messages of the
+compiler.
+
+usage: ino2cpp.py <sketch.ino> <output.cpp>
+"""
+
+import re
+import sys
+
+FUNCTION = re.compile(r'^([A-Za-z_][\w:<>\*\& ]*?[\s\*&]+)([A-Za-z_]\w*)\s*\((.*)\)\s*\{\s*(//.*)?$')
+KEYWORDS = ('if', 'for', 'while', 'switch', 'else', 'return', 'class', 'struct', 'typedef', 'enum', 'namespace')
+DEFAULT_ARG = re.compile(r'\s*=\s*(\'[^\']*\'|"[^"]*"|[^,)]+)')
+
+
+def strip_code(aLine):
+    """the line without comments and literals, to count the braces"""
+    code = re.sub(r'//.*', '', aLine)
+    code = re.sub(r'"([^"\\]|\\.)*"', '""', code)
+    return re.sub(r"'([^'\\]|\\.)*'", "''", code)
+
+
+def convert(aPath):
+    lines = open(aPath, encoding='utf-8').read().split('\n')
+    out = list(lines)
+    prototypes = []
+    first = None
+    depth = 0
+    inComment = False
+    for i, line in enumerate(lines):
+        if depth == 0 and not inComment:
+            m = FUNCTION.match(line)
+            if m and not line.startswith(KEYWORDS) and '::' not in m.group(2):
+                ret, name, args = m.group(1).strip(), m.group(2), m.group(3)
+                prototypes.append('%s %s(%s);' % (ret, name, args))
+                out[i] = DEFAULT_ARG.sub('', line.split('{')[0]) + '{'
+                if first is None:
+                    first = i
+        code = strip_code(line)
+        # block comments may contain braces
+        while True:
+            if inComment:
+                end = code.find('*/')
+                if end < 0:
+                    code = ''
+                    break
+                code = code[end + 2:]
+                inComment = False
+            start = code.find('/*')
+            if start < 0:
+                break
+            depth += code[:start].count('{') - code[:start].count('}')
+            code = code[start + 2:]
+            inComment = True
+        depth += code.count('{') - code.count('}')
+
+    result = ['#line 1 "%s"' % aPath]
+    if first is None:
+        result += out
+    else:
+        result += out[:first]
+        result += prototypes
+        result.append('#line %d "%s"' % (first + 1, aPath))
+        result += out[first:]
+    return '\n'.join(result) + '\n'
+
+
+if __name__ == '__main__':
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    source = convert(sys.argv[1])
+    with open(sys.argv[2], 'w', encoding='utf-8') as f:
+        f.write(source)